@@ -0,0 +1,185 @@
+/* C++11 */
+
+/**
+ * @file   adaptivity.cc
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ */
+
+#include "adaptivity.h"
+
+#include <vector>
+
+AdaptivePoisson1D::AdaptivePoisson1D(const ParamList & params, const VectorXr & mesh, const GetPot & config,
+                                     const Index & maxIterationsNo, const Real & tolerance)
+    : params_(params), mesh_(mesh), maxIterationsNo_(maxIterationsNo), tolerance_(tolerance),
+      errorTolerance_(config("Mesh/AMR/tolerance", 1.0e-7)), maxCyclesNo_(config("Mesh/AMR/maxCyclesNo", 5)),
+      maxNodesNo_(config("Mesh/AMR/maxNodesNo", 2000)), PhiBcorr_(0.0), qTot_(0.0), cTot_(0.0)
+{
+    assert( mesh_.size() >= 3 );
+    
+    if ( errorTolerance_ <= 0.0 || maxCyclesNo_ < 1 || maxNodesNo_ < mesh_.size() )
+    {
+        throw std::runtime_error("ERROR: wrong variables in section \"Mesh/AMR\" set in the configuration file.");
+    }
+    
+    bimSolver_ = Bim1DCache::get(mesh_, params_);
+}
+
+void AdaptivePoisson1D::apply(const VectorXr & init_guess, const Charge & charge_fun)
+{
+    assert( init_guess.size() == mesh_.size() );
+    
+    VectorXr guess = init_guess;
+    
+    std::vector<Real> norm;
+    
+    for ( Index cycle = 0; cycle < maxCyclesNo_; ++cycle )
+    {
+        NonLinearPoisson1D nlpSolver(params_, *bimSolver_, maxIterationsNo_, tolerance_);
+        
+        nlpSolver.apply(guess, charge_fun);
+        
+        phi_      = nlpSolver.phi();
+        PhiBcorr_ = nlpSolver.PhiBcorr();
+        qTot_     = nlpSolver.qTot();
+        cTot_     = nlpSolver.cTot();
+        
+        norm.insert(norm.end(), nlpSolver.norm().data(), nlpSolver.norm().data() + nlpSolver.norm().size());
+        
+        VectorXr meshOld = mesh_;
+        
+        if ( cycle == maxCyclesNo_ - 1 || !adapt(charge_fun) )
+        {
+            break;
+        }
+        
+        // Transfer the solution to the new mesh and solve again.
+        guess = numerics::interp1(meshOld, phi_, mesh_);
+        phi_  = guess;
+        
+        bimSolver_ = Bim1DCache::get(mesh_, params_);
+    }
+    
+    norm_ = Eigen::Map<VectorXr>(norm.data(), norm.size());
+    
+    return;
+}
+
+VectorXr AdaptivePoisson1D::transfer(const VectorXr & mesh, const VectorXr & u) const
+{
+    assert( mesh.size() == u.size() );
+    
+    if ( mesh.size() == mesh_.size() && mesh == mesh_ )
+    {
+        return u;
+    }
+    
+    return numerics::interp1(mesh, u, mesh_);
+}
+
+bool AdaptivePoisson1D::adapt(const Charge & charge_fun)
+{
+    const Index nNodes = mesh_.size();
+    
+    // Second derivative of the potential at each node.
+    VectorXr d2phi = charge_fun.charge(phi_.array() + PhiBcorr_) / params_.eps_semic();
+    
+    for ( Index i = 0; i < nNodes; ++i )
+    {
+        if ( mesh_(i) > 0.0 )    // No charge in the insulator.
+        {
+            d2phi(i) = 0.0;
+        }
+    }
+    
+    // Error indicators.
+    VectorXr eta = VectorXr::Zero( nNodes - 1 );
+    
+    for ( Index e = 0; e < eta.size(); ++e )
+    {
+        Real h = mesh_(e + 1) - mesh_(e);
+        
+        eta(e) = h * h / 8.0 * std::abs( d2phi(e + 1) - d2phi(e) );
+    }
+    
+    // Refine the elements with the largest indicators, within the maximum number of nodes.
+    std::vector<bool> refine(eta.size(), false);
+    
+    {
+        Index nRefine = 0;
+        
+        for ( Index e = 0; e < eta.size(); ++e )
+        {
+            if ( eta(e) > errorTolerance_ )
+            {
+                ++nRefine;
+            }
+        }
+        
+        Real threshold = errorTolerance_;
+        
+        if ( nNodes + nRefine > maxNodesNo_ )
+        {
+            VectorXr sorted = numerics::sort(eta);
+            Index nAllowed = std::max( maxNodesNo_ - nNodes, (Index) 0 );
+            
+            threshold = ( nAllowed == 0 ) ? std::numeric_limits<Real>::infinity() : sorted( sorted.size() - nAllowed - 1 );
+            threshold = std::max( threshold, errorTolerance_ );
+        }
+        
+        for ( Index e = 0; e < eta.size(); ++e )
+        {
+            refine[e] = ( eta(e) > threshold );
+        }
+    }
+    
+    // Build the new mesh.
+    std::vector<Real> mesh;
+    mesh.reserve( 2 * nNodes );
+    
+    bool changed = false;
+    
+    mesh.push_back( mesh_(0) );
+    
+    for ( Index i = 1; i < nNodes; ++i )
+    {
+        const Index e = i - 1;    // Element between nodes i - 1 and i.
+        
+        if ( refine[e] )
+        {
+            mesh.push_back( 0.5 * (mesh_(i - 1) + mesh_(i)) );
+            changed = true;
+        }
+        
+        // Remove node i if it is not a boundary or the interface, its elements are not refined,
+        // the previous node has been kept and the merged element would be accurate enough.
+        if ( i < nNodes - 1 && mesh_(i) != 0.0 && !refine[e] && !refine[e + 1] && mesh.back() == mesh_(i - 1) )
+        {
+            Real h = mesh_(i + 1) - mesh_(i - 1);
+            
+            Real etaMerged = h * h / 8.0 * std::abs( d2phi(i + 1) - d2phi(i - 1) );
+            
+            if ( etaMerged < 0.25 * errorTolerance_ )
+            {
+                changed = true;
+                continue;
+            }
+        }
+        
+        mesh.push_back( mesh_(i) );
+    }
+    
+    if ( changed )
+    {
+        mesh_ = Eigen::Map<VectorXr>(mesh.data(), mesh.size());
+    }
+    
+    return changed;
+}
@@ -0,0 +1,158 @@
+/* C++11 */
+
+/**
+ * @file   adaptivity.h
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ * @brief Adaptive mesh refinement for the non-linear Poisson equation.
+ *
+ */
+
+#ifndef ADAPTIVITY_H
+#define ADAPTIVITY_H
+
+#include "charge.h"
+#include "numerics.h"
+#include "paramList.h"
+#include "solvers.h"
+#include "typedefs.h"
+
+#include <memory>    // std::shared_ptr
+
+/**
+ * @class AdaptivePoisson1D
+ *
+ * Since @f$ -\left(\epsilon \varphi'\right)' = \rho @f$, the local error on an element
+ * @f$ e = \left[x_i, x_{i+1}\right] @f$ of size @f$ h_e @f$ is estimated by the variation of the
+ * second derivative of the potential across it:
+ * @f[ \eta_e = \frac{h_e^2}{8} \frac{\left|\rho(x_{i+1}) - \rho(x_i)\right|}{\epsilon} ~ , @f]
+ * which vanishes in the insulator and in neutral regions, and is large in accumulation layers.
+ * After each solution, elements with @f$ \eta_e @f$ greater than the tolerance are bisected, while
+ * a node is removed if the element obtained by merging its two elements would have
+ * @f$ \eta_e @f$ lower than a quarter of the tolerance. The boundary nodes and the
+ * semiconductor/insulator interface are never removed. The solution is transferred to the new mesh by
+ * linear interpolation and the equation is solved again, until the mesh does not change.
+ *
+ * The mesh is kept from a call to the next one, so that the bias continuation proceeds on the mesh
+ * adapted to the previous step.
+ *
+ * @brief Class providing an adaptive mesh loop around @ref NonLinearPoisson1D.
+ *
+ */
+class AdaptivePoisson1D
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the parameters).
+         */
+        AdaptivePoisson1D() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] params          : a parameter list;
+         * @param[in] mesh            : the initial mesh;
+         * @param[in] config          : the GetPot configuration object (section @a Mesh/AMR);
+         * @param[in] maxIterationsNo : maximum number of Newton iterations;
+         * @param[in] tolerance       : tolerance of the Newton method.
+         */
+        AdaptivePoisson1D(const ParamList &, const VectorXr &, const GetPot &, const Index &, const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~AdaptivePoisson1D() = default;
+        
+        /**
+         * @brief Solve the equation, adapting the mesh.
+         * @param[in] init_guess : initial guess for the Newton algorithm, on the current mesh;
+         * @param[in] charge_fun : an object of class @ref Charge specifying how to compute total electric charge.
+         */
+        void apply(const VectorXr &, const Charge &);
+        
+        /**
+         * @brief Transfer a function to the current mesh.
+         * @param[in] mesh : the mesh the function is defined on;
+         * @param[in] u    : the values of the function at the nodes of @a mesh.
+         * @returns the values of the function at the nodes of the current mesh.
+         */
+        VectorXr transfer(const VectorXr &, const VectorXr &) const;
+        
+        /**
+         * @name Getter methods
+         * @{
+         */
+        inline const VectorXr & mesh()     const;
+        inline const VectorXr & phi()      const;
+        inline const VectorXr & norm()     const;
+        inline const Real     & PhiBcorr() const;
+        inline const Real     & qTot()     const;
+        inline const Real     & cTot()     const;
+        
+        /**
+         * @}
+         */
+        
+    private:
+        /**
+         * @brief Adapt the current mesh to the last solution.
+         * @param[in] charge_fun : an object of class @ref Charge specifying how to compute total electric charge.
+         * @returns true if the mesh has changed.
+         */
+        bool adapt(const Charge &);
+        
+        const ParamList & params_;    /**< @brief The parameter list. */
+        
+        VectorXr mesh_;    /**< @brief The current mesh. */
+        
+        std::shared_ptr<const Bim1D> bimSolver_;    /**< @brief Solver assembled on the current mesh. */
+        
+        Index maxIterationsNo_;    /**< @brief Maximum number of Newton iterations. */
+        Real  tolerance_      ;    /**< @brief Tolerance of the Newton method. */
+        
+        Real  errorTolerance_;    /**< @brief Tolerance on the error indicator @f$ [V] @f$. */
+        Index maxCyclesNo_   ;    /**< @brief Maximum number of adaptation cycles for each solution. */
+        Index maxNodesNo_    ;    /**< @brief Maximum number of nodes. */
+        
+        VectorXr phi_     ;    /**< @brief The electric potential on the current mesh. */
+        VectorXr norm_    ;    /**< @brief @f$ L^\infty @f$-norm errors of the Newton iterations of all the cycles. */
+        Real     PhiBcorr_;    /**< @brief Barrier correction. */
+        Real     qTot_    ;    /**< @brief Total charge. */
+        Real     cTot_    ;    /**< @brief Total capacitance. */
+};
+
+// Implementations.
+inline const VectorXr & AdaptivePoisson1D::mesh() const
+{
+    return mesh_;
+}
+
+inline const VectorXr & AdaptivePoisson1D::phi() const
+{
+    return phi_;
+}
+
+inline const VectorXr & AdaptivePoisson1D::norm() const
+{
+    return norm_;
+}
+
+inline const Real & AdaptivePoisson1D::PhiBcorr() const
+{
+    return PhiBcorr_;
+}
+
+inline const Real & AdaptivePoisson1D::qTot() const
+{
+    return qTot_;
+}
+
+inline const Real & AdaptivePoisson1D::cTot() const
+{
+    return cTot_;
+}
+
+#endif /* ADAPTIVITY_H */
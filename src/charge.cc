@@ -16,6 +16,36 @@
 
 using namespace constants;
 
+namespace
+{
+    // Bound on the exponents for which exp(a - b) is evaluated as exp(a) * exp(-b):
+    // both factors and their product stay far from overflow and from subnormal numbers.
+    const Real FACTORIZATION_BOUND = 300.0;
+    
+    // Bound on the exponents in single precision: the products of two factors are normal numbers,
+    // since subnormal ones slow down the arithmetic by orders of magnitude.
+    const Real SINGLE_FACTORIZATION_BOUND = 80.0;
+    
+    // Scaling of the weights in single precision, the ones lower than its reciprocal (relative to N0) being dropped.
+    const Real SINGLE_WEIGHT_SCALE = 1.0e20;
+    
+    // Number of potentials integrated together by the node-major quadrature of GaussianCharge.
+    const Index BLOCK_SIZE = 16;
+    
+    // Number of potentials, among a block, whose quadrature sums are accumulated together (a divisor of BLOCK_SIZE).
+    const Index GROUP_SIZE = 4;
+    
+    typedef Array<Real, GROUP_SIZE, 1> GroupArray;
+    
+    // Width (in terms of q * phi / (k_B * T)) and degree of the Chebyshev panels of GaussFermiCharge.
+    const Real  PANEL_WIDTH      = 1.0;
+    const Index CHEBYSHEV_DEGREE = 14;
+    
+    // Bound on the ratio between the sum of the absolute values of the terms of the integrated-by-parts quadrature
+    // of the derivative and the derivative itself, above which the positive terms are summed instead.
+    const Real CANCELLATION_BOUND = 1.0e6;
+}
+
 /*// Hole parameters.
 namespace
 {
@@ -26,178 +56,784 @@ namespace
 
 Charge::Charge (const ParamList & params, const QuadratureRule & rule)
     : params_ (params), rule_ (rule) {}
+    
+VectorXr
+Charge::dcharge_jacobian (const VectorXr & phi) const
+{
+    return dcharge (phi);
+}
 
-GaussianCharge::GaussianCharge (const ParamList & params,
-                                const QuadratureRule & rule)
-    : Charge (params, rule) {}
+void
+Charge::evaluate (const VectorXr & phi, VectorXr & charge, VectorXr & dcharge) const
+{
+    charge  = this->charge (phi);
+    dcharge = dcharge_jacobian (phi);
+}
 
-Real
-GaussianCharge::n_approx (const Real & phi, const Real & N0,
-                          const Real & sigma) const
+void
+Charge::evaluate_batch (const std::vector<const Charge *> & charges, const MatrixXr & phi,
+                        MatrixXr & charge, MatrixXr & dcharge)
 {
-    Real n = 0.0;
+    assert (phi.rows() == (Index) charges.size());
+    
+    if (charge.rows() != phi.rows() || charge.cols() != phi.cols())
+        charge.resize (phi.rows(), phi.cols());
+        
+    if (dcharge.rows() != phi.rows() || dcharge.cols() != phi.cols())
+        dcharge.resize (phi.rows(), phi.cols());
+        
+    const Index nBlocks = (phi.cols() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    
+    // The potentials of an instance are a row, i.e. strided by the number of instances.
+    const Index stride = phi.rows();
     
-    #pragma omp parallel for default(shared) reduction(+: n)
+    #pragma omp parallel for schedule(dynamic) default(shared)
     
-    for (Index i = 0; i < rule_.nNodes_; ++i)
+    for (Index t = 0; t < phi.rows() * nBlocks; ++t)
     {
-        n += rule_.weights_ (i) * N0 / SQRT_PI * 1 /
-             (1.0 + std::exp ((SQRT_2 * sigma * rule_.nodes_ (i) - Q * phi) /
-                              (K_B * params_.T_)));
-                              
-        /*n -= rule_.weights_ (i) * P0 / SQRT_PI * (1 - 1 /
-                (1.0 + std::exp ((SQRT_2 * sigmap * rule_.nodes_ (i) - Q * (phi + Egap)) /
-                                 (K_B * params_.T_))));*/
+        const Index i     = t / nBlocks;
+        const Index first = (t % nBlocks) * BLOCK_SIZE;
+        
+        if (charges[i] == nullptr)
+            continue;
+            
+        charges[i]->evaluate_block (phi.data() + i + first * stride, std::min (BLOCK_SIZE, phi.cols() - first), stride,
+                                    charge.data() + i + first * stride, dcharge.data() + i + first * stride);
     }
+}
+
+void
+Charge::evaluate_block (const Real * phi, const Index & size, const Index & stride, Real * charge, Real * dcharge) const
+{
+    VectorXr phiBlock = Map<const VectorXr, 0, InnerStride<> > (phi, size, InnerStride<> (stride));
+    VectorXr chargeBlock, dchargeBlock;
+    
+    evaluate (phiBlock, chargeBlock, dchargeBlock);
     
-    return n;
+    Map<VectorXr, 0, InnerStride<> > (charge,  size, InnerStride<> (stride)) = chargeBlock;
+    Map<VectorXr, 0, InnerStride<> > (dcharge, size, InnerStride<> (stride)) = dchargeBlock;
 }
 
-Real
-GaussianCharge::dn_approx (const Real & phi, const Real & N0,
-                           const Real & sigma) const
+GaussianCharge::GaussianCharge (const ParamList & params,
+                                const QuadratureRule & rule,
+                                const Real & tolerance,
+                                const bool & mixedPrecision)
+    : Charge (params, rule), singleBound_ (0.0), scale_ (Q / (K_B * params.T_))
 {
-    Real dn = 0.0;
+    assert (tolerance >= 0.0);
+    
+    const std::vector<Gaussian> gaussians = params_.gaussians();
+    
+    const Index nNodes = rule_.nNodes_;
+    
+    exponents_ = ArrayXr::Zero (gaussians.size() * nNodes);
+    nWeights_  = ArrayXr::Zero (exponents_.size());
+    dnWeights_ = ArrayXr::Zero (exponents_.size());
     
-    #pragma omp parallel for default(shared) reduction(+: dn)
+    // Offset and N0 of the gaussian each node belongs to.
+    ArrayXr offsets       = ArrayXr::Zero (exponents_.size());
+    ArrayXr normalization = ArrayXr::Ones (exponents_.size());
     
-    for (Index i = 0; i < rule_.nNodes_; ++i)
+    // Logarithm of the tolerance, halved since the error bound of the derivative is twice as large.
+    const Real logTolerance = std::log (0.5 * tolerance);
+    
+    for (std::size_t k = 0; k < gaussians.size(); ++k)
     {
-        dn += - Q * rule_.weights_ (i) * N0 * SQRT_2 /
-              (sigma * SQRT_PI) * rule_.nodes_ (i) * 1 /
-              (1.0 + std::exp ((SQRT_2 * sigma * rule_.nodes_
-                                (i) - Q * phi) / (K_B * params_.T_)));
-                                
-        /*dn -= - Q * rule_.weights_ (i) * P0 * SQRT_2 /
-              (sigmap * SQRT_PI) * rule_.nodes_ (i) * (1 - 1 /
-                      (1.0 + std::exp ((SQRT_2 * sigmap * rule_.nodes_
-                                        (i) - Q * (phi + Egap)) / (K_B * params_.T_))));*/
+        const Gaussian & g = gaussians[k];
+        
+        exponents_.segment (k * nNodes, nNodes) =
+            (SQRT_2 * g.sigma * rule_.nodes_.array() - Q * g.shift) /
+            (K_B * params_.T_);
+            
+        nWeights_.segment (k * nNodes, nNodes) =
+            rule_.weights_.array() * g.N0 / SQRT_PI;
+            
+        dnWeights_.segment (k * nNodes, nNodes) =
+            - Q * rule_.weights_.array() * g.N0 * SQRT_2 /
+            (g.sigma * SQRT_PI) * rule_.nodes_.array();
+            
+        const Real s2 = std::pow (g.sigma / (K_B * params_.T_), 2);
+        
+        Component c;
+        
+        c.first    = k * nNodes;
+        c.N0       = g.N0;
+        c.offset   = scale_ * g.shift;
+        c.variance = 0.5 * s2;
+        
+        // Ratio between the error bound and the closed form lower than the tolerance.
+        c.boltzmann    =   logTolerance - 1.5 * s2;
+        c.nSaturation  = - 0.5 * logTolerance + s2;
+        c.dnSaturation = - logTolerance + 1.5 * s2;
+        
+        components_.push_back (c);
+        
+        offsets      .segment (k * nNodes, nNodes).setConstant (c.offset);
+        normalization.segment (k * nNodes, nNodes).setConstant (c.N0);
     }
     
-    return dn;
+    if (exponents_.abs().maxCoeff() < FACTORIZATION_BOUND)
+        factors_ = exponents_.exp();
+        
+    if (mixedPrecision)
+    {
+        const Real bound = (exponents_ + offsets).abs().maxCoeff();
+        
+        if (bound < SINGLE_FACTORIZATION_BOUND)
+        {
+            singleBound_ = SINGLE_FACTORIZATION_BOUND - bound;
+            
+            factorsSingle_  = (exponents_ + offsets).exp().cast<float>();
+            nWeightsSingle_ = (SINGLE_WEIGHT_SCALE * nWeights_ / normalization).cast<float>();
+            
+            for (Index j = 0; j < nWeightsSingle_.size(); ++j)
+                if (nWeightsSingle_ (j) < 1.0f)
+                    nWeightsSingle_ (j) = 0.0f;
+        }
+    }
 }
 
 VectorXr
 GaussianCharge::charge (const VectorXr & phi) const
+{
+    VectorXr charge (phi.size());
+    
+    kernel (phi, &charge, nullptr);
+    
+    return charge;
+}
+
+VectorXr
+GaussianCharge::dcharge (const VectorXr & phi) const
+{
+    VectorXr dcharge (phi.size());
+    
+    kernel (phi, nullptr, &dcharge);
+    
+    return dcharge;
+}
+
+VectorXr
+GaussianCharge::dcharge_jacobian (const VectorXr & phi) const
+{
+    if (factorsSingle_.size() == 0)
+        return dcharge (phi);
+        
+    VectorXr dcharge = VectorXr::Zero (phi.size());
+    
+    const Index nNodes = rule_.nNodes_;
+    
+    #pragma omp parallel default(shared)
+    {
+        ArrayXf r (nNodes);    // Reciprocals 1 / (1 + t_j), reused for all the potentials.
+        
+        #pragma omp for
+        
+        for (Index i = 0; i < phi.size(); ++i)
+        {
+            Real dn = 0.0;
+            
+            const Real sphi = scale_ * phi (i);
+            
+            const bool factorized = (factors_.size() > 0 && std::abs (sphi) < FACTORIZATION_BOUND);
+            const Real y = factorized ? std::exp (- sphi) : 0.0;
+            
+            for (const Component & c : components_)
+            {
+                const Real u = sphi + c.offset;
+                
+                if (u < c.boltzmann)
+                    dn += scale_ * c.N0 * std::exp (u + c.variance);
+                else if (u > c.dnSaturation)
+                    dn += scale_ * c.N0 * std::exp (- u + c.variance);
+                else if (std::abs (u) < singleBound_)
+                {
+                    // Derivative of the quadrature of the density, as w_j * (t_j * r_j) * r_j: all the terms
+                    // are positive, whereas the weights of the derivative would cancel out in single precision.
+                    const float z = static_cast<float> (std::exp (- u));
+                    
+                    r = (1.0f + z * factorsSingle_.segment (c.first, nNodes)).inverse();
+                    
+                    dn += scale_ * c.N0 / SINGLE_WEIGHT_SCALE *
+                          (nWeightsSingle_.segment (c.first, nNodes) *
+                           (z * factorsSingle_.segment (c.first, nNodes) * r) * r).sum();
+                }
+                else if (factorized)
+                    dn += (dnWeights_.segment (c.first, nNodes) /
+                           (1.0 + y * factors_.segment (c.first, nNodes))).sum();
+                else
+                    dn += (dnWeights_.segment (c.first, nNodes) /
+                           (1.0 + (exponents_.segment (c.first, nNodes) - sphi).exp())).sum();
+            }
+            
+            dcharge (i) = - Q * dn;
+            
+            if (dcharge (i) > - std::exp (-20.0))
+                dcharge (i) = - std::exp (-20.0);
+        }
+    }
+    
+    return dcharge;
+}
+
+void
+GaussianCharge::evaluate (const VectorXr & phi, VectorXr & charge, VectorXr & dcharge) const
+{
+    if (factorsSingle_.size() > 0)
+    {
+        Charge::evaluate (phi, charge, dcharge);
+        return;
+    }
+    
+    charge .resize (phi.size());
+    dcharge.resize (phi.size());
+    
+    kernel (phi, &charge, &dcharge);
+}
+
+void
+GaussianCharge::evaluate_block (const Real * phi, const Index & size, const Index & stride, Real * charge, Real * dcharge) const
+{
+    if (factorsSingle_.size() > 0)
+    {
+        Charge::evaluate_block (phi, size, stride, charge, dcharge);
+        return;
+    }
+    
+    block (phi, size, stride, charge, dcharge);
+}
+
+void
+GaussianCharge::kernel (const VectorXr & phi, VectorXr * charge, VectorXr * dcharge) const
+{
+    const Index nBlocks = (phi.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    
+    #pragma omp parallel for default(shared)
+    
+    for (Index b = 0; b < nBlocks; ++b)
+    {
+        const Index first = b * BLOCK_SIZE;
+        
+        block (phi.data() + first, std::min (BLOCK_SIZE, phi.size() - first), 1,
+               charge  != nullptr ? charge ->data() + first : nullptr,
+               dcharge != nullptr ? dcharge->data() + first : nullptr);
+    }
+}
+
+void
+GaussianCharge::block (const Real * phi, const Index & size, const Index & stride, Real * charge, Real * dcharge) const
+{
+    assert (size <= BLOCK_SIZE);
+    
+    const Index nNodes = rule_.nNodes_;
+    
+    const bool factorized = (factors_.size() > 0);
+    
+    Real n [BLOCK_SIZE] = {};
+    Real dn[BLOCK_SIZE] = {};
+    
+    // Potentials of the block to be integrated by quadrature, packed.
+    Index lanes[BLOCK_SIZE];
+    Real  y    [BLOCK_SIZE];    // exp(- q * phi / (k_B * T)).
+    Real  sn   [BLOCK_SIZE];
+    Real  sdn  [BLOCK_SIZE];
+    
+    ArrayXr r;    // Reciprocals of the Fermi-Dirac denominators, if not factorized.
+    
+    for (const Component & c : components_)
+    {
+        Index m = 0;
+        
+        for (Index k = 0; k < size; ++k)
+        {
+            const Real sphi = scale_ * phi[k * stride];
+            const Real u    = sphi + c.offset;
+            
+            if (u < c.boltzmann)
+            {
+                const Real e = c.N0 * std::exp (u + c.variance);
+                
+                n [k] += e;
+                dn[k] += scale_ * e;
+                
+                continue;
+            }
+            
+            const bool nQuadrature  = (charge  != nullptr && u <= c.nSaturation );
+            const bool dnQuadrature = (dcharge != nullptr && u <= c.dnSaturation);
+            
+            if (!nQuadrature)
+                n [k] += c.N0 * (1.0 - std::exp (- u + c.variance));
+                
+            if (!dnQuadrature)
+                dn[k] += scale_ * c.N0 * std::exp (- u + c.variance);
+                
+            if (!nQuadrature && !dnQuadrature)
+                continue;
+                
+            if (factorized && std::abs (sphi) < FACTORIZATION_BOUND)
+            {
+                lanes[m] = k;
+                y[m] = std::exp (- sphi);
+                
+                ++m;
+            }
+            else
+            {
+                r = (1.0 + (exponents_.segment (c.first, nNodes) - sphi).exp()).inverse();
+                
+                if (nQuadrature)
+                    n [k] += (nWeights_.segment (c.first, nNodes) * r).sum();
+                    
+                if (dnQuadrature)
+                    dn[k] += (dnWeights_.segment (c.first, nNodes) * r).sum();
+            }
+        }
+        
+        if (m == 0)
+            continue;
+            
+        // Node-major quadrature, over groups of potentials whose fixed-size sums are vectorized.
+        for (Index k = m; k < BLOCK_SIZE; ++k)
+            y[k] = 0.0;
+            
+        for (Index g = 0; g < m; g += GROUP_SIZE)
+        {
+            const GroupArray yg = Map<const GroupArray> (y + g);
+            
+            GroupArray sg  = GroupArray::Zero();
+            GroupArray dsg = GroupArray::Zero();
+            
+            if (charge != nullptr && dcharge != nullptr)
+            {
+                for (Index j = c.first; j < c.first + nNodes; ++j)
+                {
+                    const GroupArray rg = (1.0 + yg * factors_ (j)).inverse();
+                    
+                    sg  += nWeights_  (j) * rg;
+                    dsg += dnWeights_ (j) * rg;
+                }
+            }
+            else
+            {
+                const ArrayXr & weights = (charge != nullptr) ? nWeights_ : dnWeights_;
+                
+                for (Index j = c.first; j < c.first + nNodes; ++j)
+                    sg += weights (j) / (1.0 + yg * factors_ (j));
+                    
+                if (charge == nullptr)
+                    dsg = sg;
+            }
+            
+            Map<GroupArray> (sn  + g) = sg ;
+            Map<GroupArray> (sdn + g) = dsg;
+        }
+        
+        for (Index k = 0; k < m; ++k)
+        {
+            const Real u = scale_ * phi[lanes[k] * stride] + c.offset;
+            
+            if (charge != nullptr && u <= c.nSaturation)
+                n [lanes[k]] += sn [k];
+                
+            if (dcharge != nullptr && u <= c.dnSaturation)
+                dn[lanes[k]] += sdn[k];
+        }
+    }
+    
+    for (Index k = 0; k < size; ++k)
+    {
+        if (charge != nullptr)
+            charge[k * stride] = - Q * n [k];
+            
+        if (dcharge != nullptr)
+            dcharge[k * stride] = std::min (- Q * dn[k], - std::exp (-20.0));
+    }
+}
+
+ExponentialCharge::ExponentialCharge (const ParamList & params,
+                                      const QuadratureRule & rule)
+    : Charge (params, rule), scale_ (Q / (K_B * params.T_))
+{
+    exponents_ = params_.lambda_exp_ * rule_.nodes_.array() /
+                 (K_B * params_.T_);
+                 
+    nWeights_  = rule_.weights_.array() * params_.N0_exp_;
+    
+    dnWeights_ = - Q * rule_.weights_.array() * params_.N0_exp_ /
+                 params_.lambda_exp_ * rule_.nodes_.array();
+                 
+    if (exponents_.abs().maxCoeff() < FACTORIZATION_BOUND)
+        factors_ = exponents_.exp();
+}
+
+VectorXr
+ExponentialCharge::charge (const VectorXr & phi) const
 {
     VectorXr charge = VectorXr::Zero (phi.size());
     
+    #pragma omp parallel for default(shared)
+    
     for (Index i = 0; i < phi.size(); ++i)
     {
-        charge (i) =
-            - Q * n_approx (phi (i), params_.N0_,
-                            params_.sigma_);
-                            
-        if (params_.N0_2_ > 0.0)
-            charge (i) +=
-                - Q * n_approx (phi (i) + params_.shift_2_,
-                                params_.N0_2_, params_.sigma_2_);
-                                
-        if (params_.N0_3_ > 0.0)
-            charge (i) +=
-                - Q * n_approx (phi (i) + params_.shift_3_,
-                                params_.N0_3_, params_.sigma_3_);
-                                
-        if (params_.N0_4_ > 0.0)
-            charge (i) +=
-                - Q * n_approx (phi (i) + params_.shift_4_,
-                                params_.N0_4_, params_.sigma_4_);
+        const Real sphi = scale_ * phi (i);
+        
+        if (factors_.size() > 0 && std::abs (sphi) < FACTORIZATION_BOUND)
+            charge (i) = - Q * (nWeights_ /
+                                (1.0 + std::exp (- sphi) * factors_)).sum();
+        else
+            charge (i) = - Q * (nWeights_ /
+                                (1.0 + (exponents_ - sphi).exp())).sum();
     }
     
     return charge;
 }
 
 VectorXr
-GaussianCharge::dcharge (const VectorXr & phi) const
+ExponentialCharge::dcharge (const VectorXr & phi) const
 {
     VectorXr dcharge = VectorXr::Zero (phi.size());
     
+    #pragma omp parallel for default(shared)
+    
     for (Index i = 0; i < phi.size(); ++i)
     {
-        dcharge (i) = - Q * dn_approx (phi (i), params_.N0_,
-                                       params_.sigma_);
-                                       
-        if (params_.N0_2_ > 0.0)
-            dcharge (i) +=
-                - Q * dn_approx (phi (i) + params_.shift_2_,
-                                 params_.N0_2_, params_.sigma_2_);
-                                 
-        if (params_.N0_3_ > 0.0)
-            dcharge (i) +=
-                - Q * dn_approx (phi (i) + params_.shift_3_,
-                                 params_.N0_3_, params_.sigma_3_);
-                                 
-        if (params_.N0_4_ > 0.0)
-            dcharge (i) +=
-                - Q * dn_approx (phi (i) + params_.shift_4_,
-                                 params_.N0_4_, params_.sigma_4_);
-                                 
-        if (dcharge (i) > - std::exp (-20.0))
-            dcharge (i) = - std::exp (-20.0);
+        const Real sphi = scale_ * phi (i);
+        
+        if (factors_.size() > 0 && std::abs (sphi) < FACTORIZATION_BOUND)
+            dcharge (i) = - Q * (dnWeights_ /
+                                 (1.0 + std::exp (- sphi) * factors_)).sum();
+        else
+            dcharge (i) = - Q * (dnWeights_ /
+                                 (1.0 + (exponents_ - sphi).exp())).sum();
     }
     
     return dcharge;
 }
 
-ExponentialCharge::ExponentialCharge (const ParamList & params,
-                                      const QuadratureRule & rule)
-    : Charge (params, rule) {}
+void
+ExponentialCharge::evaluate (const VectorXr & phi, VectorXr & charge, VectorXr & dcharge) const
+{
+    charge .resize (phi.size());
+    dcharge.resize (phi.size());
+    
+    #pragma omp parallel default(shared)
+    {
+        ArrayXr r (exponents_.size());    // Reciprocals of the Fermi-Dirac denominators.
+        
+        #pragma omp for
+        
+        for (Index i = 0; i < phi.size(); ++i)
+        {
+            const Real sphi = scale_ * phi (i);
+            
+            if (factors_.size() > 0 && std::abs (sphi) < FACTORIZATION_BOUND)
+                r = (1.0 + std::exp (- sphi) * factors_).inverse();
+            else
+                r = (1.0 + (exponents_ - sphi).exp()).inverse();
+                
+            charge  (i) = - Q * (nWeights_ * r).sum();
+            dcharge (i) = - Q * (dnWeights_ * r).sum();
+        }
+    }
+}
 
-Real
-ExponentialCharge::n_approx (const Real & phi, const Real & N0,
-                             const Real & lambda) const
+TabulatedCharge::TabulatedCharge (const ParamList & params,
+                                  const QuadratureRule & rule,
+                                  const VectorXr & energies,
+                                  const VectorXr & dos)
+    : Charge (params, rule), scale_ (Q / (K_B * params.T()))
 {
-    Real n = 0.0;
+    assert (energies.size() == dos.size());
+    assert (energies.size() >= 2);
+    
+    const Index last = energies.size() - 1;
+    
+    // Uniform integration nodes, spaced by at most kT / 2.
+    const Real kT = K_B * params_.T() / Q;    // [eV].
+    
+    const Index nCells = std::max ((Index) std::ceil (2.0 * (energies (last) - energies (0)) / kT),
+                                   (Index) 1);
+                                   
+    const Real h = (energies (last) - energies (0)) / nCells;
+    
+    VectorXr nodes = VectorXr::LinSpaced (nCells + 1, energies (0), energies (last));
+    
+    // Trapezoidal rule on the interpolated DOS.
+    weights_ = h * numerics::interp1 (energies, dos, nodes).array();
     
-    #pragma omp parallel for default(shared) reduction(+: n)
+    weights_ (0)      *= 0.5;
+    weights_ (nCells) *= 0.5;
     
-    for (Index i = 0; i < rule_.nNodes_; ++i)
-        n += rule_.weights_ (i) * N0 /
-             (1.0 + std::exp ((lambda * rule_.nodes_ (i) - Q * phi) /
-                              (K_B * params_.T_)));
-                              
-    return n;
+    exponents_ = scale_ * nodes.array();
+    
+    if (exponents_.abs().maxCoeff() < FACTORIZATION_BOUND)
+        factors_ = exponents_.exp();
 }
 
-Real
-ExponentialCharge::dn_approx (const Real & phi, const Real & N0,
-                              const Real & lambda) const
+VectorXr
+TabulatedCharge::charge (const VectorXr & phi) const
 {
-    Real dn = 0.0;
+    VectorXr charge = VectorXr::Zero (phi.size());
     
-    #pragma omp parallel for default(shared) reduction(+: dn)
+    #pragma omp parallel for default(shared)
+    
+    for (Index i = 0; i < phi.size(); ++i)
+    {
+        const Real sphi = scale_ * phi (i);
+        
+        if (factors_.size() > 0 && std::abs (sphi) < FACTORIZATION_BOUND)
+            charge (i) = - Q * (weights_ /
+                                (1.0 + std::exp (- sphi) * factors_)).sum();
+        else
+            charge (i) = - Q * (weights_ /
+                                (1.0 + (exponents_ - sphi).exp())).sum();
+    }
     
-    for (Index i = 0; i < rule_.nNodes_; ++i)
-        dn +=
-            - Q * rule_.weights_ (i) * N0 / (lambda) * rule_.nodes_ (i) /
-            (1.0 + std::exp ((lambda * rule_.nodes_ (i) - Q * phi) /
-                             (K_B * params_.T_)));
-                             
-    return dn;
+    return charge;
 }
 
 VectorXr
-ExponentialCharge::charge (const VectorXr & phi) const
+TabulatedCharge::dcharge (const VectorXr & phi) const
+{
+    VectorXr dcharge = VectorXr::Zero (phi.size());
+    
+    #pragma omp parallel for default(shared)
+    
+    for (Index i = 0; i < phi.size(); ++i)
+    {
+        // Derivative of the Fermi-Dirac distribution: f (1 - f) = 1 / (2 + e + 1 / e).
+        const Real sphi = scale_ * phi (i);
+        
+        const ArrayXr e = (factors_.size() > 0 && std::abs (sphi) < FACTORIZATION_BOUND) ?
+                          ArrayXr (std::exp (- sphi) * factors_) : ArrayXr ((exponents_ - sphi).exp());
+                          
+        dcharge (i) = - Q * scale_ * (weights_ / (2.0 + e + e.inverse())).sum();
+        
+        if (dcharge (i) > - std::exp (-20.0))
+            dcharge (i) = - std::exp (-20.0);
+    }
+    
+    return dcharge;
+}
+
+void
+TabulatedCharge::evaluate (const VectorXr & phi, VectorXr & charge, VectorXr & dcharge) const
+{
+    charge .resize (phi.size());
+    dcharge.resize (phi.size());
+    
+    #pragma omp parallel default(shared)
+    {
+        ArrayXr e (exponents_.size());
+        ArrayXr r (exponents_.size());    // Reciprocals of the Fermi-Dirac denominators.
+        
+        #pragma omp for
+        
+        for (Index i = 0; i < phi.size(); ++i)
+        {
+            const Real sphi = scale_ * phi (i);
+            
+            if (factors_.size() > 0 && std::abs (sphi) < FACTORIZATION_BOUND)
+            {
+                // The exponentials are bounded: f (1 - f) = e / (1 + e)^2 = (e * r) * r.
+                e = std::exp (- sphi) * factors_;
+                r = (1.0 + e).inverse();
+                
+                charge  (i) = - Q * (weights_ * r).sum();
+                dcharge (i) = - Q * scale_ * (weights_ * (e * r) * r).sum();
+            }
+            else
+            {
+                e = (exponents_ - sphi).exp();
+                
+                charge  (i) = - Q * (weights_ / (1.0 + e)).sum();
+                dcharge (i) = - Q * scale_ * (weights_ / (2.0 + e + e.inverse())).sum();
+            }
+            
+            if (dcharge (i) > - std::exp (-20.0))
+                dcharge (i) = - std::exp (-20.0);
+        }
+    }
+}
+
+GaussFermiCharge::GaussFermiCharge (const ParamList & params,
+                                    const QuadratureRule & rule,
+                                    const Real & tolerance)
+    : Charge (params, rule), scale_ (Q / (K_B * params.T()))
+{
+    assert (tolerance >= 0.0);
+    
+    const std::vector<Gaussian> gaussians = params_.gaussians();
+    
+    const ArrayXr x = rule_.nodes().array();
+    const ArrayXr w = rule_.weights().array() / SQRT_PI;
+    
+    // The panels are bounded by the closed forms, which are always used far from the gaussian.
+    const Real logTolerance = std::log (0.5 * std::max (tolerance, std::numeric_limits<Real>::epsilon()));
+    
+    // Chebyshev points of the first kind and transform from the values at them to the coefficients.
+    const Index nPoints = CHEBYSHEV_DEGREE + 1;
+    
+    VectorXr points = VectorXr::Zero (nPoints);
+    MatrixXr transform = MatrixXr::Zero (nPoints, nPoints);
+    
+    for (Index k = 0; k < nPoints; ++k)
+    {
+        points (k) = std::cos (PI * (k + 0.5) / nPoints);
+        
+        for (Index m = 0; m < nPoints; ++m)
+            transform (m, k) = (m == 0 ? 1.0 : 2.0) / nPoints * std::cos (PI * m * (k + 0.5) / nPoints);
+    }
+    
+    std::vector<VectorXr> nColumns, dnColumns;
+    
+    for (const Gaussian & g : gaussians)
+    {
+        const Real s = g.sigma / (K_B * params_.T());
+        
+        const ArrayXr a = SQRT_2 * s * x;
+        
+        Component c;
+        
+        c.N0       = g.N0;
+        c.offset   = scale_ * g.shift;
+        c.variance = 0.5 * s * s;
+        c.total    = w.sum();
+        
+        c.boltzmann    =   logTolerance - 3.0 * c.variance;
+        c.nSaturation  = - 0.5 * logTolerance + 2.0 * c.variance;
+        c.dnSaturation = - logTolerance + 3.0 * c.variance;
+        
+        c.first      = nColumns.size();
+        c.negativeNo = (Index) std::ceil (- c.boltzmann / PANEL_WIDTH);
+        c.panelsNo   = c.negativeNo + (Index) std::ceil (c.dnSaturation / PANEL_WIDTH);
+        
+        for (Index p = 0; p < c.panelsNo; ++p)
+        {
+            const Real center = (p - c.negativeNo + 0.5) * PANEL_WIDTH;
+            
+            VectorXr n  = VectorXr::Zero (nPoints);
+            VectorXr dn = VectorXr::Zero (nPoints);
+            
+            // Integrated-by-parts quadrature of the derivative, as for GaussianCharge.
+            VectorXr dnByParts = VectorXr::Zero (nPoints);
+            Real cancellation = 0.0;
+            
+            for (Index k = 0; k < nPoints; ++k)
+            {
+                const Real u = center + 0.5 * PANEL_WIDTH * points (k);
+                
+                // Fermi-Dirac distribution, its complement and its derivative, with no overflow.
+                const ArrayXr z = a - u;
+                const ArrayXr e = (- z.abs()).exp();
+                
+                const ArrayXr fermi      = (z > 0.0).select (e / (1.0 + e), 1.0 / (1.0 + e));
+                const ArrayXr complement = (z > 0.0).select (1.0 / (1.0 + e), e / (1.0 + e));
+                
+                n  (k) = std::log ((w * (p < c.negativeNo ? fermi : complement)).sum());
+                dn (k) = std::log ((w * e / (1.0 + e).square()).sum());
+                
+                const ArrayXr terms = - SQRT_2 / s * w * x * fermi;
+                const Real    sum   = terms.sum();
+                
+                if (sum > 0.0)
+                {
+                    dnByParts (k) = std::log (sum);
+                    cancellation  = std::max (cancellation, terms.abs().sum() / sum);
+                }
+                else
+                    cancellation = std::numeric_limits<Real>::infinity();
+            }
+            
+            nColumns .push_back (transform * n);
+            dnColumns.push_back (transform * (cancellation < CANCELLATION_BOUND ? dnByParts : dn));
+        }
+        
+        components_.push_back (c);
+    }
+    
+    nCoeffs_  = MatrixXr::Zero (nPoints, nColumns.size());
+    dnCoeffs_ = MatrixXr::Zero (nPoints, nColumns.size());
+    
+    for (std::size_t p = 0; p < nColumns.size(); ++p)
+    {
+        nCoeffs_ .col (p) = nColumns [p];
+        dnCoeffs_.col (p) = dnColumns[p];
+    }
+}
+
+VectorXr
+GaussFermiCharge::charge (const VectorXr & phi) const
 {
     VectorXr charge = VectorXr::Zero (phi.size());
     
+    #pragma omp parallel for default(shared)
+    
     for (Index i = 0; i < phi.size(); ++i)
-        charge (i) =
-            - Q * n_approx (phi (i), params_.N0_exp_,
-                            params_.lambda_exp_);
-                            
+    {
+        Real n = 0.0;
+        
+        for (const Component & c : components_)
+        {
+            const Real u = scale_ * phi (i) + c.offset;
+            
+            if (u < c.boltzmann)
+                n += c.N0 * std::exp (u + c.variance);
+            else if (u > c.nSaturation)
+                n += c.N0 * (1.0 - std::exp (- u + c.variance));
+            else
+            {
+                const Index p = std::min (std::max ((Index) std::floor (u / PANEL_WIDTH) + c.negativeNo, (Index) 0),
+                                          c.panelsNo - 1);
+                                          
+                const Real v = std::exp (clenshaw (nCoeffs_, c.first + p,
+                                                   2.0 * u / PANEL_WIDTH - 2.0 * (p - c.negativeNo) - 1.0));
+                                                   
+                n += c.N0 * (p < c.negativeNo ? v : c.total - v);
+            }
+        }
+        
+        charge (i) = - Q * n;
+    }
+    
     return charge;
 }
 
 VectorXr
-ExponentialCharge::dcharge (const VectorXr & phi) const
+GaussFermiCharge::dcharge (const VectorXr & phi) const
 {
     VectorXr dcharge = VectorXr::Zero (phi.size());
     
+    #pragma omp parallel for default(shared)
+    
     for (Index i = 0; i < phi.size(); ++i)
-        dcharge (i) =
-            - Q * dn_approx (phi (i), params_.N0_exp_,
-                             params_.lambda_exp_);
-                             
+    {
+        Real dn = 0.0;
+        
+        for (const Component & c : components_)
+        {
+            const Real u = scale_ * phi (i) + c.offset;
+            
+            if (u < c.boltzmann)
+                dn += c.N0 * std::exp (u + c.variance);
+            else if (u > c.dnSaturation)
+                dn += c.N0 * std::exp (- u + c.variance);
+            else
+            {
+                const Index p = std::min (std::max ((Index) std::floor (u / PANEL_WIDTH) + c.negativeNo, (Index) 0),
+                                          c.panelsNo - 1);
+                                          
+                dn += c.N0 * std::exp (clenshaw (dnCoeffs_, c.first + p,
+                                                 2.0 * u / PANEL_WIDTH - 2.0 * (p - c.negativeNo) - 1.0));
+            }
+        }
+        
+        dcharge (i) = - Q * scale_ * dn;
+        
+        if (dcharge (i) > - std::exp (-20.0))
+            dcharge (i) = - std::exp (-20.0);
+    }
+    
     return dcharge;
 }
@@ -17,6 +17,7 @@
 #ifndef CHARGE_H
 #define CHARGE_H
 
+#include "numerics.h"
 #include "paramList.h"
 #include "quadratureRule.h"
 #include "typedefs.h"
@@ -63,7 +64,59 @@ class Charge
         virtual VectorXr
         dcharge (const VectorXr & phi) const = 0;
         
+        /**
+         * @brief Compute the derivative of the total charge density for the Jacobian of the Newton iterations,
+         * where an approximation suffices since the residual is computed by @ref charge.
+         * @param[in] phi : the electric potential @f$ \varphi @f$.
+         * @returns the derivative: @f$ \frac{\mathrm{d}q(\varphi)}{\mathrm{d}\varphi} \left[ C \cdot m^{-3} \cdot V^{-1} \right] @f$
+         * (computed by @ref dcharge, unless overridden).
+         */
+        virtual VectorXr
+        dcharge_jacobian (const VectorXr & phi) const;
+        
+        /**
+         * The outputs are resized only if their size differs from the one of @a phi, so that buffers
+         * held by the caller across the Newton iterations are not reallocated. Unless overridden,
+         * @ref charge and @ref dcharge_jacobian are called in turn; the derived classes evaluating
+         * both by a quadrature share the exponentials and the reciprocals of the Fermi-Dirac denominators.
+         *
+         * @brief Compute the total charge density and its derivative for the Jacobian of the Newton iterations.
+         * @param[in]  phi     : the electric potential @f$ \varphi @f$;
+         * @param[out] charge  : the total charge density, as computed by @ref charge;
+         * @param[out] dcharge : its derivative, as computed by @ref dcharge_jacobian.
+         */
+        virtual void
+        evaluate (const VectorXr & phi, VectorXr & charge, VectorXr & dcharge) const;
+        
+        /**
+         * The potentials of all the instances are split into blocks, which are evaluated by a single parallel
+         * loop by @ref evaluate_block, in place in the matrices: the instances share the quadrature nodes
+         * and are typically too small to be parallelized one at a time.
+         *
+         * @brief Compute the total charge densities and their derivatives for the Jacobian of the Newton iterations
+         * of several instances.
+         * @param[in]  charges : the charges, one per instance (nullptr for the instances to be skipped);
+         * @param[in]  phi     : the electric potentials, one row per instance;
+         * @param[out] charge  : the total charge densities, one row per instance (resized as @a phi if needed);
+         * @param[out] dcharge : their derivatives, as computed by @ref evaluate, one row per instance (resized as @a phi if needed).
+         */
+        static void
+        evaluate_batch (const std::vector<const Charge *> & charges, const MatrixXr & phi,
+                        MatrixXr & charge, MatrixXr & dcharge);
+                        
     protected:
+        /**
+         * @brief Compute the total charge density and its derivative for the Jacobian of the Newton iterations
+         * on a block of potentials stored with a stride (by @ref evaluate, unless overridden).
+         * @param[in]  phi     : the first electric potential;
+         * @param[in]  size    : the number of potentials;
+         * @param[in]  stride  : the distance between two consecutive potentials, and between the outputs;
+         * @param[out] charge  : the first total charge density;
+         * @param[out] dcharge : the first derivative.
+         */
+        virtual void
+        evaluate_block (const Real * phi, const Index & size, const Index & stride, Real * charge, Real * dcharge) const;
+        
         const ParamList & params_;     /**< @brief Parameter list handler. */
         const QuadratureRule & rule_;  /**< @brief Quadrature rule handler. */
 };
@@ -75,6 +128,17 @@ class Charge
  * is a linear combination of multiple gaussians, whose parameters are read from a @ref ParamList object, of the form:
  * @f[ \frac{N_0}{\sqrt{2\pi\sigma^2}}\exp\left(-\frac{\left(\cdot\right)^2}{2\sigma^2}\right) ~ . @f]
  *
+ * Far from the gaussian, in terms of @f$ u = \frac{q\left(\varphi + \mathrm{shift}\right)}{k_B T} @f$ and
+ * @f$ s = \frac{\sigma}{k_B T} @f$, the Fermi-Dirac distribution reduces to its limits and the
+ * integral has a closed form:
+ * - Boltzmann tail (depletion): @f$ n \simeq N_0 \, e^{u + s^2/2} @f$, with an error lower than
+ *   @f$ N_0 \, e^{2u + 2s^2} @f$;
+ * - saturation (accumulation): @f$ n \simeq N_0 \left(1 - e^{-u + s^2/2}\right) @f$, with an error lower than
+ *   @f$ N_0 \, e^{-2u + 2s^2} @f$.
+ *
+ * At each node, the closed form replaces the quadrature of a gaussian wherever these bounds (and the analogous
+ * ones for the derivative) guarantee a relative error lower than a tolerance.
+ *
  * @brief Class derived from @ref Charge, under the hypothesis that Density of States is a combination of gaussians.
  *
  */
@@ -89,10 +153,12 @@ class
         
         /**
          * @brief Constructor.
-         * @param[in] params : a list of simulation parameters;
-         * @param[in] rule   : a quadrature rule.
+         * @param[in] params    : a list of simulation parameters;
+         * @param[in] rule      : a quadrature rule;
+         * @param[in] tolerance      : relative tolerance of the closed forms (0 to always use the quadrature);
+         * @param[in] mixedPrecision : whether to evaluate the quadrature in @ref dcharge_jacobian in single precision.
          */
-        GaussianCharge (const ParamList &, const QuadratureRule &);
+        GaussianCharge (const ParamList &, const QuadratureRule &, const Real & = 0.0, const bool & = false);
         
         /**
          * @brief Destructor (defaulted).
@@ -105,28 +171,110 @@ class
         virtual VectorXr
         dcharge (const VectorXr &) const override;
         
+        /**
+         * The quadrature of the derivative is evaluated in single precision (if enabled), with twice the
+         * vector width of the double precision one, wherever the factors of the exponentials are representable;
+         * the closed forms and the clamping are left unchanged.
+         */
+        virtual VectorXr
+        dcharge_jacobian (const VectorXr &) const override;
+        
+        /**
+         * A single pass over the quadrature nodes of each gaussian accumulates both the density and
+         * its derivative, unless the mixed precision is enabled.
+         */
+        virtual void
+        evaluate (const VectorXr &, VectorXr &, VectorXr &) const override;
+        
+    protected:
+        /**
+         * The block is integrated by @ref block, unless the mixed precision is enabled.
+         */
+        virtual void
+        evaluate_block (const Real *, const Index &, const Index &, Real *, Real *) const override;
+        
     private:
         /**
-         * @brief Compute electrons density (per unit volume).
-         * @param[in] phi   : the electric potential @f$ \varphi @f$;
-         * @param[in] N0    : the gaussian mean @f$ N_0 @f$;
-         * @param[in] sigma : the gaussian standard deviation @f$ \sigma @f$.
-         * @returns the electrons density @f$ n(\varphi) \left[ m^{-3} \right] @f$.
+         * The potentials are processed in parallel, in blocks integrated by @ref block.
+         *
+         * @brief Compute the total electric charge and/or its derivative.
+         * @param[in]  phi     : the electric potential @f$ \left[ V \right] @f$;
+         * @param[out] charge  : the charge @f$ \left[ C \cdot m^{-3} \right] @f$ (not computed if nullptr);
+         * @param[out] dcharge : its derivative @f$ \left[ C \cdot m^{-3} \cdot V^{-1} \right] @f$ (not computed if nullptr).
          */
-        Real
-        n_approx (const Real &, const Real &, const Real &) const;
+        void
+        kernel (const VectorXr &, VectorXr *, VectorXr *) const;
         
         /**
-         * @brief Compute the approximate derivative of electrons density (per unit volume)
-         * with respect to the electric potential.
-         * @param[in] phi   : the electric potential @f$ \varphi @f$;
-         * @param[in] N0    : the gaussian mean @f$ N_0 @f$;
-         * @param[in] sigma : the gaussian standard deviation @f$ \sigma @f$.
-         * @returns the derivative: @f$ \frac{\mathrm{d}n(\varphi)}{\mathrm{d}\varphi} \left[ m^{-3} \cdot V^{-1} \right] @f$.
+         * For each gaussian, the closed forms are applied potential by potential, then the quadrature of
+         * the remaining ones is evaluated node by node, over fixed-size groups of potentials (vectorized),
+         * so that the reciprocal of a Fermi-Dirac denominator is shared by the charge and its derivative.
+         *
+         * @brief Compute the total electric charge and/or its derivative on a block of potentials stored with a stride.
+         * @param[in]  phi     : the first electric potential @f$ \left[ V \right] @f$;
+         * @param[in]  size    : the number of potentials (at most the block size);
+         * @param[in]  stride  : the distance between two consecutive potentials, and between the outputs;
+         * @param[out] charge  : the first charge @f$ \left[ C \cdot m^{-3} \right] @f$ (not computed if nullptr);
+         * @param[out] dcharge : the first derivative @f$ \left[ C \cdot m^{-3} \cdot V^{-1} \right] @f$ (not computed if nullptr).
          */
-        Real
-        dn_approx (const Real &, const Real &, const Real &) const;
+        void
+        block (const Real *, const Index &, const Index &, Real *, Real *) const;
         
+        /**
+         * @name Quadrature of all the gaussians, concatenated
+         *
+         * The electrons density is approximated as:
+         * @f[ n(\varphi) = \sum_j \frac{w_j}{1 + \exp\left(a_j - \frac{q}{k_B T} \varphi\right)} ~ , @f]
+         * the sum running over the quadrature nodes of all the gaussians, so that any number of them is
+         * evaluated by the same loop. Whenever the exponents are small enough, the factors @f$ e^{a_j} @f$ are
+         * precomputed and the exponential is split as @f$ e^{a_j} \cdot e^{-\frac{q}{k_B T} \varphi} @f$, so that
+         * a single exponential is evaluated for each potential.
+         * @{
+         */
+        ArrayXr exponents_;    /**< @brief Exponents @f$ a_j @f$ at @f$ \varphi = 0 @f$. */
+        ArrayXr factors_  ;    /**< @brief Factors @f$ e^{a_j} @f$ (empty if some exponent is too large). */
+        ArrayXr nWeights_ ;    /**< @brief Weights @f$ w_j \left[ m^{-3} \right] @f$ of the density. */
+        ArrayXr dnWeights_;    /**< @brief Weights of the derivative of the density @f$ \left[ m^{-3} \cdot V^{-1} \right] @f$. */
+        /**
+         * @}
+         */
+        
+        /**
+         * @name Single precision quadrature of the derivative, for @ref dcharge_jacobian
+         *
+         * The derivative of the quadrature of the density is evaluated as:
+         * @f[ \frac{\mathrm{d}n}{\mathrm{d}\varphi} = \frac{q}{k_B T} \sum_j w_j \frac{t_j}{\left(1 + t_j\right)^2} ~ ,
+         *     \qquad t_j = e^{a_j + u_k} \cdot e^{-u} ~ , @f]
+         * being @f$ u_k @f$ the offset of the gaussian the node belongs to, so that all the terms are positive and
+         * both factors of @f$ t_j @f$ stay within the single precision range (empty if the mixed precision is disabled
+         * or some factor is too large).
+         * @{
+         */
+        ArrayXf factorsSingle_ ;    /**< @brief Factors @f$ e^{a_j + u_k} @f$. */
+        ArrayXf nWeightsSingle_;    /**< @brief Weights of the density, relative to @f$ N_0 @f$ and scaled. */
+        Real    singleBound_   ;    /**< @brief Bound on @f$ \left|u\right| @f$ below which no product is a subnormal number. */
+        /**
+         * @}
+         */
+        
+        /**
+         * @brief Struct holding the closed forms of a gaussian.
+         */
+        struct Component
+        {
+            Index first   ;    /**< @brief First quadrature node of the gaussian in the concatenated arrays. */
+            Real  N0      ;    /**< @brief Gaussian @f$ N_0 \left[ m^{-3} \right] @f$. */
+            Real  offset  ;    /**< @brief @f$ u - \frac{q\varphi}{k_B T} @f$. */
+            Real  variance;    /**< @brief @f$ \frac{s^2}{2} @f$. */
+            
+            Real boltzmann   ;    /**< @brief Value of @f$ u @f$ below which the Boltzmann tail is accurate. */
+            Real nSaturation ;    /**< @brief Value of @f$ u @f$ above which the saturated density is accurate. */
+            Real dnSaturation;    /**< @brief Value of @f$ u @f$ above which the saturated derivative is accurate. */
+        };
+        
+        std::vector<Component> components_;    /**< @brief The gaussians. */
+        
+        Real scale_;    /**< @brief @f$ \frac{q}{k_B T} \left[ V^{-1} \right] @f$. */
 };
 
 /**
@@ -167,28 +315,183 @@ class
         virtual VectorXr
         dcharge (const VectorXr &) const override;
         
+        virtual void
+        evaluate (const VectorXr &, VectorXr &, VectorXr &) const override;
+        
+    private:
+        /**
+         * @name Quadrature of the exponential
+         *
+         * Same as for @ref GaussianCharge.
+         * @{
+         */
+        ArrayXr exponents_;    /**< @brief Exponents at @f$ \varphi = 0 @f$. */
+        ArrayXr factors_  ;    /**< @brief Factors @f$ e^{a_j} @f$ (empty if some exponent is too large). */
+        ArrayXr nWeights_ ;    /**< @brief Weights of the density @f$ \left[ m^{-3} \right] @f$. */
+        ArrayXr dnWeights_;    /**< @brief Weights of the derivative of the density @f$ \left[ m^{-3} \cdot V^{-1} \right] @f$. */
+        /**
+         * @}
+         */
+        
+        Real scale_;    /**< @brief @f$ \frac{q}{k_B T} \left[ V^{-1} \right] @f$. */
+};
+
+/**
+ * @class TabulatedCharge
+ *
+ * Provide methods to compute total electric charge and its derivative for a Density of States
+ * @f$ g(E) @f$ given as a table of values, linearly interpolated between its points:
+ * @f[ n(\varphi) = \int g(E) \left( 1 + \exp\left(\frac{E - q\varphi}{k_B T}\right) \right)^{-1} \mathrm{d}E ~ , @f]
+ * the energies being referred to the same level as the mean of the 1st gaussian.
+ *
+ * The integral is computed by the trapezoidal rule on uniform nodes @f$ E_j @f$, spaced by at most
+ * @f$ \frac{k_B T}{2} @f$ independently of the spacing of the table: the weights @f$ w_j = g(E_j) \Delta E @f$
+ * are computed once, so that the charge is evaluated by a single sum, as for @ref GaussianCharge.
+ *
+ * @brief Class derived from @ref Charge, for a tabulated Density of States.
+ *
+ */
+class
+    TabulatedCharge : public Charge
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify a @ref ParamList and a table).
+         */
+        TabulatedCharge () = delete;
+        
+        /**
+         * @brief Constructor.
+         * @param[in] params   : a list of simulation parameters;
+         * @param[in] rule     : a quadrature rule (unused);
+         * @param[in] energies : the energies of the table, strictly increasing @f$ \left[ eV \right] @f$;
+         * @param[in] dos      : the Density of States at @a energies @f$ \left[ m^{-3} \cdot eV^{-1} \right] @f$.
+         */
+        TabulatedCharge (const ParamList &, const QuadratureRule &,
+                         const VectorXr &, const VectorXr &);
+                         
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual
+        ~TabulatedCharge () = default;
+        
+        virtual VectorXr
+        charge (const VectorXr &) const override;
+        
+        virtual VectorXr
+        dcharge (const VectorXr &) const override;
+        
+        virtual void
+        evaluate (const VectorXr &, VectorXr &, VectorXr &) const override;
+        
+    private:
+        ArrayXr exponents_;    /**< @brief Exponents @f$ \frac{E_j}{k_B T} @f$ of the integration nodes. */
+        ArrayXr factors_  ;    /**< @brief Factors @f$ e^{a_j} @f$, as for @ref GaussianCharge (empty if some exponent is too large). */
+        ArrayXr weights_  ;    /**< @brief Integration weights @f$ w_j \left[ m^{-3} \right] @f$. */
+        
+        Real scale_;    /**< @brief @f$ \frac{q}{k_B T} \left[ V^{-1} \right] @f$. */
+};
+
+/**
+ * @class GaussFermiCharge
+ *
+ * For a gaussian DOS, the density is the Gauss-Fermi integral, a function of
+ * @f$ u = \frac{q\left(\varphi + \mathrm{shift}\right)}{k_B T} @f$ only (once @f$ s = \frac{\sigma}{k_B T} @f$ is fixed):
+ * @f[ n(u) = \frac{N_0}{\sqrt{\pi}} \int e^{-x^2} \left(1 + e^{\sqrt{2} s x - u}\right)^{-1} \mathrm{d}x ~ . @f]
+ * Between the closed forms of @ref GaussianCharge, @f$ \log n(u) @f$ (for @f$ u \leq 0 @f$),
+ * @f$ \log\left(N_0 - n(u)\right) @f$ (for @f$ u > 0 @f$) and @f$ \log n'(u) @f$ are interpolated by Chebyshev
+ * polynomials on panels of unit width in @f$ u @f$, fitted once from the quadrature rule (the derivative, as for
+ * @ref GaussianCharge, from the integrated-by-parts form, except where its terms cancel out). Both functions are
+ * analytic in the strip @f$ \left|\mathrm{Im}\,u\right| < \pi @f$, so that a low degree gives an error close
+ * to the machine precision, and each potential costs a few flops and an exponential for each gaussian,
+ * instead of a sum over the quadrature nodes.
+ *
+ * @brief Class derived from @ref Charge, evaluating the Gauss-Fermi integral by piecewise Chebyshev interpolation.
+ *
+ */
+class
+    GaussFermiCharge : public Charge
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify a @ref ParamList and a @ref QuadratureRule).
+         */
+        GaussFermiCharge () = delete;
+        
+        /**
+         * @brief Constructor.
+         * @param[in] params    : a list of simulation parameters;
+         * @param[in] rule      : the quadrature rule the interpolants are fitted from;
+         * @param[in] tolerance : relative tolerance of the closed forms (at least the machine epsilon).
+         */
+        GaussFermiCharge (const ParamList &, const QuadratureRule &, const Real & = 0.0);
+        
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual
+        ~GaussFermiCharge () = default;
+        
+        virtual VectorXr
+        charge (const VectorXr &) const override;
+        
+        virtual VectorXr
+        dcharge (const VectorXr &) const override;
+        
     private:
         /**
-         * @brief Compute electrons density (per unit volume).
-         * @param[in] phi    : the electric potential @f$ \varphi @f$;
-         * @param[in] N0     : the exponential @f$ N_0 @f$;
-         * @param[in] lambda : the exponential @f$ \lambda @f$.
-         * @returns the electrons density @f$ n(\varphi) \left[ m^{-3} \right] @f$.
+         * @brief Evaluate the interpolant on a panel.
+         * @param[in] coeffs : the Chebyshev coefficients of all the panels;
+         * @param[in] panel  : the column of the panel in @a coeffs;
+         * @param[in] x      : the point, mapped to @f$ \left[-1, 1\right] @f$.
+         * @returns the value of the interpolant.
          */
-        Real
-        n_approx (const Real &, const Real &, const Real &) const;
+        static inline Real
+        clenshaw (const MatrixXr &, const Index &, const Real &);
         
         /**
-         * @brief Compute the approximate derivative of electrons density (per unit volume)
-         * with respect to the electric potential.
-         * @param[in] phi : the electric potential @f$ \varphi @f$;
-         * @param[in] N0     : the exponential @f$ N_0 @f$;
-         * @param[in] lambda : the exponential @f$ \lambda @f$.
-         * @returns the derivative: @f$ \frac{\mathrm{d}n(\varphi)}{\mathrm{d}\varphi} \left[ m^{-3} \cdot V^{-1} \right] @f$.
+         * @brief Struct holding the closed forms and the panels of a gaussian.
          */
-        Real
-        dn_approx (const Real &, const Real &, const Real &) const;
+        struct Component
+        {
+            Real N0      ;    /**< @brief Gaussian @f$ N_0 \left[ m^{-3} \right] @f$. */
+            Real offset  ;    /**< @brief @f$ u - \frac{q\varphi}{k_B T} @f$. */
+            Real variance;    /**< @brief @f$ \frac{s^2}{2} @f$. */
+            Real total   ;    /**< @brief Quadrature of the density for @f$ u \to +\infty @f$, relative to @f$ N_0 @f$. */
+            
+            Real boltzmann   ;    /**< @brief Value of @f$ u @f$ below which the Boltzmann tail is accurate. */
+            Real nSaturation ;    /**< @brief Value of @f$ u @f$ above which the saturated density is accurate. */
+            Real dnSaturation;    /**< @brief Value of @f$ u @f$ above which the saturated derivative is accurate. */
+            
+            Index first   ;    /**< @brief Column of the first panel in the coefficient matrices. */
+            Index negativeNo;    /**< @brief Number of panels in @f$ u \leq 0 @f$. */
+            Index panelsNo  ;    /**< @brief Number of panels. */
+        };
+        
+        std::vector<Component> components_;    /**< @brief The gaussians. */
+        
+        MatrixXr nCoeffs_ ;    /**< @brief Chebyshev coefficients of the density, one column for each panel. */
+        MatrixXr dnCoeffs_;    /**< @brief Chebyshev coefficients of the derivative of the density, one column for each panel. */
         
+        Real scale_;    /**< @brief @f$ \frac{q}{k_B T} \left[ V^{-1} \right] @f$. */
 };
 
+// Implementations.
+inline Real
+GaussFermiCharge::clenshaw (const MatrixXr & coeffs, const Index & panel, const Real & x)
+{
+    Real b1 = 0.0, b2 = 0.0;
+    
+    for (Index m = coeffs.rows() - 1; m >= 1; --m)
+    {
+        const Real b0 = 2.0 * x * b1 - b2 + coeffs (m, panel);
+        
+        b2 = b1;
+        b1 = b0;
+    }
+    
+    return x * b1 - b2 + coeffs (0, panel);
+}
+
 #endif /* CHARGE_H */
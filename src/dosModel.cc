@@ -23,42 +23,54 @@ using namespace utility;
 DosModel::DosModel()
     : initialized_ (false), params_(), V_shift_ (0.0), error_L2_ (0.0),
       error_H1_ (0.0), error_Peak_ (0.0),
-      C_acc_experim_ (0.0), C_acc_simulated_ (0.0), C_dep_experim_ (0.0) {}
+      C_acc_experim_ (0.0), C_acc_simulated_ (0.0), C_dep_experim_ (0.0),
+      errorThreshold_ (nullptr), errorNorm_ (2), aborted_ (false) {}
 
 DosModel::DosModel (const ParamList & params)
     : initialized_ (true), params_ (params), V_shift_ (0.0),
       error_L2_ (0.0), error_H1_ (0.0), error_Peak_ (0.0),
-      C_acc_experim_ (0.0), C_acc_simulated_ (0.0), C_dep_experim_ (0.0) {}
+      C_acc_experim_ (0.0), C_acc_simulated_ (0.0), C_dep_experim_ (0.0),
+      errorThreshold_ (nullptr), errorNorm_ (2), aborted_ (false) {}
 
 void DosModel::simulate (const GetPot & config,
                          const std::string & input_experim,
                          const std::string & output_directory,
                          const std::string & output_plot_subdir,
                          const std::string & output_filename)
+{
+    simulate (config, std::vector<std::string> (1, input_experim),
+              output_directory, output_plot_subdir, output_filename);
+              
+    return;
+}
+
+void DosModel::simulate (const GetPot & config,
+                         const std::vector<std::string> & input_experim,
+                         const std::string & output_directory,
+                         const std::string & output_plot_subdir,
+                         const std::string & output_filename)
 {
     if (!initialized_)
     {
         throw std::logic_error ("ERROR: list of parameters in DosModel has not been properly initialized.");
     }
     
+    if (input_experim.empty())
+    {
+        throw std::logic_error ("ERROR: no file containing experimental data has been specified.");
+    }
+    
     // Define output filenames.
     const std::string output_info_filename = output_filename +
             "_info.txt";
-    const std::string output_CV_filename = output_filename + "_CV.csv";
-    
+            
     // Open output files.
     std::ofstream output_info;
-    std::ofstream output_CV;
     
     output_info.open (output_directory + output_info_filename,
                       std::ios_base::out);
                       
-    output_CV.open (output_directory + output_CV_filename,
-                    std::ios_base::out);
-    output_CV.setf (std::ios_base::scientific);
-    output_CV.precision (std::numeric_limits<Real>::digits10);
-    
-    if (output_info.bad() || output_CV.bad())
+    if (output_info.bad())
     {
         throw std::ofstream::failure ("ERROR: output files cannot be opened or directory does not exist.");
     }
@@ -76,228 +88,932 @@ void DosModel::simulate (const GetPot & config,
                  
     VectorXr V = VectorXr::LinSpaced (params_.nSteps_, params_.V_min_, params_.V_max_);
     
-    Index semicNodesNo = floor (0.6 * params_.nNodes_);
-    Index   insNodesNo = params_.nNodes_ - semicNodesNo;
-    
-    // Mesh creation.
+    // Mesh creation, graded towards the semiconductor/insulator interface.
     output_info << "Creating mesh...";
-    VectorXr x = VectorXr::Zero (params_.nNodes_);     // The mesh.
+    Index semicNodesNo = 0;
+    VectorXr x = build_mesh (config, semicNodesNo);     // The mesh.
+    print_done (output_info);
+    
+    // System assembly.
+    output_info << "Assembling system matrices...";
+    std::shared_ptr<const Bim1D> bimSolver = Bim1DCache::get (x, params_);
+    print_done (output_info);
+    
+    // Computing nodes and weights of quadrature.
+    output_info << "Computing nodes and weights of quadrature";
     
+    QuadratureRule * quadRule = build_quadrature (config, output_info,
+                                std::vector<const DosModel *> (1, this));
+                                
+    print_done (output_info);
+    
+    // Constitutive relation.
+    output_info
+            << "Initializing constitutive relation for the Density of States";
+            
+    Charge * charge_fun = build_charge (config, *quadRule, output_info);
+    
+    output_info << "...";
+    print_done (output_info);
+    
+    // Initialize Newton solver for the non-linear Poisson equation.
+    Index maxIterationsNo = config ("NLP/maxIterationsNo", 100);
+    Real  tolerance       = config ("NLP/tolerance", 1.0e-4);
+    
+    // Warm start from a stored solution: each bias step starts from its own
+    // initial guess, so that steps do not depend on each other.
+    const bool warmStart = (Phi_guess_.size() > 0);
+    
+    if (warmStart && (Phi_guess_.rows() != x.size() || Phi_guess_.cols() != V.size()))
     {
-        VectorXr temp1 = VectorXr::LinSpaced (semicNodesNo, -params_.t_semic_,
-                                              0);
-        VectorXr temp2 = VectorXr::LinSpaced (insNodesNo + 1,
-                                              0, params_.t_ins_);
-                                              
-        x << temp1, temp2.segment (1, temp2.size() - 1);
+        throw std::runtime_error ("ERROR: the initial guess for the potential does not match the mesh or the number of steps.");
+    }
+    
+    // Variables initialization.
+    output_info << "Initializing variables...";
+    
+    MatrixXr Phi  = MatrixXr::Zero (x.size(), V.size());
+    MatrixXr Dens = MatrixXr::Zero (semicNodesNo, V.size());
+    
+    VectorXr PhiBcorr = VectorXr::Zero (V.size());
+    VectorXr cTot     = VectorXr::Zero (V.size());
+    VectorXr charge_n = VectorXr::Zero (V.size());
+    
+    Index iterationsNo = 0;    // Total number of Newton iterations.
+    
+    // Experimental data, needed to bound the distance during the sweep.
+    const bool earlyTermination = (errorThreshold_ != nullptr && !warmStart);
+    
+    std::vector<VectorXr> V_experim (input_experim.size());
+    std::vector<VectorXr> C_experim (input_experim.size());
+    
+    if (earlyTermination)
+    {
+        for (std::size_t k = 0; k < input_experim.size(); ++k)
+        {
+            import_experim (config, input_experim[k], V_experim[k], C_experim[k]);
+        }
+    }
+    
+    aborted_ = false;
+    
+    // Adaptive mesh refinement: the steps are solved sequentially, each on the mesh adapted to the previous one.
+    std::unique_ptr<AdaptivePoisson1D> amrSolver;
+    
+    if (config ("Mesh/AMR/enabled", false))
+    {
+        amrSolver.reset (new AdaptivePoisson1D (params_, x, config, maxIterationsNo, tolerance));
+    }
+    
+    const bool adaptive = (amrSolver != nullptr);
+    
+    // Quasi-static drift-diffusion: the electron continuity equation is coupled with the Poisson equation.
+    const bool driftDiffusion = config ("DriftDiffusion/enabled", false);
+    const bool coupled        = config ("DriftDiffusion/coupled", true);
+    const Real mobility       = config ("DriftDiffusion/mobility", 1.0e-8);
+    
+    if (driftDiffusion && adaptive)
+    {
+        throw std::runtime_error ("ERROR: the drift-diffusion solver can't be used together with the adaptive mesh refinement.");
+    }
+    
+    // Small-signal analysis at a list of frequencies: if they are as many as the sets of experimental data,
+    // each set is compared with the capacitance at its own frequency instead of the quasi-static one.
+    VectorXr frequencies = VectorXr::Zero (config.vector_variable_size ("DriftDiffusion/frequencies"));
+    
+    for (Index k = 0; k < frequencies.size(); ++k)
+    {
+        frequencies (k) = config ("DriftDiffusion/frequencies", 0.0, (int) k);
+    }
+    
+    if (frequencies.size() > 0 && (!driftDiffusion || frequencies.minCoeff() <= 0.0))
+    {
+        throw std::runtime_error ("ERROR: the small-signal analysis requires \"DriftDiffusion/enabled = 1\" and positive frequencies.");
+    }
+    
+    const bool frequencyFit = (frequencies.size() > 0 && frequencies.size() == (Index) input_experim.size());
+    
+    MatrixXr C_ac = MatrixXr::Zero (V.size(), frequencies.size());
+    MatrixXr G_ac = MatrixXr::Zero (V.size(), frequencies.size());
+    
+    // Reduced-order model: the steps are solved on a basis built from a few full-order solutions.
+    const bool reducedOrder = config ("ReducedOrder/enabled", false);
+    
+    if (reducedOrder && (adaptive || driftDiffusion))
+    {
+        throw std::runtime_error ("ERROR: the reduced-order model can't be used together with the adaptive mesh refinement or the drift-diffusion solver.");
+    }
+    
+    Index fallbacksNo = 0;    // Number of steps solved by the full-order solver instead of the reduced one.
+    
+    const Real residualTolerance  = config ("ReducedOrder/residualTolerance", 1.0e-8);
+    const Real parameterTolerance = config ("ReducedOrder/parameterTolerance", 0.5);
+    const Index residualInterval  = config ("ReducedOrder/residualInterval", 1);
+    
+    if (reducedOrder && (residualTolerance <= 0.0 || parameterTolerance < 0.0 || residualInterval < 1))
+    {
+        throw std::runtime_error ("ERROR: wrong variables in section \"ReducedOrder\" set in the configuration file.");
     }
     
-    VectorXr xm = 0.5 * (x.segment(1, x.size() - 1) + x.segment(0, x.size() - 1));
     print_done (output_info);
     
-    // System assembly.
-    output_info << "Assembling system matrices...";
-    VectorXr eps = params_.eps_semic_ * VectorXr::Ones (xm.size());
+    if (reducedOrder && (reducedBasis_ == nullptr || reducedBasis_->solver() != bimSolver
+                         || reducedBasis_->distance (params_) > parameterTolerance))
+    {
+        const Index snapshotsNo  = config ("ReducedOrder/snapshotsNo", 40);
+        const Real  podTolerance = config ("ReducedOrder/tolerance", 1.0e-10);
+        const Index maxModesNo   = config ("ReducedOrder/maxModesNo", 40);
+        
+        if (snapshotsNo < 2 || snapshotsNo > V.size() || podTolerance <= 0.0 || maxModesNo < 1)
+        {
+            throw std::runtime_error ("ERROR: wrong variables in section \"ReducedOrder\" set in the configuration file.");
+        }
+        
+        output_info << "Building reduced-order model from "
+                    << snapshotsNo << " full-order solutions...";
+                    
+        // Evenly spaced steps, solved by continuation from one another.
+        MatrixXr Phi_snapshots      = MatrixXr::Zero (x.size(), snapshotsNo);
+        VectorXr PhiBcorr_snapshots = VectorXr::Zero (snapshotsNo);
+        
+        NonLinearPoisson1D nlpSolver (params_, *bimSolver, maxIterationsNo, tolerance);
+        
+        for (Index j = 0; j < snapshotsNo; ++j)
+        {
+            const Index i     = (j * (V.size() - 1)) / (snapshotsNo - 1);
+            const Index iPrev = ((j - 1) * (V.size() - 1)) / (snapshotsNo - 1);
+            
+            VectorXr phiOld = VectorXr::Zero (x.size());
+            
+            if (warmStart)
+            {
+                phiOld = Phi_guess_.col (i);
+                phiOld +=
+                    VectorXr::LinSpaced (phiOld.size(),
+                                         - (params_.Wf_ / Q - params_.Ea_ / Q) - phiOld (0),
+                                         - (params_.Wf_ / Q - params_.Ea_ / Q - V (i)) - phiOld (phiOld.size() - 1));
+            }
+            else if (j == 0)
+                phiOld =
+                    -VectorXr::LinSpaced (phiOld.size(),
+                                          params_.Wf_ / Q - params_.Ea_ / Q,
+                                          params_.Wf_ / Q - params_.Ea_ / Q - V (i));
+            else
+                phiOld = Phi_snapshots.col (j - 1) +
+                         VectorXr::LinSpaced (phiOld.size(), 0, V (i) - V (iPrev));
+                         
+            nlpSolver.apply (phiOld, *charge_fun);
+            
+            Phi_snapshots.col (j)  = nlpSolver.phi();
+            PhiBcorr_snapshots (j) = nlpSolver.PhiBcorr();
+            
+            iterationsNo += nlpSolver.norm().size();
+            
+            if (nlpSolver.norm() (nlpSolver.norm().size() - 1) >= tolerance)
+            {
+                output_info << std::endl
+                            << "\tWARNING: Newton's method did not converge!"
+                            << " (V = " << V(i) << "[V])";
+            }
+        }
+        
+        reducedBasis_ = std::make_shared<const ReducedPoissonBasis> (params_, bimSolver, Phi_snapshots,
+                                                                     PhiBcorr_snapshots, *charge_fun,
+                                                                     podTolerance, maxModesNo);
+                                                                    
+        output_info << " (" << reducedBasis_->modesNo() << " modes, "
+                    << reducedBasis_->pointsNo() << " interpolation nodes)...";
+        print_done (output_info);
+    }
+    
+    output_info
+            << "Running Newton solver for non-linear Poisson equation"
+            << (warmStart ? " (warm start)" : "")
+            << (adaptive ? " (adaptive mesh)" : "")
+            << (driftDiffusion ? (coupled ? " (drift-diffusion, coupled)" : " (drift-diffusion, Gummel)") : "")
+            << (reducedOrder ? " (reduced order)" : "")
+            << "..."
+            << std::endl
+            << "\tMax No. of iterations set: "
+            << maxIterationsNo
+            << std::endl
+            << "\tTolerance set: "
+            << tolerance << std::endl;
+            
+    // Start simulation.
+    #pragma omp parallel for if(warmStart && !adaptive) schedule(dynamic) default(shared) reduction(+: iterationsNo)
+    
+    for (Index i = 0; i < V.size(); ++i)
+    {
+        if (aborted_)
+        {
+            continue;
+        }
+        
+        // Print current step number.
+        if (i == 0 || (i + 1) % 10 == 0 || i == V.size() - 1)
+        {
+            #pragma omp critical
+            output_info << std::endl << "\tstep: "
+                        << (i + 1) << "/" << params_.nSteps_;
+        }
+        
+        VectorXr phiOld = VectorXr::Zero (x.size());
+        
+        if (warmStart)
+        {
+            // Enforce the Dirichlet conditions of the current bias on the stored solution.
+            phiOld = Phi_guess_.col (i);
+            phiOld +=
+                VectorXr::LinSpaced (phiOld.size(),
+                                     - (params_.Wf_ / Q - params_.Ea_ / Q) - phiOld (0),
+                                     - (params_.Wf_ / Q - params_.Ea_ / Q - V (i)) - phiOld (phiOld.size() - 1));
+        }
+        else if (i == 0)
+            phiOld =
+                -VectorXr::LinSpaced (phiOld.size(),
+                                      params_.Wf_ / Q - params_.Ea_ / Q,
+                                      params_.Wf_ / Q - params_.Ea_ / Q - V (i));
+        else if (!adaptive)
+            phiOld = Phi.col (i - 1) +
+                     VectorXr::LinSpaced (phiOld.size(), 0, V (i) - V (i - 1));
+                     
+        VectorXr norm;
+        
+        VectorXr phin = VectorXr::Zero (semicNodesNo);    // Electron quasi-Fermi potential.
+        
+        if (adaptive)
+        {
+            // Continuation on the adapted mesh, the solution being stored on the reference one.
+            if (warmStart || i == 0)
+                amrSolver->apply (amrSolver->transfer (x, phiOld), *charge_fun);
+            else
+                amrSolver->apply (amrSolver->phi() +
+                                  VectorXr::LinSpaced (amrSolver->mesh().size(), 0, V (i) - V (i - 1)),
+                                  *charge_fun);
+                                 
+            Phi.col (i) = numerics::interp1 (amrSolver->mesh(), amrSolver->phi(), x);
+            PhiBcorr(i) = amrSolver->PhiBcorr();
+            cTot    (i) = amrSolver->cTot();
+            
+            norm = amrSolver->norm();
+        }
+        else if (driftDiffusion)
+        {
+            DriftDiffusion1D ddSolver (params_, *bimSolver, mobility, coupled, maxIterationsNo, tolerance);
+            
+            ddSolver.apply (phiOld, *charge_fun);
+            
+            Phi.col (i) = ddSolver.phi();
+            PhiBcorr(i) = ddSolver.PhiBcorr();
+            cTot    (i) = ddSolver.cTot();
+            
+            assert (ddSolver.phin().size() == semicNodesNo);
+            phin = ddSolver.phin();
+            
+            norm = ddSolver.norm();
+            
+            if (frequencies.size() > 0)
+            {
+                VectorXr C;
+                VectorXr G;
+                
+                ddSolver.admittance (frequencies, C, G);
+                
+                C_ac.row (i) = C.transpose();
+                G_ac.row (i) = G.transpose();
+            }
+        }
+        else
+        {
+            bool solved = false;
+            
+            if (reducedOrder)
+            {
+                ReducedPoisson1D romSolver (params_, *reducedBasis_, maxIterationsNo, tolerance);
+                
+                romSolver.apply (phiOld, *charge_fun, i % residualInterval == 0 || i == V.size() - 1);
+                
+                norm = romSolver.norm();
+                
+                // The reduced solution is accepted only if it also solves the full-order equation
+                // (checked every "ReducedOrder/residualInterval" steps).
+                if (norm (norm.size() - 1) < tolerance && romSolver.residual() < residualTolerance)
+                {
+                    Phi.col (i) = romSolver.phi();
+                    PhiBcorr(i) = romSolver.PhiBcorr();
+                    cTot    (i) = romSolver.cTot();
+                    
+                    solved = true;
+                }
+                else
+                {
+                    // Fall back to the full-order solver.
+                    iterationsNo += norm.size();
+                    
+                    #pragma omp atomic
+                    ++fallbacksNo;
+                }
+            }
+            
+            if (!solved)
+            {
+                NonLinearPoisson1D nlpSolver (params_, *bimSolver, maxIterationsNo, tolerance);
+                
+                nlpSolver.apply (phiOld, *charge_fun);
+                
+                Phi.col (i) = nlpSolver.phi();
+                PhiBcorr(i) = nlpSolver.PhiBcorr();
+                cTot    (i) = nlpSolver.cTot();
+                
+                norm = nlpSolver.norm();
+            }
+        }
+        
+        VectorXr charge = charge_fun->charge ((Phi.col(i).segment(0, semicNodesNo) - phin).array() + PhiBcorr(i));
+        Dens.col(i) = -charge / Q;
+        
+        charge_n(i) = numerics::trapz ((VectorXr) x.segment(0, semicNodesNo), charge);
+        
+        iterationsNo += norm.size();
+        
+        if (norm (norm.size() - 1) >= tolerance)
+        {
+            #pragma omp critical
+            output_info << std::endl
+                        << "\t\tWARNING: Newton's method did not converge!"
+                        << " (V = " << V(i) << "[V])";
+        }
+        
+        // Abort as soon as a lower bound of the distance exceeds the threshold.
+        if (earlyTermination && (i + 1) % 10 == 0)
+        {
+            Real threshold;
+            
+            // Updated by concurrent simulations in the same critical section.
+            #pragma omp critical (ErrorThreshold)
+            threshold = *errorThreshold_;
+            
+            Real bound = 0.0;
+            
+            for (std::size_t k = 0; k < input_experim.size(); ++k)
+            {
+                const VectorXr & C_k = frequencyFit ? static_cast<VectorXr> (C_ac.col (k)) : cTot;
+                
+                bound += std::pow (numerics::cv_errors_bound (V_experim[k], C_experim[k], V,
+                                                              (C_k.array() * params_.A_semic_ + params_.C_sb_).matrix(),
+                                                              i + 1, errorNorm_), 2);
+            }
+            
+            bound = std::sqrt (bound);
+            
+            if (bound > threshold)
+            {
+                aborted_ = true;
+                
+                output_info << std::endl
+                            << "\tSimulation aborted: the distance is at least "
+                            << bound << " > " << threshold << " (threshold)";
+            }
+        }
+    }
+    
+    Phi_ = std::move (Phi);
+    
+    if (fallbacksNo > 0)
+    {
+        output_info << std::endl
+                    << "\tSteps solved by the full-order solver: "
+                    << fallbacksNo;
+    }
+    
+    print_done (output_info);
+    
+    output_info << "Total No. of Newton iterations: " << iterationsNo
+                << std::endl;
+                
+    if (adaptive)
+    {
+        output_info << "No. of nodes of the adapted mesh at the last step: "
+                    << amrSolver->mesh().size() << std::endl;
+    }
+    
+    // Timing.
+    high_resolution_clock::time_point finalTime =
+        high_resolution_clock::now();
+    output_info << "Simulation took " << duration_cast<seconds>
+                (finalTime - initTime).count()
+                << " seconds." << std::endl;
+                
+    // Free up memory to avoid leaks.
+    delete quadRule;
+    quadRule = nullptr;
+    
+    delete charge_fun;
+    charge_fun = nullptr;
+    
+    if (aborted_)
+    {
+        error_L2_   = std::numeric_limits<Real>::infinity();
+        error_H1_   = std::numeric_limits<Real>::infinity();
+        error_Peak_ = std::numeric_limits<Real>::infinity();
+        
+        output_info.close();
+        
+        return;
+    }
+    
+    // Capacitance and conductance at each frequency.
+    if (frequencies.size() > 0)
+    {
+        std::ofstream output_ac;
+        
+        output_ac.open (output_directory + output_filename + "_admittance.csv", std::ios_base::out);
+        
+        if (output_ac.bad())
+        {
+            throw std::ofstream::failure ("ERROR: output files cannot be opened or directory does not exist.");
+        }
+        
+        output_ac.setf (std::ios_base::scientific);
+        output_ac.precision (std::numeric_limits<Real>::digits10);
+        
+        output_ac << "V_simulated [V]";
+        
+        for (Index k = 0; k < frequencies.size(); ++k)
+        {
+            output_ac << ", C(" << frequencies (k) << " Hz) [F], G(" << frequencies (k) << " Hz) [S]";
+        }
+        
+        output_ac << std::endl;
+        
+        for (Index i = 0; i < V.size(); ++i)
+        {
+            output_ac << V (i);
+            
+            for (Index k = 0; k < frequencies.size(); ++k)
+            {
+                output_ac << ", " << C_ac (i, k) * params_.A_semic_ + params_.C_sb_
+                          << ", " << G_ac (i, k) * params_.A_semic_;
+            }
+            
+            output_ac << std::endl;
+        }
+        
+        output_ac.close();
+    }
+    
+    // Post-processing and creation of output files.
+    write_output (config, input_experim, output_directory, output_plot_subdir,
+                  output_filename, output_info, x, Dens, Phi_, semicNodesNo, V,
+                  frequencyFit ? C_ac : static_cast<MatrixXr> (cTot));
+                  
+    return;
+}
+
+void DosModel::simulate (std::vector<DosModel> & models,
+                         const GetPot & config,
+                         const std::vector<std::string> & input_experim,
+                         const std::string & output_directory,
+                         const std::string & output_plot_subdir,
+                         const std::vector<std::string> & output_filenames)
+{
+    if (models.empty() || models.size() != output_filenames.size())
+    {
+        throw std::logic_error ("ERROR: the number of models and of output filenames in the batch do not match.");
+    }
+    
+    // Models that can't be advanced in lockstep are simulated one at a time.
+    bool sequential = (models.size() == 1 || config ("Mesh/AMR/enabled", false) || config ("DriftDiffusion/enabled", false)
+                       || config ("ReducedOrder/enabled", false));
+                       
+    for (const DosModel & model : models)
+    {
+        if (!model.initialized_)
+        {
+            throw std::logic_error ("ERROR: list of parameters in DosModel has not been properly initialized.");
+        }
+        
+        const ParamList & params = models[0].params_;
+        
+        if (model.params_.nNodes_    != params.nNodes_    || model.params_.nSteps_  != params.nSteps_  ||
+                model.params_.V_min_     != params.V_min_     || model.params_.V_max_   != params.V_max_   ||
+                model.params_.t_semic_   != params.t_semic_   || model.params_.t_ins_   != params.t_ins_   ||
+                model.params_.eps_semic_ != params.eps_semic_ || model.params_.eps_ins_ != params.eps_ins_ ||
+                model.params_.Wf_        != params.Wf_        || model.params_.Ea_      != params.Ea_)
+        {
+            throw std::logic_error ("ERROR: the models in a batch must share the mesh, the device geometry and the bias sweep.");
+        }
+        
+        if (model.Phi_guess_.size() > 0 || model.errorThreshold_ != nullptr)
+        {
+            sequential = true;
+        }
+    }
+    
+    if (sequential)
+    {
+        for (std::size_t k = 0; k < models.size(); ++k)
+        {
+            // Nearby parameter sets share the reduced basis, rebuilt by each model whose parameters
+            // are farther than "ReducedOrder/parameterTolerance" from the ones of its snapshots.
+            if (k > 0 && models[k].reducedBasis_ == nullptr)
+            {
+                models[k].reducedBasis_ = models[k - 1].reducedBasis_;
+            }
+            
+            models[k].simulate (config, input_experim, output_directory,
+                                output_plot_subdir, output_filenames[k]);
+        }
+        
+        return;
+    }
+    
+    if (input_experim.empty())
+    {
+        throw std::logic_error ("ERROR: no file containing experimental data has been specified.");
+    }
+    
+    const Index nBatch = models.size();
+    
+    const ParamList & params = models[0].params_;
+    
+    // Open output files.
+    std::vector< std::unique_ptr<std::ofstream> > output_info (nBatch);
+    
+    for (Index k = 0; k < nBatch; ++k)
+    {
+        output_info[k].reset (new std::ofstream (output_directory + output_filenames[k] + "_info.txt",
+                                                 std::ios_base::out));
+                                                 
+        if (output_info[k]->bad())
+        {
+            throw std::ofstream::failure ("ERROR: output files cannot be opened or directory does not exist.");
+        }
+        
+        *output_info[k] << "Running on thread: " << omp_get_thread_num()
+                        << " (batch of " << nBatch << " simulations)." << std::endl;
+                        
+        print_block (("Simulation No. " + std::to_string
+                      (models[k].params_.simulationNo_) + " started.").c_str(),
+                     *output_info[k]);
+    }
+    
+    // Timing.
+    high_resolution_clock::time_point initTime =
+        high_resolution_clock::now();
+        
+    VectorXr V = VectorXr::LinSpaced (params.nSteps_, params.V_min_, params.V_max_);
+    
+    // Mesh, system matrices and quadrature rule are shared by the whole batch.
+    std::ostringstream shared_info;
+    
+    shared_info << "Creating mesh...";
+    Index semicNodesNo = 0;
+    VectorXr x = models[0].build_mesh (config, semicNodesNo);     // The mesh.
+    print_done (shared_info);
+    
+    shared_info << "Assembling system matrices...";
+    std::shared_ptr<const Bim1D> bimSolver = Bim1DCache::get (x, params);
+    print_done (shared_info);
+    
+    shared_info << "Computing nodes and weights of quadrature";
+    std::vector<const DosModel *> batch (nBatch, nullptr);
+    
+    for (Index k = 0; k < nBatch; ++k)
+    {
+        batch[k] = &models[k];
+    }
+    
+    QuadratureRule * quadRule = build_quadrature (config, shared_info, batch);
+    print_done (shared_info);
+    
+    // Constitutive relations.
+    std::vector<Charge *> charge_fun (nBatch, nullptr);
+    std::vector<const Charge *> charge_batch (nBatch, nullptr);
+    
+    for (Index k = 0; k < nBatch; ++k)
+    {
+        *output_info[k] << shared_info.str()
+                        << "Initializing constitutive relation for the Density of States";
+                        
+        charge_fun[k] = models[k].build_charge (config, *quadRule, *output_info[k]);
+        charge_batch[k] = charge_fun[k];
+        
+        *output_info[k] << "...";
+        print_done (*output_info[k]);
+    }
+    
+    // Initialize Newton solver for the non-linear Poisson equations.
+    Index maxIterationsNo = config ("NLP/maxIterationsNo", 100);
+    Real  tolerance       = config ("NLP/tolerance", 1.0e-4);
+    
+    BatchedNonLinearPoisson1D nlpSolver (params, *bimSolver, maxIterationsNo, tolerance);
+    
+    // Variables initialization.
+    std::vector<MatrixXr> Phi  (nBatch, MatrixXr::Zero (x.size(), V.size()));
+    std::vector<MatrixXr> Dens (nBatch, MatrixXr::Zero (semicNodesNo, V.size()));
+    
+    MatrixXr cTot = MatrixXr::Zero (V.size(), nBatch);
+    
+    VectorX<Index> iterationsNo = VectorX<Index>::Zero (nBatch);    // Total number of Newton iterations.
+    
+    for (Index k = 0; k < nBatch; ++k)
+    {
+        models[k].aborted_ = false;
+        
+        *output_info[k]
+                << "Running Newton solver for non-linear Poisson equation (batched)..."
+                << std::endl
+                << "\tMax No. of iterations set: "
+                << maxIterationsNo
+                << std::endl
+                << "\tTolerance set: "
+                << tolerance << std::endl;
+    }
+    
+    // Start simulation: all the models are advanced in lockstep through the bias sweep.
+    MatrixXr phiOld = MatrixXr::Zero (x.size(), nBatch);
+    
+    for (Index i = 0; i < V.size(); ++i)
+    {
+        // Print current step number.
+        if (i == 0 || (i + 1) % 10 == 0 || i == V.size() - 1)
+        {
+            for (Index k = 0; k < nBatch; ++k)
+            {
+                *output_info[k] << std::endl << "\tstep: "
+                                << (i + 1) << "/" << params.nSteps_;
+            }
+        }
+        
+        for (Index k = 0; k < nBatch; ++k)
+        {
+            if (i == 0)
+                phiOld.col (k) =
+                    -VectorXr::LinSpaced (x.size(),
+                                          params.Wf_ / Q - params.Ea_ / Q,
+                                          params.Wf_ / Q - params.Ea_ / Q - V (i));
+            else
+                phiOld.col (k) = Phi[k].col (i - 1) +
+                                 VectorXr::LinSpaced (x.size(), 0, V (i) - V (i - 1));
+        }
+        
+        nlpSolver.apply (phiOld, charge_batch);
+        
+        for (Index k = 0; k < nBatch; ++k)
+        {
+            Phi[k].col (i) = nlpSolver.phi().col (k);
+            cTot (i, k)    = nlpSolver.cTot() (k);
+            
+            VectorXr charge = charge_fun[k]->charge (Phi[k].col(i).segment(0, semicNodesNo).array() + nlpSolver.PhiBcorr() (k));
+            Dens[k].col(i) = -charge / Q;
+            
+            iterationsNo (k) += nlpSolver.iterationsNo() (k);
+            
+            if (nlpSolver.norm() (k) >= tolerance)
+            {
+                *output_info[k] << std::endl
+                                << "\t\tWARNING: Newton's method did not converge!"
+                                << " (V = " << V(i) << "[V])";
+            }
+        }
+    }
+    
+    // Timing.
+    high_resolution_clock::time_point finalTime =
+        high_resolution_clock::now();
+        
+    // Free up memory to avoid leaks.
+    delete quadRule;
+    quadRule = nullptr;
+    
+    for (Index k = 0; k < nBatch; ++k)
+    {
+        delete charge_fun[k];
+        charge_fun[k] = nullptr;
+    }
+    
+    for (Index k = 0; k < nBatch; ++k)
+    {
+        models[k].Phi_ = std::move (Phi[k]);
+        
+        print_done (*output_info[k]);
+        
+        *output_info[k] << "Total No. of Newton iterations: " << iterationsNo (k)
+                        << std::endl;
+                        
+        *output_info[k] << "Simulation took " << duration_cast<seconds>
+                        (finalTime - initTime).count()
+                        << " seconds (whole batch)." << std::endl;
+                        
+        // Post-processing and creation of output files.
+        models[k].write_output (config, input_experim, output_directory, output_plot_subdir,
+                                output_filenames[k], *output_info[k], x, Dens[k], models[k].Phi_, semicNodesNo,
+                                V, cTot.col (k));
+    }
+    
+    return;
+}
+
+VectorXr DosModel::build_mesh (const GetPot & config, Index & semicNodesNo) const
+{
+    // Node budget of each region.
+    const Real semicFraction = config ("Mesh/semicFraction", 0.6);
     
-    for (Index i = 0; i < eps.size(); ++i)
+    if (semicFraction <= 0.0 || semicFraction >= 1.0)
     {
-        if (xm (i) > 0.0)
-        {
-            eps (i) = params_.eps_ins_;
-        }
+        throw std::runtime_error ("ERROR: wrong variable \"semicFraction\" set in the configuration file (only values in (0, 1) allowed).");
     }
     
-    Bim1D bimSolver (x);
+    semicNodesNo = floor (semicFraction * params_.nNodes_);
+    Index insNodesNo = params_.nNodes_ - semicNodesNo;
     
-    bimSolver.assembleStiff (eps, VectorXr::Ones (params_.nNodes_));
+    VectorXr x = VectorXr::Zero (params_.nNodes_);     // The mesh.
     
-    {
-        VectorXr temp = VectorXr::Zero (xm.size());
-        
-        for (Index i = 0; i < temp.size(); ++i)
-        {
-            if (xm (i) < 0.0)
-            {
-                temp (i) = 1.0;
-            }
-        }
-        
-        bimSolver.assembleMass (temp, VectorXr::Ones (params_.nNodes_));
-    }
+    MeshGrading * semicGrading = build_grading (config, "Mesh/Semiconductor/");
+    MeshGrading *   insGrading = build_grading (config, "Mesh/Insulator/");
     
-    print_done (output_info);
+    VectorXr temp1 = semicGrading->apply (0, -params_.t_semic_,
+                                          semicNodesNo).reverse();
+    VectorXr temp2 = insGrading->apply (0, params_.t_ins_,
+                                        insNodesNo + 1);
+                                        
+    x << temp1, temp2.segment (1, temp2.size() - 1);
     
-    // Computing nodes and weights of quadrature.
-    output_info << "Computing nodes and weights of quadrature";
+    delete semicGrading;
+    delete   insGrading;
     
+    return x;
+}
+
+QuadratureRule * DosModel::build_quadrature (const GetPot & config,
+                                             const Index & nNodes)
+{
     QuadratureRule * quadRule = nullptr;
     
     {
-        QuadratureRuleFactory * quadRuleFactory;
+        std::string name;
         
-        Index rule = config ("QuadratureRule/rule", 1);
-        
-        switch (rule)
-        {
-            case 1:
-                output_info << " (Gauss-Hermite rule)";
-                quadRuleFactory = new GaussHermiteRuleFactory;
-                break;
-                
-            case 0:
-                output_info << " (Gauss-Laguerre rule)";
-                quadRuleFactory = new GaussLaguerreRuleFactory;
-                break;
-                
-            default:
-                throw std::runtime_error ("ERROR: wrong variable \"rule\" set in the configuration file (only 1 or 0 allowed).");
-                break;
-        }
+        QuadratureRuleFactory * quadRuleFactory =
+            QuadratureRuleRegistry::build (config ("QuadratureRule/rule", 1), config, name);
+            
+        quadRule = quadRuleFactory->BuildRule (nNodes);
         
-        quadRule = quadRuleFactory->BuildRule
-                   (config ("QuadratureRule/nNodes", 101));
-                   
         delete quadRuleFactory;
     }
     
-    output_info << " using " << quadRule->nNodes() << " nodes...";
-    
     try
     {
         quadRule->apply (config);
     }
     catch (const std::exception & genericException)
     {
+        delete quadRule;
         throw;
     }
     
-    print_done (output_info);
-    
-    // Constitutive relation.
-    output_info
-            << "Initializing constitutive relation for the Density of States";
-            
-    Charge * charge_fun = nullptr;
-    
+    return quadRule;
+}
+
+QuadratureRule * DosModel::build_quadrature (const GetPot & config,
+                                             std::ostream & output_info,
+                                             const std::vector<const DosModel *> & models)
+{
     {
-        ChargeFactory * chargeFactory;
-        
-        Index constitutive_relation = config ("DOS", 1);
-        
-        switch (constitutive_relation)
-        {
-            case 1:
-                output_info << " (Gaussian)";
-                chargeFactory = new GaussianChargeFactory;
-                break;
-                
-            case 0:
-                output_info << " (Exponential)";
-                chargeFactory = new ExponentialChargeFactory;
-                break;
-                
-            default:
-                throw std::runtime_error
-                ("ERROR: wrong variable \"DOS\" set in the configuration file (only 1 or 0 allowed).");
-                break;
-        }
+        std::string name;
         
-        charge_fun = chargeFactory->BuildCharge (params_, *quadRule);
+        delete QuadratureRuleRegistry::build (config ("QuadratureRule/rule", 1), config, name);
         
-        delete chargeFactory;
+        output_info << " (" << name << " rule)";
     }
     
-    output_info << "...";
-    print_done (output_info);
-    
-    // Initialize Newton solver for the non-linear Poisson equation.
-    Index maxIterationsNo = config ("NLP/maxIterationsNo", 100);
-    Real  tolerance       = config ("NLP/tolerance", 1.0e-4);
-    
-    NonLinearPoisson1D nlpSolver (params_, bimSolver, maxIterationsNo, tolerance);
+    const Index maxNodesNo = config ("QuadratureRule/nNodes", 101);
+    const Real  tolerance  = config ("QuadratureRule/Adaptive/tolerance", 0.0);
     
-    // Variables initialization.
-    output_info << "Initializing variables...";
+    if (tolerance <= 0.0 || models.empty())
+    {
+        QuadratureRule * quadRule = build_quadrature (config, maxNodesNo);
+        
+        output_info << " using " << quadRule->nNodes() << " nodes...";
+        
+        return quadRule;
+    }
     
-    MatrixXr Phi  = MatrixXr::Zero (x.size(), V.size());
-    MatrixXr Dens = MatrixXr::Zero (semicNodesNo, V.size());
+    // Adaptive order: the number of nodes is increased to the next order of the rule (doubled,
+    // or the next nested rule) until the charge and its derivative change by less than the tolerance,
+    // relative to their maximum over the sampled potentials.
+    const VectorXr phi = VectorXr::LinSpaced
+                         (config ("QuadratureRule/Adaptive/samplesNo", 401),
+                          config ("QuadratureRule/Adaptive/phiMin", -2.0),
+                          config ("QuadratureRule/Adaptive/phiMax", 2.0));
+                          
+    std::ostringstream trial_info;    // Discarded.
     
-    VectorXr PhiBcorr = VectorXr::Zero (V.size());
-    VectorXr cTot     = VectorXr::Zero (V.size());
-    VectorXr charge_n = VectorXr::Zero (V.size());
+    std::unique_ptr<QuadratureRule> quadRule
+    (build_quadrature (config, std::min ((Index) config ("QuadratureRule/Adaptive/minNodesNo", 5), maxNodesNo)));
     
-    print_done (output_info);
+    Real error = 0.0;
+    bool converged = false;
     
-    output_info
-            << "Running Newton solver for non-linear Poisson equation..."
-            << std::endl
-            << "\tMax No. of iterations set: "
-            << maxIterationsNo
-            << std::endl
-            << "\tTolerance set: "
-            << tolerance << std::endl;
-            
-    // Start simulation.
-    for (Index i = 0; i < V.size(); ++i)
+    while (quadRule->nNodes() < maxNodesNo)
     {
-        // Print current step number.
-        if (i == 0 || (i + 1) % 10 == 0 || i == V.size() - 1)
-            output_info << std::endl << "\tstep: "
-                        << (i + 1) << "/" << params_.nSteps_;
-                        
-        VectorXr phiOld = VectorXr::Zero (x.size());
+        std::unique_ptr<QuadratureRule> finerRule
+        (build_quadrature (config, std::min (quadRule->next_order(), maxNodesNo)));
         
-        if (i == 0)
-            phiOld =
-                -VectorXr::LinSpaced (phiOld.size(),
-                                      params_.Wf_ / Q - params_.Ea_ / Q,
-                                      params_.Wf_ / Q - params_.Ea_ / Q - V (i));
-        else
-            phiOld = Phi.col (i - 1) +
-                     VectorXr::LinSpaced (phiOld.size(), 0, V (i) - V (i - 1));
-                     
-        nlpSolver.apply (phiOld, *charge_fun);
+        if (finerRule->nNodes() <= quadRule->nNodes())    // No finer rule available.
+        {
+            break;
+        }
         
-        Phi.col (i) = nlpSolver.phi();
-        PhiBcorr(i) = nlpSolver.PhiBcorr();
-        cTot    (i) = nlpSolver.cTot();
+        error = 0.0;
         
-        VectorXr charge = charge_fun->charge (Phi.col(i).segment(0, semicNodesNo).array() + PhiBcorr(i));
-        Dens.col(i) = -charge / Q;
+        for (const DosModel * model : models)
+        {
+            std::unique_ptr<Charge> charge_fun (model->build_charge (config, *quadRule, trial_info));
+            std::unique_ptr<Charge> finer_fun (model->build_charge (config, *finerRule, trial_info));
+            
+            VectorXr charge = finer_fun->charge (phi);
+            VectorXr dcharge = finer_fun->dcharge (phi);
+            
+            error = std::max (error, (charge_fun->charge (phi) - charge).lpNorm<Infinity>() /
+                              charge.lpNorm<Infinity>());
+            error = std::max (error, (charge_fun->dcharge (phi) - dcharge).lpNorm<Infinity>() /
+                              dcharge.lpNorm<Infinity>());
+        }
         
-        charge_n(i) = numerics::trapz ((VectorXr) x.segment(0, semicNodesNo), charge);
-                             
-        if (nlpSolver.norm()(nlpSolver.norm().size() - 1) >= tolerance)
+        if (error <= tolerance)
         {
-            output_info << std::endl
-                        << "\t\tWARNING: Newton's method did not converge!"
-                        << " (V = " << V(i) << "[V])";
+            converged = true;
+            break;
         }
+        
+        quadRule = std::move (finerRule);
     }
     
-    print_done (output_info);
+    output_info << " using " << quadRule->nNodes() << " nodes (adaptive";
     
-    // Timing.
-    high_resolution_clock::time_point finalTime =
-        high_resolution_clock::now();
-    output_info << "Simulation took " << duration_cast<seconds>
-                (finalTime - initTime).count()
-                << " seconds." << std::endl;
-                
-    // Free up memory to avoid leaks.
-    delete quadRule;
-    quadRule = nullptr;
+    if (converged)
+    {
+        output_info << ", estimated error " << error;
+    }
+    else
+    {
+        output_info << ", maximum reached";
+    }
     
-    delete charge_fun;
-    charge_fun = nullptr;
+    output_info << ")...";
     
-    // Post-processing and creation of output files.
+    return quadRule.release();
+}
+
+Charge * DosModel::build_charge (const GetPot & config,
+                                 const QuadratureRule & quadRule,
+                                 std::ostream & output_info) const
+{
+    std::string name;
+    
+    ChargeFactory * chargeFactory = ChargeRegistry::build (config ("DOS", 1),
+                                    config, name);
+                                    
+    output_info << " (" << name << ")";
+    
+    Charge * charge_fun = nullptr;
+    
+    try
+    {
+        charge_fun = chargeFactory->BuildCharge (params_, quadRule);
+    }
+    catch (const std::exception & genericException)
+    {
+        delete chargeFactory;
+        throw;
+    }
+    
+    delete chargeFactory;
+    
+    return charge_fun;
+}
+
+void DosModel::write_output (const GetPot & config,
+                             const std::vector<std::string> & input_experim,
+                             const std::string & output_directory,
+                             const std::string & output_plot_subdir,
+                             const std::string & output_filename,
+                             std::ofstream & output_info,
+                             const VectorXr & x,
+                             const MatrixXr & Dens,
+                             const MatrixXr & Phi,
+                             const Index semicNodesNo,
+                             const VectorXr & V_simulated,
+                             const MatrixXr & C_simulated)
+{
     try
     {
         post_process (config, output_directory + output_filename,
-                      input_experim, output_info, output_CV,
+                      input_experim, output_info,
                       params_.A_semic_, params_.C_sb_,
-                      x, Dens, Phi, semicNodesNo, V, cTot);
+                      x, Dens, Phi, semicNodesNo, V_simulated, C_simulated);
     }
     catch (const std::exception & genericException)
     {
@@ -310,13 +1026,19 @@ void DosModel::simulate (const GetPot & config,
     output_info << "t_semic = " << params_.t_semic_ << " [m]" << std::endl;
     
     output_info.close();
-    output_CV.close();
     
-    // Create output Gnuplot files.
+    // Create output Gnuplot files, one for each set of experimental data.
     try
     {
-        save_plot (output_directory, output_plot_subdir, output_CV_filename,
-                   output_filename);
+        for (std::size_t k = 0; k < input_experim.size(); ++k)
+        {
+            const std::string suffix = (input_experim.size() == 1) ? "" :
+                                       "_" + std::to_string (k + 1);
+                                       
+            save_plot (output_directory, output_plot_subdir,
+                       output_filename + "_CV" + suffix + ".csv",
+                       output_filename + suffix, k);
+        }
     }
     catch (const std::exception & genericException)
     {
@@ -328,9 +1050,8 @@ void DosModel::simulate (const GetPot & config,
 
 void DosModel::post_process (const GetPot & config,
                              const std::string & output_filename,
-                             const std::string & input_experim,
+                             const std::vector<std::string> & input_experim,
                              std::ostream & output_info,
-                             std::ostream & output_CV,
                              const Real & A_semic,
                              const Real & C_sb,
                              const VectorXr & x,
@@ -338,7 +1059,7 @@ void DosModel::post_process (const GetPot & config,
                              const MatrixXr & Phi,
                              const Index semicNodesNo,
                              const VectorXr & V_simulated,
-                             const VectorXr & C_simulated)
+                             const MatrixXr & C_simulated)
 {
 
     VectorXr x_semic = static_cast<VectorXr> (x.segment (0,
@@ -346,126 +1067,135 @@ void DosModel::post_process (const GetPot & config,
     VectorXr dens =  static_cast<VectorXr> (Dens.col (Dens.cols() - 1));
     
     assert (x_semic.size() == dens.size());
-    assert (V_simulated.size() == C_simulated.size());
-    assert (Phi.rows() == Dens.rows());
+    assert (V_simulated.size() == C_simulated.rows());
+    assert (C_simulated.cols() == 1 || C_simulated.cols() == (Index) input_experim.size());
     assert (Phi.cols() == Dens.cols());
     
-    CsvParser parser_experim (input_experim, config ("skipHeaders",
-                              true));
-                              
-    VectorXr V_experim = parser_experim.importCol (1);
-    VectorXr C_experim = parser_experim.importCol (2);
+    // The simulated curve of the first set of experimental data is the reference one.
+    V_simulated_ = V_simulated;
+    C_simulated_ = C_simulated.col (0).array() * A_semic + C_sb;
     
-    assert (V_experim.size() == C_experim.size());
+    Real center_of_charge =                     // Center of charge.
+        numerics::trapz (x_semic.cwiseProduct (dens)) /
+        numerics::trapz (dens);
+        
+    Real cAccStar = C_simulated.col (0).maxCoeff();     // Simulated.
     
-    // Sorting "V_experim" and "C_experim". The order is established by "V_experim".
+    output_info << std::endl
+                << "Center of charge = "
+                << center_of_charge << " [m]" << std::endl
+                << "C_acc* = " << cAccStar << " [F]" << std::endl;
+                
+    V_shifts_ = VectorXr::Zero (input_experim.size());
+    errors_   = MatrixXr::Zero (input_experim.size(), 3);
+    
+    for (std::size_t k = 0; k < input_experim.size(); ++k)
     {
-        VectorXpair<Real> sort = numerics::sort_pair (V_experim);
-        VectorXr V_sort = VectorXr::Zero (V_experim.size());
-        VectorXr C_sort = VectorXr::Zero (C_experim.size());
+        VectorXr V_experim;
+        VectorXr C_experim;
         
-        for (Index i = 0; i < sort.size(); ++i)
+        import_experim (config, input_experim[k], V_experim, C_experim);
+        
+        VectorXr dC_dV_experim =
+            numerics::deriv (C_experim, V_experim);
+            
+        // Simulated curve of the current set.
+        VectorXr C_set = C_simulated.col (std::min (k, (std::size_t) C_simulated.cols() - 1)).array() * A_semic + C_sb;
+        
+        VectorXr dC_dV_simulated =
+            numerics::deriv (C_set, V_simulated);
+            
+        // Compute V_shift and errors.
+        errors_.row (k) = numerics::cv_errors (V_experim, C_experim, V_simulated,
+                                               C_set, V_shifts_ (k)).transpose();
+                                               
+        // Save for automatic fitting: the first set of experimental data is the reference one.
+        if (k == 0)
         {
-            V_sort (i) = V_experim (sort (i).second);
-            C_sort (i) = C_experim (sort (i).second);
+            V_shift_ = V_shifts_ (0);
+            
+            C_acc_experim_ = C_experim (C_experim.size() - 1);
+            
+            // Find the value in (V_simulated - V_shift) nearest to V_experim(end).
+            Index i = 0;
+            (V_simulated.array() - V_shift_ - V_experim (V_experim.size() -
+                    1)).abs().minCoeff (&i);
+                    
+            C_acc_simulated_ = C_set (i);
+            
+            C_dep_experim_ = C_experim (0);
         }
         
-        V_experim = V_sort;
-        C_experim = C_sort;
-    }
-    
-    VectorXr dC_dV_experim   =
-        numerics::deriv (C_experim, V_experim);
-    VectorXr dC_dV_simulated =
-        numerics::deriv (C_simulated.array() * A_semic + C_sb, V_simulated);
+        // Print to output.
+        output_info << std::endl
+                    << "Experimental data: " << input_experim[k] << std::endl
+                    << "V_shift = " << V_shifts_ (k) << " [V]" << std::endl
+                    << "Distance between experimental and simulated capacitance values:"
+                    << std::endl
+                    << "\tL2-distance = " << errors_ (k, 0) << std::endl
+                    << "\tH1-distance = " << errors_ (k, 1) << std::endl
+                    << "\tPeak-distance (on dC/dV) = " << errors_ (k, 2)
+                    << std::endl;
+                    
+        // Save CV data.
+        std::ofstream output_CV;
         
-    Real center_of_charge =                     // Center of charge.
-        numerics::trapz (x_semic.cwiseProduct (dens)) /
-        numerics::trapz (dens);
+        output_CV.open (output_filename + "_CV" +
+                        ((input_experim.size() == 1) ? "" : "_" + std::to_string (k + 1)) +
+                        ".csv", std::ios_base::out);
+                        
+        if (output_CV.bad())
+        {
+            throw std::ofstream::failure ("ERROR: output files cannot be opened or directory does not exist.");
+        }
         
-    Real cAccStar = C_simulated.maxCoeff();     // Simulated.
-    
-    // Compute V_shift.
-    {
-        Index j_e = 0;
-        dC_dV_experim.maxCoeff (&j_e);
+        output_CV.setf (std::ios_base::scientific);
+        output_CV.precision (std::numeric_limits<Real>::digits10);
         
-        Index j_s = 0;
-        dC_dV_simulated.maxCoeff (&j_s);
+        output_CV
+                << "V_experim [V], C_experim [F], dC/dV_experim [F/V], V_simulated [V], C_simulated [F], dC/dV_simulated [F/V]"
+                << std::endl;
+                
+        for (Index i = 0;
+                i < std::max (V_simulated.size(), V_experim.size());
+                ++i)
+        {
+            if (i < V_experim.size())
+                output_CV << V_experim (i) << ", "
+                          << C_experim (i)
+                          << ", " << dC_dV_experim (i) << ", ";
+            else
+                output_CV << ",,, ";
+                
+                
+            if (i < V_simulated.size())
+                output_CV << V_simulated (i) - V_shifts_ (k) << ", "
+                          << C_set (i) << ", "
+                          << dC_dV_simulated (i);
+                          
+            else
+                output_CV << ",,,";
+                
+            output_CV << std::endl;
+        }
         
-        V_shift_ = V_simulated (j_s) - V_experim (j_e);
+        output_CV.close();
     }
     
-    VectorXr     C_interp = numerics::interp1 (V_experim,     C_experim,
-                            V_simulated.array() - V_shift_);
-    VectorXr dC_dV_interp = numerics::interp1 (V_experim, dC_dV_experim,
-                            V_simulated.array() - V_shift_);
-                            
-    // Save for automatic fitting.
+    // Joint distances: root of the sum of squares over all the sets of experimental data.
+    error_L2_   = errors_.col (0).norm();
+    error_H1_   = errors_.col (1).norm();
+    error_Peak_ = errors_.col (2).norm();
+    
+    if (input_experim.size() > 1)
     {
-        C_acc_experim_ = C_experim (C_experim.size() - 1);
-        
-        // Find the value in (V_simulated - V_shift) nearest to V_experim(end).
-        Index i = 0;
-        (V_simulated.array() - V_shift_ - V_experim (V_experim.size() -
-                1)).abs().minCoeff (&i);
-                
-        C_acc_simulated_ = C_simulated (i) * A_semic + C_sb;
-        
-        C_dep_experim_ = C_experim (0);
-    }
-    
-    // Compute errors.
-    error_L2_ = std::sqrt (numerics::error_L2 (C_interp,
-                           C_simulated.array() * A_semic + C_sb,
-                           V_simulated.array() - V_shift_));
-    error_H1_ = std::sqrt (error_L2_ * error_L2_ +
-                           numerics::error_L2 (dC_dV_interp, dC_dV_simulated,
-                                   V_simulated.array() - V_shift_)
-                          );
-    error_Peak_ = std::abs (numerics::nonNaN (dC_dV_interp).maxCoeff() -
-                            numerics::nonNaN (dC_dV_simulated).maxCoeff());
-                            
-    // Print to output.
-    output_info << std::endl
-                << "V_shift = " << V_shift_ << " [V]" << std::endl
-                << "Center of charge = "
-                << center_of_charge << " [m]" << std::endl
-                << "C_acc* = " << cAccStar << " [F]" << std::endl
-                << std::endl
-                << "Distance between experimental and simulated capacitance values:"
-                << std::endl
-                << "\tL2-distance = " << error_L2_ << std::endl
-                << "\tH1-distance = " << error_H1_ << std::endl
-                << "\tPeak-distance (on dC/dV) = " << error_Peak_
-                << std::endl;
-                
-    output_CV
-            << "V_experim [V], C_experim [F], dC/dV_experim [F/V], V_simulated [V], C_simulated [F], dC/dV_simulated [F/V]"
-            << std::endl;
-            
-    // Save CV data.
-    for (Index i = 0;
-            i < std::max (V_simulated.size(), V_experim.size());
-            ++i)
-    {
-        if (i < V_experim.size())
-            output_CV << V_experim (i) << ", "
-                      << C_experim (i)
-                      << ", " << dC_dV_experim (i) << ", ";
-        else
-            output_CV << ",,, ";
-            
-            
-        if (i < V_simulated.size())
-            output_CV << V_simulated (i) - V_shift_ << ", "
-                      << C_simulated (i) * A_semic + C_sb << ", "
-                      << dC_dV_simulated (i);
-                      
-        else
-            output_CV << ",,,";
-            
-        output_CV << std::endl;
+        output_info << std::endl
+                    << "Joint distance over " << input_experim.size()
+                    << " sets of experimental data:" << std::endl
+                    << "\tL2-distance = " << error_L2_ << std::endl
+                    << "\tH1-distance = " << error_H1_ << std::endl
+                    << "\tPeak-distance (on dC/dV) = " << error_Peak_
+                    << std::endl;
     }
     
     // Store solutions.
@@ -493,10 +1223,86 @@ void DosModel::post_process (const GetPot & config,
     return;
 }
 
+MeshGrading * DosModel::build_grading (const GetPot & config,
+                                      const std::string & section)
+{
+    MeshGradingFactory * gradingFactory;
+    Real parameter = 0.0;
+    
+    Index grading = config ((section + "grading").c_str(), 0);
+    
+    switch (grading)
+    {
+        case 0:
+            gradingFactory = new UniformGradingFactory;
+            break;
+            
+        case 1:
+            gradingFactory = new GeometricGradingFactory;
+            parameter = config ((section + "ratio").c_str(), 1.05);
+            break;
+            
+        case 2:
+            gradingFactory = new TanhGradingFactory;
+            parameter = config ((section + "stretch").c_str(), 3.0);
+            break;
+            
+        default:
+            throw std::runtime_error ("ERROR: wrong variable \"grading\" set in the configuration file (only 0, 1 or 2 allowed).");
+            break;
+    }
+    
+    if ((grading == 1 && parameter < 1.0) || (grading == 2 && parameter <= 0.0))
+    {
+        delete gradingFactory;
+        
+        throw std::runtime_error ("ERROR: wrong variables \"ratio\" or \"stretch\" set in the configuration file (ratio >= 1 and stretch > 0 required).");
+    }
+    
+    MeshGrading * meshGrading = gradingFactory->BuildGrading (parameter);
+    
+    delete gradingFactory;
+    
+    return meshGrading;
+}
+
+void DosModel::import_experim (const GetPot & config,
+                               const std::string & input_experim,
+                               VectorXr & V_experim,
+                               VectorXr & C_experim)
+{
+    CsvParser parser_experim (input_experim, config ("skipHeaders",
+                              true));
+                              
+    V_experim = parser_experim.importCol (1);
+    C_experim = parser_experim.importCol (2);
+    
+    assert (V_experim.size() == C_experim.size());
+    
+    // Sorting "V_experim" and "C_experim". The order is established by "V_experim".
+    {
+        VectorXpair<Real> sort = numerics::sort_pair (V_experim);
+        VectorXr V_sort = VectorXr::Zero (V_experim.size());
+        VectorXr C_sort = VectorXr::Zero (C_experim.size());
+        
+        for (Index i = 0; i < sort.size(); ++i)
+        {
+            V_sort (i) = V_experim (sort (i).second);
+            C_sort (i) = C_experim (sort (i).second);
+        }
+        
+        V_experim = V_sort;
+        C_experim = C_sort;
+    }
+    
+    return;
+}
+
 void DosModel::save_plot (const std::string & output_directory,
                           const std::string & output_plot_subdir,
                           const std::string & csv_filename,
-                          const std::string & output_filename) const
+                          const std::string & output_filename,
+                          const Index & dataset) const
 {
     // Save script for later reuse.
     const std::string output_plot_filename = output_plot_subdir +
@@ -511,7 +1317,7 @@ void DosModel::save_plot (const std::string & output_directory,
         throw std::runtime_error ("ERROR: Gnuplot output file cannot be opened or directory does not exist.");
     }
     
-    gnuplot_commands ("../" + csv_filename, output_plot);
+    gnuplot_commands ("../" + csv_filename, output_plot, dataset);
     
     output_plot << std::endl;
     output_plot << "pause mouse;" << std::endl;
@@ -525,7 +1331,7 @@ void DosModel::save_plot (const std::string & output_directory,
                << std::endl
                << std::endl;
                
-    gnuplot_commands (output_directory + csv_filename, output_png);
+    gnuplot_commands (output_directory + csv_filename, output_png, dataset);
     
     output_png << std::endl
                << "set output;" << std::endl;
@@ -534,7 +1340,8 @@ void DosModel::save_plot (const std::string & output_directory,
 }
 
 void DosModel::gnuplot_commands (const std::string & csv_filename,
-                                 std::ostream & os) const
+                                 std::ostream & os,
+                                 const Index & dataset) const
 {
     os << "set datafile separator \",\";" << std::endl
        << "set format y \"%.2te%+03T\";" << std::endl
@@ -559,10 +1366,20 @@ void DosModel::gnuplot_commands (const std::string & csv_filename,
        << params_.shift_3_
        << "\\nN0_4=" << params_.N0_4_ << ", σ_4="
        << params_.sigma_4_ / KB_T << ", shift_4="
-       << params_.shift_4_
-       << "\\nN0_e=" << params_.N0_exp_ << ", λ_e="
+       << params_.shift_4_;
+       
+    for (std::size_t k = 0; k < params_.extraGaussians_.size(); ++k)
+    {
+        const Gaussian & gaussian = params_.extraGaussians_[k];
+        
+        os << "\\nN0_" << k + 5 << "=" << gaussian.N0 << ", σ_" << k + 5
+           << "=" << gaussian.sigma / KB_T << ", shift_" << k + 5 << "="
+           << gaussian.shift;
+    }
+    
+    os << "\\nN0_e=" << params_.N0_exp_ << ", λ_e="
        << params_.lambda_exp_ / KB_T
-       << "\\nV_{shift}=" << V_shift_ << ", nNodes="
+       << "\\nV_{shift}=" << V_shifts_ (dataset) << ", nNodes="
        << params_.nNodes_ << ", nSteps=" << params_.nSteps_
        << "\" font \", 10\";" << std::endl
        << "\tset xlabel \"V_{gate} - V_{shift} [V]\" offset 0, 0.75;"
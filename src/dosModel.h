@@ -17,20 +17,29 @@
 #ifndef DOSMODEL_H
 #define DOSMODEL_H
 
+#include "adaptivity.h"
 #include "charge.h"
 #include "csvParser.h"
 #include "factory.h"
+#include "mesh.h"
 #include "numerics.h"
 #include "paramList.h"
 #include "quadratureRule.h"
+#include "reducedOrder.h"
 #include "solvers.h"
 #include "typedefs.h"
 
 #include "gnuplot-iostream.h"
 
 #include <chrono>    // Timing.
+#include <fstream>
 #include <iomanip>    // setf and precision.
 #include <limits>    // NaN.
+#include <memory>    // std::unique_ptr, std::shared_ptr
+#include <sstream>    // std::ostringstream
+#include <string>
+#include <utility>    // std::move
+#include <vector>
 
 /**
  * @class DosModel
@@ -73,13 +82,55 @@ class DosModel
                   const std::string &,
                   const std::string &, const std::string &);
                   
+        /**
+         * The capacitance-voltage curve is simulated once and compared against each set
+         * of experimental data (e.g. measured at different frequencies): the distances
+         * stored are the root of the sum of the squared distances from each set.
+         * If the small-signal analysis is run at as many frequencies as the sets, each set
+         * is compared against the capacitance at its own frequency.
+         *
+         * @brief Perform the simulation, jointly fitting more sets of experimental data.
+         * @param[in] config             : the GetPot configuration object;
+         * @param[in] input_experim      : the files containing experimental data;
+         * @param[in] output_directory   : directory where to store output files;
+         * @param[in] output_plot_subdir : sub-directory where to store @ref Gnuplot files;
+         * @param[in] output_filename    : prefix for the output filename.
+         */
+        void
+        simulate (const GetPot &, const std::vector<std::string> &,
+                  const std::string &,
+                  const std::string &, const std::string &);
+                  
+        /**
+         * The models, which must share the mesh, the device geometry and the bias sweep (e.g. candidates
+         * differing only in @f$ \sigma @f$), are simulated in lockstep by a @ref BatchedNonLinearPoisson1D
+         * solver, the mesh, the system matrices and the quadrature rule being built only once. Each model
+         * writes its own output files, as if simulated alone.
+         *
+         * Models requiring a warm start or an early termination, an adaptive mesh or the reduced-order model
+         * are simulated one at a time: in the latter case, a model without a reduced basis uses the one of the
+         * previous model.
+         *
+         * @brief Perform the simulation of a batch of models.
+         * @param[in,out] models             : the models to simulate;
+         * @param[in]     config             : the GetPot configuration object;
+         * @param[in]     input_experim      : the files containing experimental data;
+         * @param[in]     output_directory   : directory where to store output files;
+         * @param[in]     output_plot_subdir : sub-directory where to store @ref Gnuplot files;
+         * @param[in]     output_filenames   : prefixes for the output filenames, one per model.
+         */
+        static void
+        simulate (std::vector<DosModel> &, const GetPot &,
+                  const std::vector<std::string> &,
+                  const std::string &, const std::string &,
+                  const std::vector<std::string> &);
+                  
         /**
          * @brief Perform post-processing.
          * @param[in]  config           : the GetPot configuration object;
          * @param[in]  output_filename  : prefix for the output filename;
-         * @param[in]  input_experim    : the file containing experimental data;
+         * @param[in]  input_experim    : the files containing experimental data;
          * @param[out] output_info      : output file containing infos about the simulation;
-         * @param[out] output_CV        : output file containing infos about capacitance-voltage data;
          * @param[in]  A_semic          : area of the semiconductor @f$ \left[ m^{-2} \right] @f$;
          * @param[in]  C_sb             : stray capacitance (see @ref ParamList) @f$ \left[ F \right] @f$;
          * @param[in]  x                : the mesh;
@@ -87,34 +138,39 @@ class DosModel
          * @param[in]  Phi              : LUMO;
          * @param[in]  semicNodesNo     : number of nodes in the semconductor region;
          * @param[in]  V_simulated      : simulated voltage values @f$ \left[ V \right] @f$;
-         * @param[in]  C_simulated      : simulated capacitance values @f$ \left[ F \right] @f$.
+         * @param[in]  C_simulated      : simulated capacitance values @f$ \left[ F \right] @f$, one column for each
+         *                                set of experimental data or a single column shared by all of them.
          */
         void
         post_process (const GetPot &, const std::string &,
-                      const std::string &, std::ostream &, std::ostream &,
+                      const std::vector<std::string> &, std::ostream &,
                       const Real &, const Real &, const VectorXr &, const MatrixXr &,
                       const MatrixXr &,
-                      const Index, const VectorXr &, const VectorXr &);
+                      const Index, const VectorXr &, const MatrixXr &);
                       
         /**
          * @brief Save the @ref Gnuplot output files.
          * @param[in] output_directory   : directory where to store output files;
          * @param[in] output_plot_subdir : sub-directory where to store @ref Gnuplot files;
          * @param[in] csv_filename       : .csv file to plot;
-         * @param[in] output_filename    : prefix for the output filename.
+         * @param[in] output_filename    : prefix for the output filename;
+         * @param[in] dataset            : index of the set of experimental data plotted.
          */
         void
         save_plot (const std::string &, const std::string &,
-                   const std::string &, const std::string &) const;
+                   const std::string &, const std::string &,
+                   const Index & = 0) const;
                    
         /**
          * @brief Defines commands to generate @ref Gnuplot output files.
          * @param[in]  csv_filename : .csv file to plot;
-         * @param[out] os           : output stream.
+         * @param[out] os           : output stream;
+         * @param[in]  dataset      : index of the set of experimental data plotted.
          */
         void
-        gnuplot_commands (const std::string &, std::ostream &) const;
-        
+        gnuplot_commands (const std::string &, std::ostream &,
+                          const Index & = 0) const;
+                          
         /**
          * @name Getter methods
          * @{
@@ -131,6 +187,12 @@ class DosModel
         inline const Real&
         error_Peak() const;
         
+        inline const MatrixXr&
+        errors() const;
+        
+        inline const VectorXr&
+        V_shifts() const;
+        
         inline const Real&
         C_acc_experim() const;
         
@@ -140,6 +202,21 @@ class DosModel
         inline const Real&
         C_dep_experim() const;
         
+        inline const MatrixXr&
+        Phi() const;
+        
+        inline const bool&
+        aborted() const;
+        
+        inline const VectorXr&
+        V_simulated() const;
+        
+        inline const VectorXr&
+        C_simulated() const;
+        
+        inline const std::shared_ptr<const ReducedPoissonBasis>&
+        reducedBasis() const;
+        
         /**
          * @}
          */
@@ -151,11 +228,139 @@ class DosModel
         inline void
         setSigma (const Real &);
         
+        /**
+         * @brief Set the initial guess for the potential at each bias step (warm start).
+         * @param[in] Phi_guess : a previously computed solution, one column per bias step
+         * (an empty matrix restores the default continuation from the analytic linear guess).
+         */
+        inline void
+        setInitialGuess (const MatrixXr &);
+        
+        /**
+         * @brief Load the initial guess for the potential from a @a _solution_phi.dat file.
+         * @param[in] filename : the binary file written by @ref post_process.
+         */
+        inline void
+        loadInitialGuess (const std::string &);
+        
+        /**
+         * The sweep is checked every 10 bias steps: if a lower bound of the distance from the
+         * experimental data (see @ref numerics::cv_errors_bound) exceeds the threshold, the simulation
+         * is aborted, no output but the info file is written and all the distances are set to infinity.
+         * The threshold is read while the simulation is running, so it can be tightened concurrently,
+         * provided that it is written inside the critical section named @a ErrorThreshold.
+         *
+         * @brief Enable the early termination of the simulation (not with a warm start).
+         * @param[in] threshold : pointer to the threshold (nullptr disables the early termination);
+         * @param[in] errorNorm : the distance to bound (0 = @f$ L^2 @f$, 1 = @f$ H^1 @f$, 2 = peak).
+         */
+        inline void
+        setErrorThreshold (const Real *, const unsigned &);
+        
+        /**
+         * If the reduced-order model is enabled (section @a ReducedOrder), the basis is used instead of
+         * building a new one from full-order snapshots, provided that it has been built on the same
+         * system matrices (i.e. the same mesh and device geometry) and on parameters within
+         * @a ReducedOrder/parameterTolerance (see @ref ReducedPoissonBasis::distance); e.g. the basis
+         * of a model can be passed to nearby parameter sets.
+         *
+         * @brief Set the reduced basis of the non-linear Poisson equation.
+         * @param[in] basis : the basis (nullptr to build a new one at the next simulation).
+         */
+        inline void
+        setReducedBasis (const std::shared_ptr<const ReducedPoissonBasis> &);
+        
         /**
          * @}
          */
         
+        /**
+         * @brief Import a set of experimental data, sorted by voltage.
+         * @param[in]  config        : the GetPot configuration object;
+         * @param[in]  input_experim : the file containing experimental data;
+         * @param[out] V_experim     : experimental voltage values @f$ \left[ V \right] @f$;
+         * @param[out] C_experim     : experimental capacitance values @f$ \left[ F \right] @f$.
+         */
+        static void
+        import_experim (const GetPot &, const std::string &,
+                        VectorXr &, VectorXr &);
+                        
     private:
+        /**
+         * @brief Build the grading of the mesh in a region.
+         * @param[in] config  : the GetPot configuration object;
+         * @param[in] section : the section of the configuration file, e.g. @a "Mesh/Insulator/".
+         * @returns a pointer to @ref MeshGrading (to be deleted by the caller).
+         */
+        static MeshGrading *
+        build_grading (const GetPot &, const std::string &);
+        
+        /**
+         * @brief Build the mesh, graded towards the semiconductor/insulator interface.
+         * @param[in]  config       : the GetPot configuration object;
+         * @param[out] semicNodesNo : number of nodes in the semiconductor region.
+         * @returns the mesh.
+         */
+        VectorXr
+        build_mesh (const GetPot &, Index &) const;
+        
+        /**
+         * @brief Build a quadrature rule and compute its nodes and weights.
+         * @param[in] config : the GetPot configuration object;
+         * @param[in] nNodes : the number of nodes.
+         * @returns a pointer to @ref QuadratureRule (to be deleted by the caller).
+         */
+        static QuadratureRule *
+        build_quadrature (const GetPot &, const Index &);
+        
+        /**
+         * If the variable @a QuadratureRule/Adaptive/tolerance is positive, the number of nodes is chosen as the
+         * smallest one, among the successive orders of the rule (see @ref QuadratureRule::next_order) starting from
+         * @a QuadratureRule/Adaptive/minNodesNo, for which moving to the next order changes the charge and its derivative of all the @a models by less than the tolerance (relative to their
+         * maximum), on potentials sampled in @f$ \left[ phiMin, phiMax \right] @f$. The number of nodes never
+         * exceeds @a QuadratureRule/nNodes, which is used as is otherwise.
+         *
+         * @brief Build the quadrature rule and compute its nodes and weights.
+         * @param[in]  config      : the GetPot configuration object;
+         * @param[out] output_info : output file containing infos about the simulation;
+         * @param[in]  models      : the models the rule is going to be used by.
+         * @returns a pointer to @ref QuadratureRule (to be deleted by the caller).
+         */
+        static QuadratureRule *
+        build_quadrature (const GetPot &, std::ostream &, const std::vector<const DosModel *> &);
+        
+        /**
+         * @brief Build the constitutive relation for the Density of States.
+         * @param[in]  config      : the GetPot configuration object;
+         * @param[in]  quadRule    : the quadrature rule;
+         * @param[out] output_info : output file containing infos about the simulation.
+         * @returns a pointer to @ref Charge (to be deleted by the caller).
+         */
+        Charge *
+        build_charge (const GetPot &, const QuadratureRule &, std::ostream &) const;
+        
+        /**
+         * @brief Perform post-processing, close the info file and save the @ref Gnuplot output files.
+         * @param[in]     config             : the GetPot configuration object;
+         * @param[in]     input_experim      : the files containing experimental data;
+         * @param[in]     output_directory   : directory where to store output files;
+         * @param[in]     output_plot_subdir : sub-directory where to store @ref Gnuplot files;
+         * @param[in]     output_filename    : prefix for the output filename;
+         * @param[in,out] output_info        : output file containing infos about the simulation;
+         * @param[in]     x                  : the mesh;
+         * @param[in]     Dens               : charge-carrier density @f$ \left[ m^{-3} \right] @f$;
+         * @param[in]     Phi                : LUMO;
+         * @param[in]     semicNodesNo       : number of nodes in the semconductor region;
+         * @param[in]     V_simulated        : simulated voltage values @f$ \left[ V \right] @f$;
+         * @param[in]     C_simulated        : simulated capacitance values @f$ \left[ F \right] @f$, one column for each
+         *                                      set of experimental data or a single column shared by all of them.
+         */
+        void
+        write_output (const GetPot &, const std::vector<std::string> &,
+                      const std::string &, const std::string &, const std::string &,
+                      std::ofstream &, const VectorXr &, const MatrixXr &, const MatrixXr &,
+                      const Index, const VectorXr &, const MatrixXr &);
+                      
         bool initialized_;    /**< @brief bool to determine if @ref DosModel @a param_ has been properly initialized. */
         
         ParamList params_;    /**< @brief The parameter list. */
@@ -166,9 +371,24 @@ class DosModel
         Real error_H1_;    /**< @brief @f$ H^1 @f$-distance between experimental and simulated capacitance values. */
         Real error_Peak_;    /**< @brief Distance between the ordinates in the peak of experimental and simulated derivative of capacitance values with respect to the gate potential. */
         
+        VectorXr V_shifts_;    /**< @brief Peak shift with respect to each set of experimental data @f$ [V] @f$. */
+        MatrixXr errors_  ;    /**< @brief @f$ L^2 @f$, @f$ H^1 @f$ and peak distances (columns) from each set of experimental data (rows). */
+        
         Real C_acc_experim_;    /**< @brief Experimental accumulation capacitance, used for automatic fitting @f$ [F] @f$. */
         Real C_acc_simulated_;    /**< @brief Simulated accumulation capacitance, used for automatic fitting @f$ [F] @f$. */
         Real C_dep_experim_;    /**< @brief Experimental depletion capacitance, used for automatic fitting @f$ [F] @f$. */
+        
+        MatrixXr Phi_guess_;    /**< @brief Initial guess for the potential at each bias step (empty if not set) @f$ [V] @f$. */
+        MatrixXr Phi_      ;    /**< @brief Potential computed by the last simulation, one column per bias step @f$ [V] @f$. */
+        
+        std::shared_ptr<const ReducedPoissonBasis> reducedBasis_;    /**< @brief Reduced basis used by the last simulation (nullptr if not set). */
+        
+        VectorXr V_simulated_;    /**< @brief Simulated voltage values @f$ [V] @f$. */
+        VectorXr C_simulated_;    /**< @brief Simulated capacitance values, including the stray capacitance @f$ [F] @f$. */
+        
+        const Real * errorThreshold_;    /**< @brief Threshold on the distance for the early termination (nullptr if disabled). */
+        unsigned     errorNorm_     ;    /**< @brief Distance compared with the threshold. */
+        bool         aborted_       ;    /**< @brief bool to determine if the last simulation has been aborted. */
 };
 
 // Implementations.
@@ -196,6 +416,18 @@ DosModel::error_Peak() const
     return error_Peak_;
 }
 
+inline const MatrixXr&
+DosModel::errors() const
+{
+    return errors_;
+}
+
+inline const VectorXr&
+DosModel::V_shifts() const
+{
+    return V_shifts_;
+}
+
 inline const Real&
 DosModel::C_acc_experim() const
 {
@@ -214,11 +446,67 @@ DosModel::C_dep_experim() const
     return C_dep_experim_;
 }
 
+inline const MatrixXr&
+DosModel::Phi() const
+{
+    return Phi_;
+}
+
+inline const bool&
+DosModel::aborted() const
+{
+    return aborted_;
+}
+
+inline const VectorXr&
+DosModel::V_simulated() const
+{
+    return V_simulated_;
+}
+
+inline const VectorXr&
+DosModel::C_simulated() const
+{
+    return C_simulated_;
+}
+
+inline const std::shared_ptr<const ReducedPoissonBasis>&
+DosModel::reducedBasis() const
+{
+    return reducedBasis_;
+}
+
 inline void
 DosModel::setSigma (const Real & sigma)
 {
-    assert( sigma >= 0.0 );
-    params_.sigma_ = sigma;
+    params_.setSigma (sigma);
+}
+
+inline void
+DosModel::setInitialGuess (const MatrixXr & Phi_guess)
+{
+    Phi_guess_ = Phi_guess;
+}
+
+inline void
+DosModel::setErrorThreshold (const Real * threshold, const unsigned & errorNorm)
+{
+    assert( errorNorm <= 2 );
+    
+    errorThreshold_ = threshold;
+    errorNorm_      = errorNorm;
+}
+
+inline void
+DosModel::setReducedBasis (const std::shared_ptr<const ReducedPoissonBasis> & basis)
+{
+    reducedBasis_ = basis;
+}
+
+inline void
+DosModel::loadInitialGuess (const std::string & filename)
+{
+    utility::read_binary (filename, Phi_guess_);
 }
 
 #endif /* DOSMODEL_H */
@@ -14,9 +14,20 @@
 
 #include "factory.h"
 
+GaussianChargeFactory::GaussianChargeFactory(const Real & tolerance, const bool & mixedPrecision)
+    : tolerance_(tolerance), mixedPrecision_(mixedPrecision) {}
+    
 Charge * GaussianChargeFactory::BuildCharge(const ParamList & params, const QuadratureRule & rule)
 {
-    return new GaussianCharge(params, rule);
+    return new GaussianCharge(params, rule, tolerance_, mixedPrecision_);
+}
+
+GaussFermiChargeFactory::GaussFermiChargeFactory(const Real & tolerance)
+    : tolerance_(tolerance) {}
+    
+Charge * GaussFermiChargeFactory::BuildCharge(const ParamList & params, const QuadratureRule & rule)
+{
+    return new GaussFermiCharge(params, rule, tolerance_);
 }
 
 Charge * ExponentialChargeFactory::BuildCharge(const ParamList & params, const QuadratureRule & rule)
@@ -24,6 +35,128 @@ Charge * ExponentialChargeFactory::BuildCharge(const ParamList & params, const Q
     return new ExponentialCharge(params, rule);
 }
 
+std::map<std::pair<std::string, bool>, std::shared_ptr<const TabulatedChargeFactory::Table> > TabulatedChargeFactory::tables_;
+
+TabulatedChargeFactory::TabulatedChargeFactory(const std::string & filename, const bool & skipHeaders)
+{
+    const std::pair<std::string, bool> key(filename, skipHeaders);
+    
+    #pragma omp critical (TabulatedChargeFactory)
+    {
+        auto it = tables_.find(key);
+        
+        if ( it != tables_.end() )
+        {
+            table_ = it->second;
+        }
+    }
+    
+    if ( table_ == nullptr )
+    {
+        // Parsed outside the critical section, since it may throw.
+        table_ = read(filename, skipHeaders);
+        
+        #pragma omp critical (TabulatedChargeFactory)
+        tables_[key] = table_;
+    }
+}
+
+Charge * TabulatedChargeFactory::BuildCharge(const ParamList & params, const QuadratureRule & rule)
+{
+    return new TabulatedCharge(params, rule, table_->energies, table_->dos);
+}
+
+std::shared_ptr<const TabulatedChargeFactory::Table> TabulatedChargeFactory::read(const std::string & filename, const bool & skipHeaders)
+{
+    CsvParser parser(filename, skipHeaders);
+    
+    if ( parser.nCols() < 2 )
+    {
+        throw std::runtime_error("ERROR: wrong table \"" + filename + "\" for the Density of States (two columns required).");
+    }
+    
+    std::shared_ptr<Table> table = std::make_shared<Table>();
+    
+    table->energies = parser.importCol(1);
+    table->dos      = parser.importCol(2);
+    
+    const VectorXr & energies = table->energies;
+    
+    if ( energies.size() < 2 || ( table->dos.array() < 0.0 ).any() )
+    {
+        throw std::runtime_error("ERROR: wrong table \"" + filename + "\" for the Density of States (at least two rows and non-negative values required).");
+    }
+    
+    for ( Index k = 0; k < energies.size() - 1; ++k )
+    {
+        if ( energies(k + 1) <= energies(k) )
+        {
+            throw std::runtime_error("ERROR: wrong table \"" + filename + "\" for the Density of States (strictly increasing energies required).");
+        }
+    }
+    
+    return table;
+}
+
+std::map<Index, ChargeRegistry::Entry> ChargeRegistry::entries_ =
+{
+    {0, {"Exponential", [] (const GetPot &) -> ChargeFactory * { return new ExponentialChargeFactory; }}},
+    {
+        1, {"Gaussian", [] (const GetPot & config) -> ChargeFactory *
+            {
+                return new GaussianChargeFactory(config("QuadratureRule/asymptoticTolerance", 1.0e-10),
+                                                 config("QuadratureRule/mixedPrecision", false));
+            }
+        }
+    },
+    {
+        2, {"Tabulated", [] (const GetPot & config) -> ChargeFactory *
+            {
+                return new TabulatedChargeFactory(config("TabulatedDOS/filename", "dos.csv"),
+                                                  config("TabulatedDOS/skipHeaders", true));
+            }
+        }
+    },
+    {
+        3, {"Gauss-Fermi", [] (const GetPot & config) -> ChargeFactory *
+            {
+                return new GaussFermiChargeFactory(config("QuadratureRule/asymptoticTolerance", 1.0e-10));
+            }
+        }
+    }
+};
+
+void ChargeRegistry::add(const Index & id, const std::string & name, const Builder & builder)
+{
+    assert( builder );
+    
+    #pragma omp critical (ChargeRegistry)
+    entries_[id] = {name, builder};
+}
+
+ChargeFactory * ChargeRegistry::build(const Index & id, const GetPot & config, std::string & name)
+{
+    Builder builder;
+    
+    #pragma omp critical (ChargeRegistry)
+    {
+        auto it = entries_.find(id);
+        
+        if ( it != entries_.end() )
+        {
+            name    = it->second.name;
+            builder = it->second.builder;
+        }
+    }
+    
+    if ( !builder )
+    {
+        throw std::runtime_error("ERROR: wrong variable \"DOS\" set in the configuration file (no such constitutive relation registered).");
+    }
+    
+    return builder(config);
+}
+
 QuadratureRule * GaussHermiteRuleFactory::BuildRule(const Index & nNodes)
 {
     return new GaussHermiteRule(nNodes);
@@ -33,3 +166,121 @@ QuadratureRule * GaussLaguerreRuleFactory::BuildRule(const Index & nNodes)
 {
     return new GaussLaguerreRule(nNodes);
 }
+
+QuadratureRule * GenzKeisterRuleFactory::BuildRule(const Index & nNodes)
+{
+    return new GenzKeisterRule(nNodes);
+}
+
+ClenshawCurtisRuleFactory::ClenshawCurtisRuleFactory(const Real & halfWidth)
+    : halfWidth_(halfWidth) {}
+    
+QuadratureRule * ClenshawCurtisRuleFactory::BuildRule(const Index & nNodes)
+{
+    return new ClenshawCurtisRule(nNodes, halfWidth_);
+}
+
+Fejer2RuleFactory::Fejer2RuleFactory(const Real & halfWidth)
+    : halfWidth_(halfWidth) {}
+    
+QuadratureRule * Fejer2RuleFactory::BuildRule(const Index & nNodes)
+{
+    return new Fejer2Rule(nNodes, halfWidth_);
+}
+
+GaussPattersonRuleFactory::GaussPattersonRuleFactory(const Real & halfWidth)
+    : halfWidth_(halfWidth) {}
+    
+QuadratureRule * GaussPattersonRuleFactory::BuildRule(const Index & nNodes)
+{
+    return new GaussPattersonRule(nNodes, halfWidth_);
+}
+
+GaussLegendreRuleFactory::GaussLegendreRuleFactory(const Real & halfWidth)
+    : halfWidth_(halfWidth) {}
+    
+QuadratureRule * GaussLegendreRuleFactory::BuildRule(const Index & nNodes)
+{
+    return new GaussLegendreRule(nNodes, halfWidth_);
+}
+
+std::map<Index, QuadratureRuleRegistry::Entry> QuadratureRuleRegistry::entries_ =
+{
+    {0, {"Gauss-Laguerre", [] (const GetPot &) -> QuadratureRuleFactory * { return new GaussLaguerreRuleFactory; }}},
+    {1, {"Gauss-Hermite", [] (const GetPot &) -> QuadratureRuleFactory * { return new GaussHermiteRuleFactory; }}},
+    {2, {"Genz-Keister", [] (const GetPot &) -> QuadratureRuleFactory * { return new GenzKeisterRuleFactory; }}},
+    {
+        3, {"Clenshaw-Curtis", [] (const GetPot & config) -> QuadratureRuleFactory *
+            {
+                return new ClenshawCurtisRuleFactory(config("QuadratureRule/halfWidth", 6.0));
+            }
+        }
+    },
+    {
+        4, {"Fejer (second kind)", [] (const GetPot & config) -> QuadratureRuleFactory *
+            {
+                return new Fejer2RuleFactory(config("QuadratureRule/halfWidth", 6.0));
+            }
+        }
+    },
+    {
+        5, {"Gauss-Patterson", [] (const GetPot & config) -> QuadratureRuleFactory *
+            {
+                return new GaussPattersonRuleFactory(config("QuadratureRule/halfWidth", 6.0));
+            }
+        }
+    },
+    {
+        6, {"Gauss-Legendre", [] (const GetPot & config) -> QuadratureRuleFactory *
+            {
+                return new GaussLegendreRuleFactory(config("QuadratureRule/halfWidth", 6.0));
+            }
+        }
+    }
+};
+
+void QuadratureRuleRegistry::add(const Index & id, const std::string & name, const Builder & builder)
+{
+    assert( builder );
+    
+    #pragma omp critical (QuadratureRuleRegistry)
+    entries_[id] = {name, builder};
+}
+
+QuadratureRuleFactory * QuadratureRuleRegistry::build(const Index & id, const GetPot & config, std::string & name)
+{
+    Builder builder;
+    
+    #pragma omp critical (QuadratureRuleRegistry)
+    {
+        auto it = entries_.find(id);
+        
+        if ( it != entries_.end() )
+        {
+            name    = it->second.name;
+            builder = it->second.builder;
+        }
+    }
+    
+    if ( !builder )
+    {
+        throw std::runtime_error("ERROR: wrong variable \"rule\" set in the configuration file (no such quadrature rule registered).");
+    }
+    
+    return builder(config);
+}
+
+MeshGrading * UniformGradingFactory::BuildGrading(const Real &)
+{
+    return new UniformGrading;
+}
+
+MeshGrading * GeometricGradingFactory::BuildGrading(const Real & parameter)
+{
+    return new GeometricGrading(parameter);
+}
+
+MeshGrading * TanhGradingFactory::BuildGrading(const Real & parameter)
+{
+    return new TanhGrading(parameter);
+}
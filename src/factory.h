@@ -18,9 +18,17 @@
 #define FACTORY_H
 
 #include "charge.h"
+#include "csvParser.h"
+#include "mesh.h"
 #include "paramList.h"
 #include "quadratureRule.h"
 
+#include <functional>    // std::function
+#include <map>
+#include <memory>    // std::shared_ptr
+#include <string>
+#include <utility>    // std::pair
+
 /**
  * @class ChargeFactory
  *
@@ -58,9 +66,11 @@ class GaussianChargeFactory : public ChargeFactory
 {
     public:
         /**
-         * @brief Default constructor (defaulted).
+         * @brief Constructor.
+         * @param[in] tolerance      : relative tolerance of the closed forms of @ref GaussianCharge;
+         * @param[in] mixedPrecision : whether to evaluate the derivative for the Newton Jacobians in single precision.
          */
-        GaussianChargeFactory() = default;
+        GaussianChargeFactory(const Real & = 0.0, const bool & = false);
         /**
          * @brief Destructor (defaulted).
          */
@@ -73,6 +83,41 @@ class GaussianChargeFactory : public ChargeFactory
          * @returns a pointer to @ref GaussianCharge.
          */
         virtual Charge * BuildCharge(const ParamList &, const QuadratureRule &) override;
+        
+    private:
+        Real tolerance_     ;    /**< @brief Relative tolerance of the closed forms. */
+        bool mixedPrecision_;    /**< @brief Whether to evaluate the derivative for the Newton Jacobians in single precision. */
+};
+
+/**
+ * @class GaussFermiChargeFactory
+ *
+ * @brief Concrete factory to handle a multiple gaussians DOS constitutive relation, evaluated by interpolation.
+ *
+ */
+class GaussFermiChargeFactory : public ChargeFactory
+{
+    public:
+        /**
+         * @brief Constructor.
+         * @param[in] tolerance : relative tolerance of the closed forms of @ref GaussFermiCharge.
+         */
+        GaussFermiChargeFactory(const Real & = 0.0);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~GaussFermiChargeFactory() = default;
+        
+        /**
+         * @brief Factory method to build a concrete @ref Charge object.
+         * @param[in] params : a list of simulation parameters;
+         * @param[in] rule   : a quadrature rule.
+         * @returns a pointer to @ref GaussFermiCharge.
+         */
+        virtual Charge * BuildCharge(const ParamList &, const QuadratureRule &) override;
+        
+    private:
+        Real tolerance_;    /**< @brief Relative tolerance of the closed forms. */
 };
 
 /**
@@ -102,6 +147,126 @@ class ExponentialChargeFactory : public ChargeFactory
         virtual Charge * BuildCharge(const ParamList &, const QuadratureRule &) override;
 };
 
+/**
+ * @class TabulatedChargeFactory
+ *
+ * The table is read from a .csv file, whose first two columns contain the energies @f$ \left[ eV \right] @f$,
+ * strictly increasing, and the Density of States @f$ \left[ m^{-3} \cdot eV^{-1} \right] @f$.
+ * The file is parsed and checked once, by the first factory built on it (e.g. by the first simulation of a fit):
+ * the table is kept and shared by the following factories and by all the charges built. Access is thread-safe.
+ *
+ * @brief Concrete factory to handle a tabulated DOS constitutive relation.
+ *
+ */
+class TabulatedChargeFactory : public ChargeFactory
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the table).
+         */
+        TabulatedChargeFactory() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] filename    : the .csv file containing the table;
+         * @param[in] skipHeaders : whether the first row of the file contains headers.
+         */
+        TabulatedChargeFactory(const std::string &, const bool & = true);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~TabulatedChargeFactory() = default;
+        
+        /**
+         * @brief Factory method to build a concrete @ref Charge object.
+         * @param[in] params : a list of simulation parameters;
+         * @param[in] rule   : a quadrature rule.
+         * @returns a pointer to @ref TabulatedCharge.
+         */
+        virtual Charge * BuildCharge(const ParamList &, const QuadratureRule &) override;
+        
+    private:
+        /**
+         * @brief Struct holding a parsed table.
+         */
+        struct Table
+        {
+            VectorXr energies;    /**< @brief The tabulated energies @f$ \left[ eV \right] @f$. */
+            VectorXr dos     ;    /**< @brief The tabulated Density of States @f$ \left[ m^{-3} \cdot eV^{-1} \right] @f$. */
+        };
+        
+        /**
+         * @brief Parse and check a table.
+         * @param[in] filename    : the .csv file containing the table;
+         * @param[in] skipHeaders : whether the first row of the file contains headers.
+         * @returns a shared pointer to the table.
+         */
+        static std::shared_ptr<const Table> read(const std::string &, const bool &);
+        
+        std::shared_ptr<const Table> table_;    /**< @brief The table. */
+        
+        static std::map<std::pair<std::string, bool>, std::shared_ptr<const Table> > tables_;    /**< @brief The tables already parsed, by file and headers flag. */
+};
+
+/**
+ * @class ChargeRegistry
+ *
+ * Each constitutive relation is identified by the value of the variable @a DOS in the configuration file,
+ * and registered with a name and a function building its factory from the configuration file.
+ * The built-in relations are:
+ * - 0 = single exponential (@ref ExponentialChargeFactory);
+ * - 1 = multiple gaussians (@ref GaussianChargeFactory);
+ * - 2 = tabulated (@ref TabulatedChargeFactory, section @a TabulatedDOS);
+ * - 3 = multiple gaussians, interpolated Gauss-Fermi integral (@ref GaussFermiChargeFactory).
+ *
+ * Further relations can be registered before the simulations start, with no change to @ref DosModel.
+ * Access is thread-safe.
+ *
+ * @brief Class providing a registry of the constitutive relations for the Density of States.
+ *
+ */
+class ChargeRegistry
+{
+    public:
+        /**
+         * @brief Typedef for the functions building a factory from the configuration file.
+         */
+        typedef std::function<ChargeFactory * (const GetPot &)> Builder;
+        
+        /**
+         * @brief Default constructor (deleted since the class only provides static methods).
+         */
+        ChargeRegistry() = delete;
+        
+        /**
+         * @brief Register a constitutive relation, replacing any other one with the same identifier.
+         * @param[in] id      : the identifier, i.e. the value of the variable @a DOS;
+         * @param[in] name    : the name of the relation;
+         * @param[in] builder : the function building its factory.
+         */
+        static void add(const Index &, const std::string &, const Builder &);
+        
+        /**
+         * @brief Build the factory of a registered constitutive relation.
+         * @param[in]  id     : the identifier, i.e. the value of the variable @a DOS;
+         * @param[in]  config : the GetPot configuration object;
+         * @param[out] name   : the name of the relation.
+         * @returns a pointer to @ref ChargeFactory, to be deleted by the caller.
+         */
+        static ChargeFactory * build(const Index &, const GetPot &, std::string &);
+        
+    private:
+        /**
+         * @brief Struct holding a registered constitutive relation.
+         */
+        struct Entry
+        {
+            std::string name   ;    /**< @brief The name of the relation. */
+            Builder     builder;    /**< @brief The function building its factory. */
+        };
+        
+        static std::map<Index, Entry> entries_;    /**< @brief The registered relations, by identifier. */
+};
+
 /**
  * @class QuadratureRuleFactory
  *
@@ -180,4 +345,333 @@ class GaussLaguerreRuleFactory : public QuadratureRuleFactory
         virtual QuadratureRule * BuildRule(const Index &) override;
 };
 
+/**
+ * @class GenzKeisterRuleFactory
+ *
+ * @brief Concrete factory to handle a Genz-Keister quadrature rule.
+ *
+ */
+class GenzKeisterRuleFactory : public QuadratureRuleFactory
+{
+    public:
+        /**
+         * @brief Default constructor (defaulted).
+         */
+        GenzKeisterRuleFactory() = default;
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~GenzKeisterRuleFactory() = default;
+        
+        /**
+         * @brief Factory method to build a concrete @ref QuadratureRule object.
+         * @param[in] nNodes : the number of nodes to be used for the quadrature rule.
+         * @returns a pointer to @ref GenzKeisterRule.
+         */
+        virtual QuadratureRule * BuildRule(const Index &) override;
+};
+
+/**
+ * @class ClenshawCurtisRuleFactory
+ *
+ * @brief Concrete factory to handle a Clenshaw-Curtis rule on the truncated gaussian weight.
+ *
+ */
+class ClenshawCurtisRuleFactory : public QuadratureRuleFactory
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the half-width).
+         */
+        ClenshawCurtisRuleFactory() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] halfWidth : the half-width of the integration interval.
+         */
+        ClenshawCurtisRuleFactory(const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~ClenshawCurtisRuleFactory() = default;
+        
+        /**
+         * @brief Factory method to build a concrete @ref QuadratureRule object.
+         * @param[in] nNodes : the number of nodes to be used for the quadrature rule.
+         * @returns a pointer to @ref ClenshawCurtisRule.
+         */
+        virtual QuadratureRule * BuildRule(const Index &) override;
+        
+    private:
+        Real halfWidth_;    /**< @brief Half-width of the integration interval. */
+};
+
+/**
+ * @class Fejer2RuleFactory
+ *
+ * @brief Concrete factory to handle a Fejer (second kind) rule on the truncated gaussian weight.
+ *
+ */
+class Fejer2RuleFactory : public QuadratureRuleFactory
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the half-width).
+         */
+        Fejer2RuleFactory() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] halfWidth : the half-width of the integration interval.
+         */
+        Fejer2RuleFactory(const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~Fejer2RuleFactory() = default;
+        
+        /**
+         * @brief Factory method to build a concrete @ref QuadratureRule object.
+         * @param[in] nNodes : the number of nodes to be used for the quadrature rule.
+         * @returns a pointer to @ref Fejer2Rule.
+         */
+        virtual QuadratureRule * BuildRule(const Index &) override;
+        
+    private:
+        Real halfWidth_;    /**< @brief Half-width of the integration interval. */
+};
+
+/**
+ * @class GaussPattersonRuleFactory
+ *
+ * @brief Concrete factory to handle a Gauss-Patterson rule on the truncated gaussian weight.
+ *
+ */
+class GaussPattersonRuleFactory : public QuadratureRuleFactory
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the half-width).
+         */
+        GaussPattersonRuleFactory() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] halfWidth : the half-width of the integration interval.
+         */
+        GaussPattersonRuleFactory(const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~GaussPattersonRuleFactory() = default;
+        
+        /**
+         * @brief Factory method to build a concrete @ref QuadratureRule object.
+         * @param[in] nNodes : the number of nodes to be used for the quadrature rule.
+         * @returns a pointer to @ref GaussPattersonRule.
+         */
+        virtual QuadratureRule * BuildRule(const Index &) override;
+        
+    private:
+        Real halfWidth_;    /**< @brief Half-width of the integration interval. */
+};
+
+/**
+ * @class GaussLegendreRuleFactory
+ *
+ * @brief Concrete factory to handle a Gauss-Legendre rule on the truncated gaussian weight.
+ *
+ */
+class GaussLegendreRuleFactory : public QuadratureRuleFactory
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the half-width).
+         */
+        GaussLegendreRuleFactory() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] halfWidth : the half-width of the integration interval.
+         */
+        GaussLegendreRuleFactory(const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~GaussLegendreRuleFactory() = default;
+        
+        /**
+         * @brief Factory method to build a concrete @ref QuadratureRule object.
+         * @param[in] nNodes : the number of nodes to be used for the quadrature rule.
+         * @returns a pointer to @ref GaussLegendreRule.
+         */
+        virtual QuadratureRule * BuildRule(const Index &) override;
+        
+    private:
+        Real halfWidth_;    /**< @brief Half-width of the integration interval. */
+};
+
+/**
+ * @class QuadratureRuleRegistry
+ *
+ * Each quadrature rule is identified by the value of the variable @a QuadratureRule/rule in the configuration file,
+ * and registered with a name and a function building its factory from the configuration file.
+ * The built-in rules are:
+ * - 0 = Gauss-Laguerre (@ref GaussLaguerreRuleFactory, exponential weight);
+ * - 1 = Gauss-Hermite (@ref GaussHermiteRuleFactory, gaussian weight);
+ * - 2 = Genz-Keister (@ref GenzKeisterRuleFactory, gaussian weight, nested);
+ * - 3 = Clenshaw-Curtis (@ref ClenshawCurtisRuleFactory, truncated gaussian weight, nested);
+ * - 4 = Fejer of the second kind (@ref Fejer2RuleFactory, truncated gaussian weight, nested);
+ * - 5 = Gauss-Patterson (@ref GaussPattersonRuleFactory, truncated gaussian weight, nested);
+ * - 6 = Gauss-Legendre (@ref GaussLegendreRuleFactory, truncated gaussian weight).
+ *
+ * Further rules can be registered before the simulations start, with no change to @ref DosModel.
+ * Access is thread-safe.
+ *
+ * @brief Class providing a registry of the quadrature rules.
+ *
+ */
+class QuadratureRuleRegistry
+{
+    public:
+        /**
+         * @brief Typedef for the functions building a factory from the configuration file.
+         */
+        typedef std::function<QuadratureRuleFactory * (const GetPot &)> Builder;
+        
+        /**
+         * @brief Default constructor (deleted since the class only provides static methods).
+         */
+        QuadratureRuleRegistry() = delete;
+        
+        /**
+         * @brief Register a quadrature rule, replacing any other one with the same identifier.
+         * @param[in] id      : the identifier, i.e. the value of the variable @a QuadratureRule/rule;
+         * @param[in] name    : the name of the rule;
+         * @param[in] builder : the function building its factory.
+         */
+        static void add(const Index &, const std::string &, const Builder &);
+        
+        /**
+         * @brief Build the factory of a registered quadrature rule.
+         * @param[in]  id     : the identifier, i.e. the value of the variable @a QuadratureRule/rule;
+         * @param[in]  config : the GetPot configuration object;
+         * @param[out] name   : the name of the rule.
+         * @returns a pointer to @ref QuadratureRuleFactory, to be deleted by the caller.
+         */
+        static QuadratureRuleFactory * build(const Index &, const GetPot &, std::string &);
+        
+    private:
+        /**
+         * @brief Struct holding a registered quadrature rule.
+         */
+        struct Entry
+        {
+            std::string name   ;    /**< @brief The name of the rule. */
+            Builder     builder;    /**< @brief The function building its factory. */
+        };
+        
+        static std::map<Index, Entry> entries_;    /**< @brief The registered rules, by identifier. */
+};
+
+/**
+ * @class MeshGradingFactory
+ *
+ * @brief Abstract factory to handle the grading of a mesh.
+ *
+ */
+class MeshGradingFactory
+{
+    public:
+        /**
+         * @brief Default constructor (defaulted).
+         */
+        MeshGradingFactory() = default;
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~MeshGradingFactory() = default;
+        
+        /**
+         * @brief Factory method to build an abstract @ref MeshGrading object.
+         * @param[in] parameter : the grading parameter (ignored by a uniform grading).
+         * @returns a pointer to @ref MeshGrading.
+         */
+        virtual MeshGrading * BuildGrading(const Real & parameter) = 0;
+};
+
+/**
+ * @class UniformGradingFactory
+ *
+ * @brief Concrete factory to handle a uniform mesh.
+ *
+ */
+class UniformGradingFactory : public MeshGradingFactory
+{
+    public:
+        /**
+         * @brief Default constructor (defaulted).
+         */
+        UniformGradingFactory() = default;
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~UniformGradingFactory() = default;
+        
+        /**
+         * @brief Factory method to build a concrete @ref MeshGrading object.
+         * @param[in] parameter : ignored.
+         * @returns a pointer to @ref UniformGrading.
+         */
+        virtual MeshGrading * BuildGrading(const Real &) override;
+};
+
+/**
+ * @class GeometricGradingFactory
+ *
+ * @brief Concrete factory to handle a geometrically graded mesh.
+ *
+ */
+class GeometricGradingFactory : public MeshGradingFactory
+{
+    public:
+        /**
+         * @brief Default constructor (defaulted).
+         */
+        GeometricGradingFactory() = default;
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~GeometricGradingFactory() = default;
+        
+        /**
+         * @brief Factory method to build a concrete @ref MeshGrading object.
+         * @param[in] parameter : the ratio between the sizes of two consecutive elements.
+         * @returns a pointer to @ref GeometricGrading.
+         */
+        virtual MeshGrading * BuildGrading(const Real &) override;
+};
+
+/**
+ * @class TanhGradingFactory
+ *
+ * @brief Concrete factory to handle a hyperbolic tangent graded mesh.
+ *
+ */
+class TanhGradingFactory : public MeshGradingFactory
+{
+    public:
+        /**
+         * @brief Default constructor (defaulted).
+         */
+        TanhGradingFactory() = default;
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~TanhGradingFactory() = default;
+        
+        /**
+         * @brief Factory method to build a concrete @ref MeshGrading object.
+         * @param[in] parameter : the stretching parameter.
+         * @returns a pointer to @ref TanhGrading.
+         */
+        virtual MeshGrading * BuildGrading(const Real &) override;
+};
+
 #endif /* FACTORY_H */
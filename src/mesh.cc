@@ -0,0 +1,87 @@
+/* C++11 */
+
+/**
+ * @file   mesh.cc
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ */
+
+#include "mesh.h"
+
+VectorXr MeshGrading::apply(const Real & x0, const Real & x1, const Index & nNodes) const
+{
+    assert( nNodes >= 2 );
+    
+    VectorXr x = x0 + (x1 - x0) * distribution(nNodes).array();
+    
+    // Exact end-points.
+    x(0)          = x0;
+    x(nNodes - 1) = x1;
+    
+    return x;
+}
+
+VectorXr UniformGrading::apply(const Real & x0, const Real & x1, const Index & nNodes) const
+{
+    assert( nNodes >= 2 );
+    
+    // Always spaced from the lower end-point, as the original two-segment mesh.
+    if ( x1 < x0 )
+    {
+        return VectorXr::LinSpaced(nNodes, x1, x0).reverse();
+    }
+    
+    return VectorXr::LinSpaced(nNodes, x0, x1);
+}
+
+VectorXr UniformGrading::distribution(const Index & nNodes) const
+{
+    return VectorXr::LinSpaced(nNodes, 0.0, 1.0);
+}
+
+GeometricGrading::GeometricGrading(const Real & ratio)
+    : ratio_(ratio)
+{
+    assert( ratio_ >= 1.0 );
+}
+
+VectorXr GeometricGrading::distribution(const Index & nNodes) const
+{
+    if ( ratio_ == 1.0 )
+    {
+        return VectorXr::LinSpaced(nNodes, 0.0, 1.0);
+    }
+    
+    VectorXr s = VectorXr::Zero(nNodes);
+    
+    for ( Index k = 0; k < nNodes; ++k )
+    {
+        s(k) = std::pow(ratio_, k) - 1.0;
+    }
+    
+    return s / s(nNodes - 1);
+}
+
+TanhGrading::TanhGrading(const Real & stretch)
+    : stretch_(stretch)
+{
+    assert( stretch_ > 0.0 );
+}
+
+VectorXr TanhGrading::distribution(const Index & nNodes) const
+{
+    VectorXr s = VectorXr::Zero(nNodes);
+    
+    for ( Index k = 0; k < nNodes; ++k )
+    {
+        s(k) = 1.0 + std::tanh( stretch_ * ( (Real) k / (nNodes - 1) - 1.0 ) ) / std::tanh(stretch_);
+    }
+    
+    return s;
+}
@@ -0,0 +1,154 @@
+/* C++11 */
+
+/**
+ * @file   mesh.h
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ * @brief Classes for the generation of one-dimensional graded meshes.
+ *
+ */
+
+#ifndef MESH_H
+#define MESH_H
+
+#include "typedefs.h"
+
+#include <cmath>    // std::pow, std::tanh.
+
+/**
+ * @class MeshGrading
+ *
+ * The nodes of a segment @f$ \left[x_0, x_1\right] @f$ (or @f$ \left[x_1, x_0\right] @f$) are computed as
+ * @f$ x_k = x_0 + (x_1 - x_0) \cdot s_k @f$, being @f$ 0 = s_0 < s_1 < \dots < s_{n-1} = 1 @f$
+ * a distribution of points clustered towards @f$ s = 0 @f$, i.e. towards @f$ x_0 @f$.
+ *
+ * @brief Abstract class providing the distribution of the nodes along a segment.
+ *
+ */
+class MeshGrading
+{
+    public:
+        /**
+         * @brief Default constructor (defaulted).
+         */
+        MeshGrading() = default;
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~MeshGrading() = default;
+        
+        /**
+         * @brief Compute the nodes of a segment.
+         * @param[in] x0     : the end-point the nodes are clustered towards;
+         * @param[in] x1     : the other end-point;
+         * @param[in] nNodes : the number of nodes (end-points included).
+         * @returns the nodes, ordered from @a x0 to @a x1.
+         */
+        virtual VectorXr apply(const Real &, const Real &, const Index &) const;
+        
+    protected:
+        /**
+         * @brief Compute the distribution of the points in @f$ \left[0, 1\right] @f$.
+         * @param[in] nNodes : the number of points (end-points included).
+         * @returns the points @f$ s_k @f$, increasing.
+         */
+        virtual VectorXr distribution(const Index &) const = 0;
+};
+
+/**
+ * @class UniformGrading
+ *
+ * @brief Class derived from @ref MeshGrading providing equally spaced nodes.
+ *
+ */
+class UniformGrading : public MeshGrading
+{
+    public:
+        /**
+         * @brief Default constructor (defaulted).
+         */
+        UniformGrading() = default;
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~UniformGrading() = default;
+        
+        virtual VectorXr apply(const Real &, const Real &, const Index &) const override;
+        
+    protected:
+        virtual VectorXr distribution(const Index &) const override;
+};
+
+/**
+ * @class GeometricGrading
+ *
+ * The mesh size grows by a constant ratio @f$ r @f$ from one element to the next:
+ * @f[ s_k = \frac{r^k - 1}{r^{n-1} - 1} ~ . @f]
+ *
+ * @brief Class derived from @ref MeshGrading providing geometrically graded nodes.
+ *
+ */
+class GeometricGrading : public MeshGrading
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the ratio).
+         */
+        GeometricGrading() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] ratio : the ratio between the sizes of two consecutive elements (@f$ \geq 1 @f$).
+         */
+        GeometricGrading(const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~GeometricGrading() = default;
+        
+    protected:
+        virtual VectorXr distribution(const Index &) const override;
+        
+    private:
+        Real ratio_;    /**< @brief Ratio between the sizes of two consecutive elements. */
+};
+
+/**
+ * @class TanhGrading
+ *
+ * The points are given by a one-sided hyperbolic tangent stretching of parameter @f$ \delta @f$:
+ * @f[ s_k = 1 + \frac{\tanh\left(\delta\left(\xi_k - 1\right)\right)}{\tanh(\delta)} ~ , \qquad \xi_k = \frac{k}{n-1} ~ . @f]
+ *
+ * @brief Class derived from @ref MeshGrading providing hyperbolic tangent graded nodes.
+ *
+ */
+class TanhGrading : public MeshGrading
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the stretching).
+         */
+        TanhGrading() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] stretch : the stretching parameter @f$ \delta > 0 @f$.
+         */
+        TanhGrading(const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~TanhGrading() = default;
+        
+    protected:
+        virtual VectorXr distribution(const Index &) const override;
+        
+    private:
+        Real stretch_;    /**< @brief Stretching parameter. */
+};
+
+#endif /* MESH_H */
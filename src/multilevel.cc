@@ -0,0 +1,90 @@
+/* C++11 */
+
+/**
+ * @file   multilevel.cc
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ */
+
+#include "multilevel.h"
+
+FidelityController::FidelityController(const GetPot & config)
+    : levelsNo_(config("FIT/Multilevel/levelsNo", 1)), factor_(config("FIT/Multilevel/factor", 2.0)),
+      quadNodesNo_(config("QuadratureRule/nNodes", 101)),
+      minNodesNo_(config("FIT/Multilevel/minNodesNo", 51)), minStepsNo_(config("FIT/Multilevel/minStepsNo", 21)),
+      minQuadNodesNo_(config("FIT/Multilevel/minQuadNodesNo", 21))
+{
+    if ( levelsNo_ < 1 || factor_ <= 1.0 )
+    {
+        throw std::runtime_error("ERROR: wrong variables \"levelsNo\" and \"factor\" set in the configuration file (levelsNo >= 1 and factor > 1 required).");
+    }
+    
+    level_ = levelsNo_ - 1;
+}
+
+void FidelityController::coarsen(ParamList & params, GetPot & config, const Index & level) const
+{
+    assert( level >= 0 && level < levelsNo_ );
+    
+    if ( level == 0 )
+    {
+        config.set("QuadratureRule/nNodes", (int) quadNodesNo_);
+        return;
+    }
+    
+    const Real scale = std::pow(factor_, level);
+    
+    // Never coarsen above the finest level, nor below the minimum sizes.
+    auto coarse = [scale] (const Index & n, const Index & nMin)
+    {
+        return std::min( n, std::max( nMin, (Index) std::ceil(n / scale) ) );
+    };
+    
+    params.setNNodes( coarse(params.nNodes(), minNodesNo_) );
+    params.setNSteps( coarse(params.nSteps(), minStepsNo_) );
+    
+    config.set("QuadratureRule/nNodes", (int) coarse(quadNodesNo_, minQuadNodesNo_));
+    
+    return;
+}
+
+bool FidelityController::promote(const VectorXr & error, const Index & candidate, const Real & errorFiner,
+                                 const bool & stagnated)
+{
+    if ( finest() )
+    {
+        return false;
+    }
+    
+    assert( error.size() >= 2 && candidate >= 0 && candidate < error.size() );
+    
+    // Gap between the two best candidates at the current level.
+    Index minimum = 0;
+    Real best = error.minCoeff(&minimum);
+    Real second = std::numeric_limits<Real>::infinity();
+    
+    for ( Index i = 0; i < error.size(); ++i )
+    {
+        if ( i != minimum )
+        {
+            second = std::min( second, error(i) );
+        }
+    }
+    
+    // Discretization error estimate of the current level.
+    const Real estimate = std::abs(errorFiner - error(candidate));
+    
+    if ( stagnated || estimate >= second - best )
+    {
+        --level_;
+        return true;
+    }
+    
+    return false;
+}
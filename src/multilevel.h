@@ -0,0 +1,129 @@
+/* C++11 */
+
+/**
+ * @file   multilevel.h
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ * @brief Coarse-to-fine control of the simulation fidelity during the fitting.
+ *
+ */
+
+#ifndef MULTILEVEL_H
+#define MULTILEVEL_H
+
+#include "paramList.h"
+#include "typedefs.h"
+
+#include <cmath>    // std::pow, std::ceil.
+#include <limits>    // std::numeric_limits<>::infinity
+
+/**
+ * @class FidelityController
+ *
+ * Level @f$ 0 @f$ is the finest one, i.e. the simulation specified by the parameter list and by
+ * the configuration file. At level @f$ l @f$ the number of mesh nodes, of bias steps and of
+ * quadrature nodes are divided by @f$ r^l @f$, being @f$ r @f$ the coarsening factor.
+ *
+ * The fitting starts from the coarsest level. At each fitting iteration the candidate at the best
+ * sigma of the previous iteration is also simulated at the next finer level, concurrently with the
+ * candidates: the difference between the two distances estimates the discretization error of the
+ * current level. Once this estimate is no longer smaller than the gap
+ * between the two best candidates (i.e. when the sigma bracket has shrunk enough that the current
+ * level cannot tell them apart), or the fitting stagnates, the level is promoted.
+ *
+ * @brief Class providing the fidelity levels used by a multilevel fitting.
+ *
+ */
+class FidelityController
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the configuration).
+         */
+        FidelityController() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] config : the GetPot configuration object (section @a FIT/Multilevel).
+         */
+        FidelityController(const GetPot &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~FidelityController() = default;
+        
+        /**
+         * @brief Coarsen a simulation to a given level.
+         * @param[in,out] params : the parameter list (number of mesh nodes and bias steps);
+         * @param[in,out] config : the GetPot configuration object (number of quadrature nodes);
+         * @param[in]     level  : the level (0 = finest).
+         */
+        void coarsen(ParamList &, GetPot &, const Index &) const;
+        /**
+         * @brief Coarsen a simulation to the current level.
+         * @param[in,out] params : the parameter list (number of mesh nodes and bias steps);
+         * @param[in,out] config : the GetPot configuration object (number of quadrature nodes).
+         */
+        inline void coarsen(ParamList &, GetPot &) const;
+        
+        /**
+         * @brief Decide whether to promote the current level, and promote it if so.
+         * @param[in] error      : the distances of the candidates simulated at the current level;
+         * @param[in] candidate  : the index of the candidate also simulated at the next finer level;
+         * @param[in] errorFiner : its distance at the next finer level;
+         * @param[in] stagnated  : whether the fitting iteration did not move the best candidate.
+         * @returns true if the level has been promoted.
+         */
+        bool promote(const VectorXr &, const Index &, const Real &, const bool &);
+        
+        /**
+         * @name Getter methods
+         * @{
+         */
+        inline const Index & level() const;
+        inline const Index & levelsNo() const;
+        inline bool finest() const;
+        
+        /**
+         * @}
+         */
+        
+    private:
+        Index levelsNo_ ;    /**< @brief Number of levels (1 = no multilevel). */
+        Real  factor_   ;    /**< @brief Coarsening factor between two consecutive levels. */
+        Index level_    ;    /**< @brief Current level. */
+        
+        Index quadNodesNo_;    /**< @brief Number of quadrature nodes at the finest level. */
+        
+        Index minNodesNo_    ;    /**< @brief Minimum number of mesh nodes at any level. */
+        Index minStepsNo_    ;    /**< @brief Minimum number of bias steps at any level. */
+        Index minQuadNodesNo_;    /**< @brief Minimum number of quadrature nodes at any level. */
+};
+
+// Implementations.
+inline void FidelityController::coarsen(ParamList & params, GetPot & config) const
+{
+    coarsen(params, config, level_);
+}
+
+inline const Index & FidelityController::level() const
+{
+    return level_;
+}
+
+inline const Index & FidelityController::levelsNo() const
+{
+    return levelsNo_;
+}
+
+inline bool FidelityController::finest() const
+{
+    return ( level_ == 0 );
+}
+
+#endif /* MULTILEVEL_H */
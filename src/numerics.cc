@@ -136,3 +136,186 @@ Real numerics::error_L2(const VectorXr & interp, const VectorXr & simulated,
     
     return trapz(V_centered, (interp_centered - simulated_centered).array().square().matrix());
 }
+
+VectorXr numerics::cv_errors(const VectorXr & V_experim, const VectorXr & C_experim,
+                             const VectorXr & V_simulated, const VectorXr & C_simulated,
+                             Real & V_shift)
+{
+    assert( V_experim  .size() == C_experim  .size() );
+    assert( V_simulated.size() == C_simulated.size() );
+    
+    VectorXr dC_dV_experim   = deriv(C_experim  , V_experim  );
+    VectorXr dC_dV_simulated = deriv(C_simulated, V_simulated);
+    
+    // Compute V_shift.
+    {
+        Index j_e = 0;
+        dC_dV_experim.maxCoeff(&j_e);
+        
+        Index j_s = 0;
+        dC_dV_simulated.maxCoeff(&j_s);
+        
+        V_shift = V_simulated(j_s) - V_experim(j_e);
+    }
+    
+    VectorXr     C_interp = interp1(V_experim,     C_experim, V_simulated.array() - V_shift);
+    VectorXr dC_dV_interp = interp1(V_experim, dC_dV_experim, V_simulated.array() - V_shift);
+    
+    VectorXr errors = VectorXr::Zero( 3 );
+    
+    errors(0) = std::sqrt( error_L2(C_interp, C_simulated, V_simulated.array() - V_shift) );
+    errors(1) = std::sqrt( errors(0) * errors(0) +
+                           error_L2(dC_dV_interp, dC_dV_simulated, V_simulated.array() - V_shift) );
+    errors(2) = std::abs( nonNaN(dC_dV_interp).maxCoeff() - nonNaN(dC_dV_simulated).maxCoeff() );
+    
+    return errors;
+}
+
+Real numerics::cv_errors_bound(const VectorXr & V_experim, const VectorXr & C_experim,
+                               const VectorXr & V_simulated, const VectorXr & C_simulated,
+                               const Index & stepsNo, const unsigned & errorNorm)
+{
+    assert( V_experim.size() == C_experim.size() );
+    assert( stepsNo <= V_simulated.size() && stepsNo <= C_simulated.size() );
+    
+    if ( stepsNo < 3 || std::isnan( C_simulated.head(stepsNo).sum() ) )
+    {
+        return 0.0;
+    }
+    
+    const Index n = V_simulated.size();
+    
+    VectorXr dC_dV_experim = deriv(C_experim, V_experim);
+    
+    Index j_e = 0;
+    const Real peak_experim = dC_dV_experim.maxCoeff(&j_e);
+    
+    // Derivatives not depending on values still to be computed: forward difference at the first
+    // point, central differences up to "stepsNo - 2".
+    VectorXr dC_dV_known = deriv( (VectorXr) C_simulated.head(stepsNo), (VectorXr) V_simulated.head(stepsNo) ).head(stepsNo - 1);
+    
+    Index j_known = 0;
+    const Real peak_known = dC_dV_known.maxCoeff(&j_known);
+    
+    // The final peak is not lower than the known one, while the interpolated experimental one
+    // is not higher than the experimental peak.
+    if ( errorNorm == 2 )
+    {
+        return std::max( peak_known - peak_experim, 0.0 );
+    }
+    
+    // The final peak is either the known one or one of the points still to be computed. The bias grid
+    // being evenly spaced, the experimental curve shifted so that its peak is at "V_simulated(j)" is evaluated
+    // at "V_simulated(i)" as its value at "V_experim(j_e) + (i - j) * h", interpolated once for all shifts.
+    const Real h = (V_simulated(n - 1) - V_simulated(0)) / (n - 1);
+    
+    assert( ( V_simulated.tail(n - 1) - V_simulated.head(n - 1) ).cwiseAbs().maxCoeff() <= h * (1.0 + 1.0e-6) );
+    
+    const Index offset = n - 1;    // Lattice index of "i - j = 0".
+    
+    VectorXr C_lattice = interp1(V_experim, C_experim,
+                                 V_experim(j_e) + h * VectorXr::LinSpaced(n + stepsNo - 1, - offset, stepsNo - 1).array());
+                                 
+    // Lattice values inside the experimental range (a contiguous set, NaN outside).
+    Index dMin = 0;
+    
+    while ( dMin < C_lattice.size() && std::isnan( C_lattice(dMin) ) )
+    {
+        ++dMin;
+    }
+    
+    Index dMax = C_lattice.size() - 1;
+    
+    while ( dMax >= dMin && std::isnan( C_lattice(dMax) ) )
+    {
+        --dMax;
+    }
+    
+    if ( dMax - dMin < 1 )
+    {
+        return 0.0;
+    }
+    
+    // Maximum variation of the experimental curve between consecutive lattice points.
+    const Real lipschitz = ( C_lattice.segment(dMin + 1, dMax - dMin) - C_lattice.segment(dMin, dMax - dMin) ).cwiseAbs().maxCoeff();
+    
+    // Squared L^2-distance (as in error_L2) for the shift "j", restricted to the simulated points "first" to "last".
+    auto distance = [&] (const Index & j, const Index & first, const Index & last) -> Real
+    {
+        Real sum = 0.0;
+        Real e2Old = 0.0;
+        
+        for ( Index i = first; i <= last; ++i )
+        {
+            const Real e = C_lattice(i - j + offset) - C_simulated(i);
+            const Real e2 = e * e;
+            
+            if ( i > first )
+            {
+                sum += 0.5 * (V_simulated(i) - V_simulated(i - 1)) * (e2 + e2Old);
+            }
+            
+            e2Old = e2;
+        }
+        
+        return sum;
+    };
+    
+    // Simulated points where the experimental curve shifted by "j" is defined.
+    auto first = [&] (const Index & j) -> Index
+    {
+        return std::max( j + dMin - offset, (Index) 0 );
+    };
+    auto last = [&] (const Index & j) -> Index
+    {
+        return std::min( j + dMax - offset, stepsNo - 1 );
+    };
+    
+    Real bound_L2 = distance(j_known, first(j_known), last(j_known));
+    
+    // Branch and bound over blocks of shifts: on the points shared by all the shifts in a block, the distance
+    // from the experimental curve shifted by "j" differs from the one at the center of the block by at most
+    // sqrt(width) * lipschitz * |j - center|, and restricting the distance to fewer points can only lower it.
+    const Index shiftsNo  = n - stepsNo + 1;
+    const Index blockSize = std::max( (Index) std::sqrt( (Real) shiftsNo ), (Index) 1 );
+    
+    std::vector< std::pair<Real, Index> > blocks;    // (Lower bound, first shift of the block).
+    
+    for ( Index j1 = stepsNo - 1; j1 < n; j1 += blockSize )
+    {
+        const Index j2 = std::min( j1 + blockSize, n ) - 1;
+        const Index jc = (j1 + j2) / 2;
+        
+        const Index i1 = first(j2);
+        const Index i2 = last (j1);
+        
+        Real lower = 0.0;
+        
+        if ( i2 > i1 )
+        {
+            const Real slack = std::sqrt( V_simulated(i2) - V_simulated(i1) ) * lipschitz * std::max(jc - j1, j2 - jc);
+            
+            lower = std::max( std::sqrt( distance(jc, i1, i2) ) - slack, 0.0 );
+        }
+        
+        blocks.push_back( std::make_pair(lower * lower, j1) );
+    }
+    
+    std::sort(blocks.begin(), blocks.end());
+    
+    for ( const std::pair<Real, Index> & block : blocks )
+    {
+        if ( block.first >= bound_L2 )
+        {
+            break;
+        }
+        
+        for ( Index j = block.second; j < std::min( block.second + blockSize, n ); ++j )
+        {
+            bound_L2 = std::min( bound_L2, distance(j, first(j), last(j)) );
+        }
+    }
+    
+    // The H^1-distance is bounded by the L^2 one.
+    return std::sqrt(bound_L2);
+}
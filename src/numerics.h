@@ -20,6 +20,7 @@
 #include "typedefs.h"
 
 #include <limits>    // NaN
+#include <vector>    // std::vector
 
 /**
  * @namespace numerics
@@ -104,6 +105,36 @@ namespace numerics
      * @returns the value of the @f$ L^2 @f$-norm error.
      */
     Real error_L2(const VectorXr &, const VectorXr &, const VectorXr &);
+    
+    /**
+     * @brief Compare simulated and experimental capacitance-voltage curves, once the peaks of their
+     * derivatives with respect to the voltage have been aligned.
+     * @param[in]  V_experim   : the experimental voltage values (sorted);
+     * @param[in]  C_experim   : the experimental capacitance values;
+     * @param[in]  V_simulated : the simulated voltage values;
+     * @param[in]  C_simulated : the simulated capacitance values;
+     * @param[out] V_shift     : the peak shift between simulated and experimental values.
+     * @returns a vector containing the @f$ L^2 @f$-distance, the @f$ H^1 @f$-distance and the distance
+     * between the peaks of the derivatives.
+     */
+    VectorXr cv_errors(const VectorXr &, const VectorXr &, const VectorXr &, const VectorXr &, Real &);
+    
+    /**
+     * Only the first @a stepsNo simulated values are known: the peak shift, depending on the whole
+     * curve, is bounded by the candidate peaks still possible, the distances are restricted to the
+     * bias range swept so far. The @f$ H^1 @f$-distance is bounded by the @f$ L^2 @f$ one, whose
+     * minimum over the candidate shifts is searched by branch and bound.
+     *
+     * @brief Compute a lower bound of one of the distances returned by @ref cv_errors from a partial sweep.
+     * @param[in] V_experim   : the experimental voltage values (sorted);
+     * @param[in] C_experim   : the experimental capacitance values;
+     * @param[in] V_simulated : the whole grid of simulated voltage values (evenly spaced);
+     * @param[in] C_simulated : the simulated capacitance values (only the first @a stepsNo are used);
+     * @param[in] stepsNo     : the number of simulated values already computed;
+     * @param[in] errorNorm   : the distance to bound (0 = @f$ L^2 @f$, 1 = @f$ H^1 @f$, 2 = peak).
+     * @returns the lower bound of the requested distance.
+     */
+    Real cv_errors_bound(const VectorXr &, const VectorXr &, const VectorXr &, const VectorXr &, const Index &, const unsigned &);
 }
 
 // Implementations.
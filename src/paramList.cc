@@ -18,7 +18,7 @@ using namespace constants;
 
 ParamList::ParamList(const RowVectorXr & list)
 {
-    assert( list.size() == PARAMS_NO );
+    assert( list.size() >= PARAMS_NO && (list.size() - PARAMS_NO) % 3 == 0 );
     
     assert( list( 0) >  0   );
     assert( list( 1) >  0.0 );
@@ -67,4 +67,36 @@ ParamList::ParamList(const RowVectorXr & list)
     nSteps_       = list(24)       ;
     V_min_        = list(25)       ;
     V_max_        = list(26)       ;
+    
+    // Further gaussians.
+    for ( Index j = PARAMS_NO; j < list.size(); j += 3 )
+    {
+        assert( list(j    ) >= 0.0 );
+        assert( list(j + 1) >= 0.0 );
+        
+        extraGaussians_.push_back( {list(j), list(j + 1) * KB_T, list(j + 2)} );
+    }
+}
+
+std::vector<Gaussian> ParamList::gaussians() const
+{
+    std::vector<Gaussian> gaussians = { {N0_  , sigma_  , 0.0     },
+                                        {N0_2_, sigma_2_, shift_2_},
+                                        {N0_3_, sigma_3_, shift_3_},
+                                        {N0_4_, sigma_4_, shift_4_}
+                                      };
+                                      
+    gaussians.insert(gaussians.end(), extraGaussians_.begin(), extraGaussians_.end());
+    
+    std::vector<Gaussian> active;
+    
+    for ( const Gaussian & gaussian : gaussians )
+    {
+        if ( gaussian.N0 > 0.0 )
+        {
+            active.push_back(gaussian);
+        }
+    }
+    
+    return active;
 }
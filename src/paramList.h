@@ -19,10 +19,24 @@
 
 #include "typedefs.h"
 
+#include <vector>
+
+/**
+ * @brief Parameters of a gaussian component of the Density of States.
+ */
+struct Gaussian
+{
+    Real N0   ;    /**< @brief Gaussian @f$ N_0 \left[ m^{-3} \right] @f$. */
+    Real sigma;    /**< @brief Gaussian standard deviation @f$ \sigma @f$ @f$ \left[ J \right] @f$. */
+    Real shift;    /**< @brief Gaussian shift with respect to the 1st gaussian electric potential @f$ \left[ V \right] @f$. */
+};
+
 /**
  * @class ParamList
  *
- * It can include up to 4 gaussians (later combined to compute total charge) and an exponential.
+ * It includes 4 gaussians (later combined to compute total charge) and an exponential. Any further gaussian
+ * can be appended to the list as a triplet @f$ \left(N_0, \sigma, \mathrm{shift}\right) @f$, with the same
+ * units as the 2nd to 4th gaussians.
  *
  * @brief Class providing methods to handle a list of parameters.
  *
@@ -76,6 +90,7 @@ class ParamList
         inline const Real  & shift_4()      const;
         inline const Real  & N0_exp()       const;
         inline const Real  & lambda_exp()   const;
+        inline const std::vector<Gaussian> & extraGaussians() const;
         inline const Real  & A_semic()      const;
         inline const Real  & C_sb()         const;
         inline const Index & nNodes()       const;
@@ -88,12 +103,21 @@ class ParamList
          * @}
          */
         
+        /**
+         * @brief Collect all the gaussians contributing to the Density of States.
+         * @returns the gaussians with @f$ N_0 > 0 @f$, the 1st one being given a null shift.
+         */
+        std::vector<Gaussian> gaussians() const;
+        
         /**
          * @name Setter methods
          * @{
          */
+        inline void setSigma(const Real &);
         inline void setT_semic(const Real &);
         inline void setC_sb(const Real &);
+        inline void setNNodes(const Index &);
+        inline void setNSteps(const Index &);
         /**
          * @}
          */
@@ -120,6 +144,7 @@ class ParamList
         Real  shift_4_     ;    /**< @brief 4th gaussian shift with respect to the 1st gaussian electric potential @f$ \left[ V \right] @f$. */
         Real  N0_exp_      ;    /**< @brief Exponential @f$ N_0 \left[ m^{-3} \right] @f$. */
         Real  lambda_exp_  ;    /**< @brief Exponential @f$ \lambda @f$ @f$ \left[ J \right] @f$. */
+        std::vector<Gaussian> extraGaussians_;    /**< @brief Gaussians following the 4th one. */
         Real  A_semic_     ;    /**< @brief Area of the semiconductor @f$ \left[ m^2 \right] @f$. */
         Real  C_sb_        ;    /**< @brief Stray capacitance, connected in parallel with the device @f$ \left[ F \right] @f$. */
         Index nNodes_      ;    /**< @brief Number of nodes that form the mesh. */
@@ -234,6 +259,11 @@ inline const Real & ParamList::lambda_exp() const
     return lambda_exp_;
 }
 
+inline const std::vector<Gaussian> & ParamList::extraGaussians() const
+{
+    return extraGaussians_;
+}
+
 inline const Real & ParamList::A_semic() const
 {
     return A_semic_;
@@ -271,6 +301,13 @@ inline Real ParamList::PhiBcoeff() const
     return schottky;
 }
 
+inline void ParamList::setSigma(const Real & sigma)
+{
+    assert( sigma >= 0.0 );
+    
+    sigma_ = sigma;
+}
+
 inline void ParamList::setT_semic(const Real & t_semic)
 {
     assert( t_semic >= 0.0);
@@ -285,4 +322,18 @@ inline void ParamList::setC_sb(const Real & C_sb)
     C_sb_ = C_sb;
 }
 
+inline void ParamList::setNNodes(const Index & nNodes)
+{
+    assert( nNodes > 0 );
+    
+    nNodes_ = nNodes;
+}
+
+inline void ParamList::setNSteps(const Index & nSteps)
+{
+    assert( nSteps > 0 );
+    
+    nSteps_ = nSteps;
+}
+
 #endif /* PARAMLIST_H */
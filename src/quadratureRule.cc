@@ -14,6 +14,10 @@
 
 #include "quadratureRule.h"
 
+#include "numerics.h"
+
+#include <limits>    // std::numeric_limits
+
 using namespace constants;
 
 QuadratureRule::QuadratureRule (const Index & nNodes)
@@ -25,21 +29,305 @@ QuadratureRule::QuadratureRule (const Index & nNodes)
     weights_.resize (nNodes_);
 }
 
+Index QuadratureRule::next_order() const
+{
+    return 2 * nNodes_;
+}
+
+void QuadratureRule::apply_golub_welsch(const VectorXr & diagonal, const VectorXr & subDiagonal, const Real & mu0)
+{
+    assert( diagonal.size() == nNodes_ );
+    assert( subDiagonal.size() == nNodes_ - 1 );
+    
+    const Index maxIterationsNo = 30;
+    const Real  eps = std::numeric_limits<Real>::epsilon();
+    
+    VectorXr d = diagonal;
+    VectorXr e = VectorXr::Zero( nNodes_ );
+    e.head( nNodes_ - 1 ) = subDiagonal;
+    
+    VectorXr z = VectorXr::Zero( nNodes_ );    // First components of the eigenvectors.
+    z(0) = 1.0;
+    
+    for ( Index l = 0; l < nNodes_; ++l )
+    {
+        for ( Index iter = 0; ; ++iter )
+        {
+            // Look for a negligible sub-diagonal element, splitting the matrix.
+            Index m = l;
+            
+            for ( ; m < nNodes_ - 1; ++m )
+            {
+                if ( std::abs( e(m) ) <= eps * ( std::abs( d(m) ) + std::abs( d(m + 1) ) ) )
+                {
+                    break;
+                }
+            }
+            
+            if ( m == l )
+            {
+                break;
+            }
+            
+            if ( iter == maxIterationsNo )
+            {
+                throw std::runtime_error("ERROR: QuadratureRule::apply_golub_welsch() didn't reach convergence.");
+            }
+            
+            // Wilkinson shift.
+            Real g = ( d(l + 1) - d(l) ) / ( 2.0 * e(l) );
+            Real r = std::hypot(g, 1.0);
+            
+            g = d(m) - d(l) + e(l) / ( g + std::copysign(r, g) );
+            
+            Real s = 1.0, c = 1.0, p = 0.0;
+            
+            Index i = m - 1;
+            
+            for ( ; i >= l; --i )    // Givens rotations chasing the bulge up to row l.
+            {
+                Real f = s * e(i);
+                Real b = c * e(i);
+                
+                r = std::hypot(f, g);
+                e(i + 1) = r;
+                
+                if ( r == 0.0 )    // Underflow: recover and split.
+                {
+                    d(i + 1) -= p;
+                    e(m) = 0.0;
+                    break;
+                }
+                
+                s = f / r;
+                c = g / r;
+                g = d(i + 1) - p;
+                r = ( d(i) - g ) * s + 2.0 * c * b;
+                p = s * r;
+                d(i + 1) = g + p;
+                g = c * r - b;
+                
+                f = z(i + 1);
+                z(i + 1) = s * z(i) + c * f;
+                z(  i  ) = c * z(i) - s * f;
+            }
+            
+            if ( r == 0.0 && i >= l )
+            {
+                continue;
+            }
+            
+            d(l) -= p;
+            e(l)  = g;
+            e(m)  = 0.0;
+        }
+    }
+    
+    VectorXpair<Real> sorted = numerics::sort_pair(d);
+    
+    for ( Index i = 0; i < nNodes_; ++i )
+    {
+        nodes_  (i) = sorted(i).first;
+        weights_(i) = mu0 * z( sorted(i).second ) * z( sorted(i).second );
+    }
+    
+    return;
+}
+
+void QuadratureRule::march_roots(const VectorXr & a, const VectorXr & b, const Real & t0, const Real & u0, const Real & du0,
+                                 VectorXr & roots, VectorXr & derivatives)
+{
+    assert( a.size() >= 1 && b.size() >= 1 );
+    assert( a(0) != 0.0 || t0 > 0.0 );
+    
+    const Index termsNo         = 40  ;    // Terms of the Taylor series.
+    const Index maxIterationsNo = 100 ;    // Newton iterations for each root.
+    const Real  radiusFraction  = 1.0 / 3.0;    // Maximum step, relative to the distance from a singular origin.
+    const Real  eps = std::numeric_limits<Real>::epsilon();
+    
+    const bool singular = ( a(0) == 0.0 );
+    
+    derivatives.resize( roots.size() );
+    
+    VectorXr as(a.size()), bs(b.size());    // Coefficients of a(t + s) and b(t + s), as polynomials in s.
+    VectorXr c(termsNo);                    // Taylor coefficients of u(t + s).
+    
+    // Taylor shift of a polynomial by repeated synthetic division.
+    auto shift = [] (const VectorXr & poly, const Real & t, VectorXr & shifted)
+    {
+        shifted = poly;
+        
+        for ( Index i = 0; i < shifted.size() - 1; ++i )
+        {
+            for ( Index j = shifted.size() - 2; j >= i; --j )
+            {
+                shifted(j) += t * shifted(j + 1);
+            }
+        }
+    };
+    
+    // Value and derivative of the series at s, by Horner's rule.
+    auto evaluate = [&c, &termsNo] (const Real & s, Real & u, Real & du)
+    {
+        u  = c(termsNo - 1);
+        du = 0.0;
+        
+        for ( Index k = termsNo - 2; k >= 0; --k )
+        {
+            du = du * s + u;
+            u  = u  * s + c(k);
+        }
+    };
+    
+    Real t = t0, u = u0, du = du0;
+    
+    Index found = 0;
+    
+    while ( found < roots.size() )
+    {
+        shift(a, t, as);
+        shift(b, t, bs);
+        
+        // Taylor coefficients from the equation: sum_j a_j (k - j + 2) (k - j + 1) c_{k - j + 2} + sum_j b_j c_{k - j} = 0.
+        c.setZero();
+        c(0) = u;
+        c(1) = du;
+        
+        for ( Index k = 0; k < termsNo - 2; ++k )
+        {
+            Real sum = 0.0;
+            
+            for ( Index j = 1; j < as.size() && j <= k; ++j )
+            {
+                sum += as(j) * (k - j + 2) * (k - j + 1) * c(k - j + 2);
+            }
+            
+            for ( Index j = 0; j < bs.size() && j <= k; ++j )
+            {
+                sum += bs(j) * c(k - j);
+            }
+            
+            c(k + 2) = - sum / ( as(0) * (k + 2) * (k + 1) );
+        }
+        
+        // Step: a quarter of the local wavelength, inside the convergence radius of the series.
+        const Real k2 = bs(0) / as(0);
+        
+        if ( k2 <= 0.0 )
+        {
+            throw std::runtime_error("ERROR: QuadratureRule::march_roots() went past the oscillatory region before finding all the roots.");
+        }
+        
+        Real h = 0.5 * PI / std::sqrt(k2);
+        
+        if ( singular )
+        {
+            h = std::min( h, radiusFraction * t );
+        }
+        
+        Real uEnd = 0.0, duEnd = 0.0;
+        evaluate(h, uEnd, duEnd);
+        
+        // Sign of u right after t (if t is a root, the sign of its derivative).
+        const Real sign = ( u != 0.0 ) ? u : du;
+        
+        if ( sign * uEnd > 0.0 )    // No root in the step.
+        {
+            t += h;
+            u  = uEnd;
+            du = duEnd;
+            continue;
+        }
+        
+        // Root bracketed in (0, h]: safeguarded Newton's method on the series.
+        Real lo = 0.0, hi = h;
+        Real s = ( u != 0.0 ) ? h * u / (u - uEnd) : 0.5 * h;
+        Real us = 0.0, dus = 0.0;
+        
+        Index iter = 0;
+        
+        for ( ; iter < maxIterationsNo; ++iter )
+        {
+            evaluate(s, us, dus);
+            
+            ( sign * us > 0.0 ? lo : hi ) = s;
+            
+            Real sNew = s - us / dus;
+            
+            if ( !(sNew > lo && sNew < hi) )
+            {
+                sNew = 0.5 * (lo + hi);
+            }
+            
+            const bool converged = ( std::abs(sNew - s) <= 2.0 * eps * std::abs(t + sNew) );
+            
+            s = sNew;
+            
+            if ( converged )
+            {
+                break;
+            }
+        }
+        
+        if ( iter == maxIterationsNo )
+        {
+            throw std::runtime_error("ERROR: QuadratureRule::march_roots() didn't reach convergence.");
+        }
+        
+        evaluate(s, us, dus);
+        
+        t += s;
+        u  = 0.0;
+        du = dus;
+        
+        roots      (found) = t ;
+        derivatives(found) = du;
+        
+        ++found;
+    }
+    
+    return;
+}
+
 GaussHermiteRule::GaussHermiteRule (const Index & nNodes)
     : QuadratureRule(nNodes) {}
-
+    
 void GaussHermiteRule::apply ()
 // Using default parameters for maximum iterations number and tolerance.
 {
-    apply_iterative_algorithm ();
+    if ( !lookup(nNodes_, nodes_, weights_) )
+    {
+        apply_iterative_algorithm ();
+    }
 }
 
 
 void GaussHermiteRule::apply (const GetPot & config)
 {
-    apply_iterative_algorithm
-    (config ("QuadratureRule/maxIterationsNo", 1000),
-     config ("QuadratureRule/tolerance", 1.0e-14));
+    switch ( (Index) config("QuadratureRule/algorithm", 0) )
+    {
+        case 0:
+            if ( !lookup(nNodes_, nodes_, weights_) )
+            {
+                apply_iterative_algorithm
+                (config ("QuadratureRule/maxIterationsNo", 1000),
+                 config ("QuadratureRule/tolerance", 1.0e-14));
+            }
+            
+            break;
+            
+        case 1:
+            apply_using_eigendecomposition();
+            break;
+            
+        case 2:
+            apply_glaser_liu_rokhlin();
+            break;
+            
+        default:
+            throw std::runtime_error("ERROR: wrong variable \"algorithm\" set in the configuration file (only 0, 1 or 2 allowed).");
+            break;
+    }
 }
 
 void GaussHermiteRule::apply_iterative_algorithm
@@ -71,15 +359,15 @@ void GaussHermiteRule::apply_iterative_algorithm
             z = 1.91 * z - 0.91 * nodes_ (nNodes_ - 2);
         else
             z = 2.0 * z - nodes_ (nNodes_ - i + 1);
-    
+            
         Index j = 0;
-    
+        
         // Refinement by Newton's method.
         for ( ; j < maxIterationsNo; ++j)
         {
             p1 = PI_M4;
             p2 = 0.0;
-    
+            
             // Loop up the recurrence relation to
             // evaluate the Hermite polynomial at "z".
             for (Index k = 0; k < nNodes_; ++k)
@@ -89,22 +377,22 @@ void GaussHermiteRule::apply_iterative_algorithm
                 p1 = z * std::sqrt (2.0 / (k + 1.0)) * p2 -
                      std::sqrt (k / (k + 1.0)) * temp;
             }
-    
+            
             // "p1" is now the desidered Hermite polynomial.
             // Computing its derivative "dp" is needed.
             dp = std::sqrt (2.0 * nNodes_) * p2;
             // Newton step
             zOld = z;
             z   -= p1 / dp;
-    
+            
             if ( std::abs(z - zOld) <= tolerance )
                 break;
         }
-    
+        
         if (j == maxIterationsNo)
             throw std::runtime_error
             ("ERROR: GaussHermiteRule::apply_iterative_algorithm() didn't reach convergence.");
-    
+            
         nodes_ (i) = -z;
         nodes_ (nNodes_ - i - 1) = z;
         weights_ (i) = 2.0 / (dp * dp);
@@ -115,40 +403,67 @@ void GaussHermiteRule::apply_iterative_algorithm
 }
 
 void GaussHermiteRule::apply_using_eigendecomposition()
+{
+    // Jacobi matrix: zero diagonal, sub-diagonal sqrt(k / 2).
+    VectorXr k = VectorXr::LinSpaced( nNodes_ - 1, 1, nNodes_ - 1 );
+    
+    apply_golub_welsch( VectorXr::Zero( nNodes_ ), ( 0.5 * k ).cwiseSqrt(), SQRT_PI );    // SQRT_PI = beta0.
+    
+    return;
+}
+
+void GaussHermiteRule::apply_glaser_liu_rokhlin()
 {
     if ( nNodes_ == 1 )
     {
         nodes_  .fill(0.0);
-        weights_.fill(PI) ;
+        weights_.fill(SQRT_PI);
         return;
     }
     
-    MatrixXr Jac = MatrixXr::Zero( nNodes_, nNodes_ );    // Jacobi matrix.
-    VectorXr k = VectorXr::LinSpaced( nNodes_, 1, nNodes_ );
-    VectorXr v = std::sqrt(0.5) * k.cwiseSqrt();
+    // The nodes are symmetric about the origin: only the positive ones are computed.
+    const Index half = nNodes_ / 2;
+    const bool  odd  = ( nNodes_ % 2 == 1 );
     
-    for ( Index i = 0; i < Jac.rows() - 1; ++i )
-    {
-        Jac(i + 1,   i  ) = v(i);    // Sub-diagonal.
-        Jac(  i  , i + 1) = v(i);    // Super-diagonal.
-    }
+    VectorXr a = VectorXr::Ones(1);
+    VectorXr b(3);
+    b << 2.0 * nNodes_ + 1.0, 0.0, -1.0;
     
-    SelfAdjointEigenSolver<MatrixXr> eigSolver(Jac);
+    // u is odd (with a root at the origin) or even.
+    VectorXr roots(half), du;
+    march_roots(a, b, 0.0, odd ? 0.0 : 1.0, odd ? 1.0 : 0.0, roots, du);
     
-    nodes_ = eigSolver.eigenvalues();
+    // Logarithms of the weights, up to a constant (the origin has u'(0) = 1).
+    VectorXr logWeights = - roots.array().square() - 2.0 * du.array().abs().log();
     
-    MatrixXr EigVec = eigSolver.eigenvectors();
+    const Real logMax = odd ? std::max( logWeights.maxCoeff(), 0.0 ) : logWeights.maxCoeff();
     
-    VectorXr norm2 = (EigVec.transpose() * EigVec ).diagonal().cwiseSqrt();    // Normalize weights.
+    VectorXr w = ( logWeights.array() - logMax ).exp();
+    
+    const Real w0 = odd ? std::exp( - logMax ) : 0.0;
+    
+    const Real scale = SQRT_PI / ( 2.0 * w.sum() + w0 );    // SQRT_PI = beta0.
+    
+    for ( Index i = 0; i < half; ++i )
+    {
+        nodes_  (nNodes_ - half + i) =   roots(i);
+        nodes_  (half - 1 - i)       = - roots(i);
+        weights_(nNodes_ - half + i) = scale * w(i);
+        weights_(half - 1 - i)       = scale * w(i);
+    }
     
-    weights_ = ( SQRT_PI * EigVec.row(0).cwiseProduct(EigVec.row(0)).transpose() ).cwiseQuotient(norm2);    // SQRT_PI = beta0;
+    if ( odd )
+    {
+        nodes_  (half) = 0.0;
+        weights_(half) = scale * w0;
+    }
     
     return;
 }
 
 GaussLaguerreRule::GaussLaguerreRule(const Index & nNodes)
     : QuadratureRule(nNodes) {}
-
+    
 Real GaussLaguerreRule::log_gamma(const Real & x)
 {
     assert( x > 0.0 );
@@ -178,12 +493,36 @@ Real GaussLaguerreRule::log_gamma(const Real & x)
 
 void GaussLaguerreRule::apply()
 {
-    apply_iterative_algorithm();    // Using default parameters for maximum iterations number and tolerance.
+    if ( !lookup(nNodes_, nodes_, weights_) )
+    {
+        apply_iterative_algorithm();    // Using default parameters for maximum iterations number and tolerance.
+    }
 }
 
 void GaussLaguerreRule::apply(const GetPot & config)
 {
-    apply_iterative_algorithm( config("QuadratureRule/maxIterationsNo", 1000), config("QuadratureRule/tolerance", 1.0e-14) );
+    switch ( (Index) config("QuadratureRule/algorithm", 0) )
+    {
+        case 0:
+            if ( !lookup(nNodes_, nodes_, weights_) )
+            {
+                apply_iterative_algorithm( config("QuadratureRule/maxIterationsNo", 1000), config("QuadratureRule/tolerance", 1.0e-14) );
+            }
+            
+            break;
+            
+        case 1:
+            apply_using_eigendecomposition();
+            break;
+            
+        case 2:
+            apply_glaser_liu_rokhlin();
+            break;
+            
+        default:
+            throw std::runtime_error("ERROR: wrong variable \"algorithm\" set in the configuration file (only 0, 1 or 2 allowed).");
+            break;
+    }
 }
 
 void GaussLaguerreRule::apply_iterative_algorithm(const Index & maxIterationsNo, const Real & tolerance)
@@ -254,36 +593,195 @@ void GaussLaguerreRule::apply_iterative_algorithm(const Index & maxIterationsNo,
 
 void GaussLaguerreRule::apply_using_eigendecomposition()
 {
-    if ( nNodes_ == 1 )
+    // Jacobi matrix: diagonal 2k - 1, sub-diagonal k.
+    VectorXr k = VectorXr::LinSpaced( nNodes_, 1, nNodes_ );
+    
+    apply_golub_welsch( 2.0 * k.array() - 1.0, k.head( nNodes_ - 1 ), 1.0 );    // 1 = beta0.
+    
+    return;
+}
+
+void GaussLaguerreRule::apply_glaser_liu_rokhlin()
+{
+    const Real q = 4.0 * nNodes_ + 2.0;
+    
+    // Start halfway to the lower bound j_{0,1} / sqrt(4n + 2) of the first root in t = sqrt(x),
+    // being j_{0,1} the first zero of the Bessel function J_0.
+    const Real t0 = 0.5 * 2.404825557695773 / std::sqrt(q);
+    const Real x0 = t0 * t0;
+    
+    // Laguerre polynomials of degree n ("p1") and n - 1 ("p2") at x0.
+    Real p1 = 1.0, p2 = 0.0, temp = 0.0;
+    
+    for ( Index k = 0; k < nNodes_; ++k )
     {
-        nodes_  .fill(0.0);
-        weights_.fill(1.0);
-        return;
+        temp = p2;
+        p2 = p1;
+        p1 = ( (2.0 * k + 1.0 - x0) * p2 - k * temp ) / ( k + 1.0 );
     }
     
-    MatrixXr Jac = MatrixXr::Zero( nNodes_, nNodes_ );    // Jacobi matrix.
-    VectorXr k = VectorXr::LinSpaced( nNodes_, 1, nNodes_ );
+    const Real dp = nNodes_ * (p1 - p2) / x0;
+    
+    const Real sqrtT0 = std::sqrt(t0);
+    const Real exp0   = std::exp( - 0.5 * x0 );
+    
+    const Real u0  = sqrtT0 * exp0 * p1;
+    const Real du0 = exp0 * ( (0.5 / sqrtT0 - t0 * sqrtT0) * p1 + 2.0 * t0 * sqrtT0 * dp );
+    
+    VectorXr a = VectorXr::Zero(3);
+    a(2) = 1.0;
+    
+    VectorXr b(5);
+    b << 0.25, 0.0, q, 0.0, -1.0;
+    
+    VectorXr roots(nNodes_), du;
+    march_roots(a, b, t0, u0, du0, roots, du);
+    
+    nodes_   = roots.array().square();
+    weights_ = ( (4.0 * roots).array().log() - nodes_.array() - 2.0 * du.array().abs().log() ).exp();
+    
+    return;
+}
+
+GenzKeisterRule::GenzKeisterRule(const Index & nNodes)
+    : QuadratureRule( order(nNodes) ) {}
+    
+Index GenzKeisterRule::order(const Index & nNodes)
+{
+    static const Index orders[5] = { 1, 3, 9, 19, 35 };
     
-    for ( Index i = 0; i < Jac.rows() - 1; ++i )
+    Index k = 4;
+    
+    while ( k > 0 && orders[k] > nNodes )
     {
-        Jac(i + 1,   i  ) = k(i);    // Sub-diagonal.
-        Jac(  i  , i + 1) = k(i);    // Super-diagonal.
+        --k;
     }
     
-    for ( Index i = 0; i < Jac.rows(); ++i )
+    return orders[k];
+}
+
+void GenzKeisterRule::apply()
+{
+    webbur::hermite_genz_keister_lookup( (int) nNodes_, nodes_.data(), weights_.data() );
+}
+
+void GenzKeisterRule::apply(const GetPot &)
+{
+    apply();
+}
+
+Index GenzKeisterRule::next_order() const
+{
+    Index next = nNodes_;
+    
+    for ( Index n = nNodes_ + 1; n <= 35 && next == nNodes_; ++n )
     {
-        Jac(i, i) = 2 * k(i) - 1;    // Main diagonal.
+        next = order(n);
     }
     
-    SelfAdjointEigenSolver<MatrixXr> eigSolver(Jac);
+    return next;
+}
+
+TruncatedRule::TruncatedRule(const Index & nNodes, const Real & halfWidth)
+    : QuadratureRule(nNodes), halfWidth_(halfWidth)
+{
+    assert( halfWidth_ > 0.0 );
+}
+
+void TruncatedRule::apply()
+{
+    apply_reference();
     
-    nodes_ = eigSolver.eigenvalues();
+    nodes_   *= halfWidth_;
+    weights_  = halfWidth_ * weights_.cwiseProduct( ( - nodes_.array().square() ).exp().matrix() );
     
-    MatrixXr EigVec = eigSolver.eigenvectors();
+    return;
+}
+
+void TruncatedRule::apply(const GetPot &)
+{
+    apply();
+}
+
+ClenshawCurtisRule::ClenshawCurtisRule(const Index & nNodes, const Real & halfWidth)
+    : TruncatedRule( order(nNodes), halfWidth ) {}
     
-    VectorXr norm2 = (EigVec.transpose() * EigVec ).diagonal().cwiseSqrt();    // Normalize weights.
+Index ClenshawCurtisRule::order(const Index & nNodes)
+{
+    Index n = 1;
     
-    weights_ = ( 1 * EigVec.row(0).cwiseProduct(EigVec.row(0)).transpose() ).cwiseQuotient(norm2);    // 1 = beta0;
+    for ( Index next = 3; next <= nNodes; next = 2 * next - 1 )
+    {
+        n = next;
+    }
     
-    return;
+    return n;
+}
+
+Index ClenshawCurtisRule::next_order() const
+{
+    return ( nNodes_ == 1 ) ? 3 : 2 * nNodes_ - 1;
+}
+
+void ClenshawCurtisRule::apply_reference()
+{
+    webbur::clenshaw_curtis_compute( (int) nNodes_, nodes_.data(), weights_.data() );
+}
+
+Fejer2Rule::Fejer2Rule(const Index & nNodes, const Real & halfWidth)
+    : TruncatedRule( order(nNodes), halfWidth ) {}
+    
+Index Fejer2Rule::order(const Index & nNodes)
+{
+    Index n = 1;
+    
+    while ( 2 * n + 1 <= nNodes )
+    {
+        n = 2 * n + 1;
+    }
+    
+    return n;
+}
+
+Index Fejer2Rule::next_order() const
+{
+    return 2 * nNodes_ + 1;
+}
+
+void Fejer2Rule::apply_reference()
+{
+    webbur::fejer2_compute( (int) nNodes_, nodes_.data(), weights_.data() );
+}
+
+GaussPattersonRule::GaussPattersonRule(const Index & nNodes, const Real & halfWidth)
+    : TruncatedRule( order(nNodes), halfWidth ) {}
+    
+Index GaussPattersonRule::order(const Index & nNodes)
+{
+    Index n = 1;
+    
+    while ( 2 * n + 1 <= std::min( nNodes, (Index) 511 ) )
+    {
+        n = 2 * n + 1;
+    }
+    
+    return n;
+}
+
+Index GaussPattersonRule::next_order() const
+{
+    return order( 2 * nNodes_ + 1 );
+}
+
+void GaussPattersonRule::apply_reference()
+{
+    webbur::patterson_lookup( (int) nNodes_, nodes_.data(), weights_.data() );
+}
+
+GaussLegendreRule::GaussLegendreRule(const Index & nNodes, const Real & halfWidth)
+    : TruncatedRule(nNodes, halfWidth) {}
+    
+void GaussLegendreRule::apply_reference()
+{
+    webbur::legendre_compute( (int) nNodes_, nodes_.data(), weights_.data() );
 }
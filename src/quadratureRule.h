@@ -64,6 +64,13 @@ class QuadratureRule
          */
         virtual void apply(const GetPot & config) = 0;
         
+        /**
+         * @brief Number of nodes of the next finer rule of the same family,
+         * nesting the current one if the family is nested.
+         * @returns the number of nodes (@ref nNodes if no finer rule is available).
+         */
+        virtual Index next_order() const;
+        
         /**
          * @name Getter methods
          * @{
@@ -77,6 +84,44 @@ class QuadratureRule
          */
         
     protected:
+        /**
+         * @brief Compute nodes and weights by the Golub-Welsch algorithm, i.e. as the eigenvalues of the
+         * symmetric tridiagonal Jacobi matrix and the squared first components of its normalized eigenvectors.
+         *
+         * An implicit QL algorithm with Wilkinson shifts is applied directly to the tridiagonal matrix,
+         * updating only the first component of the eigenvectors: the cost is @f$ O(n^2) @f$ and no dense matrix is stored.
+         *
+         * @param[in] diagonal    : the main diagonal of the Jacobi matrix;
+         * @param[in] subDiagonal : the sub-diagonal of the Jacobi matrix;
+         * @param[in] mu0         : the integral of the weight function.
+         */
+        void apply_golub_welsch(const VectorXr &, const VectorXr &, const Real &);
+        
+        /**
+         * @brief Compute the first positive roots of a solution of:
+         * @f[ a(t) u''(t) + b(t) u(t) = 0 @f]
+         * being @f$ a, b @f$ polynomials, with @f$ a(t) \neq 0 @f$ for @f$ t > 0 @f$.
+         *
+         * Following: @n
+         * Andreas Glaser, Xiangtao Liu, and Vladimir Rokhlin. 2007. @n
+         * A fast algorithm for the calculation of the roots of special functions. @n
+         * SIAM Journal on Scientific Computing 29(4), 1420-1438. @n
+         * the solution is advanced by its Taylor series, whose coefficients follow from the equation by recurrence,
+         * with steps of a quarter of the local wavelength @f$ \frac{\pi}{2} \sqrt{a / b} @f$ (shorter than a third of the
+         * distance from the origin, where @f$ a @f$ is allowed to vanish). Each bracketed root is refined
+         * by a safeguarded Newton method on the series, so that the overall cost is @f$ O(n) @f$.
+         *
+         * @param[in]  a           : the coefficients of @f$ a(t) @f$, by increasing powers;
+         * @param[in]  b           : the coefficients of @f$ b(t) @f$, by increasing powers;
+         * @param[in]  t0          : the starting point (a root of @f$ u @f$ or a point before the first root);
+         * @param[in]  u0          : the value of @f$ u(t_0) @f$;
+         * @param[in]  du0         : the value of @f$ u'(t_0) @f$;
+         * @param[out] roots       : the roots following @f$ t_0 @f$ (its size is the number of roots to be computed);
+         * @param[out] derivatives : the values of @f$ u' @f$ at the roots.
+         */
+        static void march_roots(const VectorXr &, const VectorXr &, const Real &, const Real &, const Real &,
+                                VectorXr &, VectorXr &);
+                                
         Index    nNodes_ ;    /**< @brief Number of nodes of quadrature. */
         VectorXr nodes_  ;    /**< @brief Vector containing the computed nodes coordinates. */
         VectorXr weights_;    /**< @brief Vector containing the computed weights. */
@@ -109,7 +154,25 @@ class GaussHermiteRule : public QuadratureRule
          */
         virtual ~GaussHermiteRule() = default;
         
+        /**
+         * @brief Look up the nodes and weights embedded in the library for the common orders (21, 41, 101 and 201 nodes),
+         * as computed by the iterative algorithm.
+         * @param[in]  nNodes  : the number of nodes;
+         * @param[out] nodes   : the nodes (unchanged if not found);
+         * @param[out] weights : the weights (unchanged if not found).
+         * @returns true if the Gauss-Hermite rule with @a nNodes nodes is embedded.
+         */
+        static bool lookup(const Index &, VectorXr &, VectorXr &);
+        
+        /**
+         * @brief Apply the quadrature rule, looking it up among the embedded ones first.
+         */
         virtual void apply() override;
+        /**
+         * @brief Apply the quadrature rule reading parameters from a configuration file.
+         * With the iterative algorithm, the rule is looked up among the embedded ones first.
+         * @param[in] config : the GetPot configuration object.
+         */
         virtual void apply(const GetPot &) override;
         
         /**
@@ -120,9 +183,15 @@ class GaussHermiteRule : public QuadratureRule
          */
         void apply_iterative_algorithm(const Index & = 1000, const Real & = 1.0e-14);
         /**
-         * @brief Compute nodes and weights using an eigendecomposition-based algorithm.
+         * @brief Compute nodes and weights using the Golub-Welsch algorithm on the tridiagonal Jacobi matrix.
          */
         void apply_using_eigendecomposition();
+        /**
+         * @brief Compute nodes and weights in @f$ O(n) @f$ operations, marching along the roots of the Hermite function
+         * @f$ u(x) = e^{-x^2/2} H_n(x) @f$, solution of @f$ u'' + (2n + 1 - x^2) u = 0 @f$ (see @ref march_roots).
+         * The weights are @f$ w_i \propto e^{-x_i^2} / u'(x_i)^2 @f$.
+         */
+        void apply_glaser_liu_rokhlin();
 };
 
 /**
@@ -159,7 +228,25 @@ class GaussLaguerreRule : public QuadratureRule
          */
         static Real log_gamma(const Real &);
         
+        /**
+         * @brief Look up the nodes and weights embedded in the library for the common orders (21, 41, 101 and 201 nodes),
+         * as computed by the iterative algorithm.
+         * @param[in]  nNodes  : the number of nodes;
+         * @param[out] nodes   : the nodes (unchanged if not found);
+         * @param[out] weights : the weights (unchanged if not found).
+         * @returns true if the Gauss-Laguerre rule with @a nNodes nodes is embedded.
+         */
+        static bool lookup(const Index &, VectorXr &, VectorXr &);
+        
+        /**
+         * @brief Apply the quadrature rule, looking it up among the embedded ones first.
+         */
         virtual void apply() override;
+        /**
+         * @brief Apply the quadrature rule reading parameters from a configuration file.
+         * With the iterative algorithm, the rule is looked up among the embedded ones first.
+         * @param[in] config : the GetPot configuration object.
+         */
         virtual void apply(const GetPot &) override;
         
         /**
@@ -170,9 +257,256 @@ class GaussLaguerreRule : public QuadratureRule
          */
         void apply_iterative_algorithm(const Index & = 1000, const Real & = 1.0e-14);
         /**
-         * @brief Compute nodes and weights using an eigendecomposition-based algorithm.
+         * @brief Compute nodes and weights using the Golub-Welsch algorithm on the tridiagonal Jacobi matrix.
          */
         void apply_using_eigendecomposition();
+        /**
+         * @brief Compute nodes and weights in @f$ O(n) @f$ operations, marching along the roots of
+         * @f$ u(t) = \sqrt{t} e^{-t^2/2} L_n(t^2) @f$, solution of
+         * @f$ t^2 u'' + \left(\frac{1}{4} + (4n + 2) t^2 - t^4\right) u = 0 @f$ (see @ref march_roots),
+         * so that @f$ x_i = t_i^2 @f$ and @f$ w_i = 4 t_i e^{-t_i^2} / u'(t_i)^2 @f$.
+         * The marching starts before the first root, where @f$ L_n @f$ is evaluated by the three-term recurrence.
+         */
+        void apply_glaser_liu_rokhlin();
+};
+
+/**
+ * @class GenzKeisterRule
+ *
+ * Compute nodes and weights for the approximation of:
+ * @f[ \int_{-\infty}^{+\infty} w(x)f(x)~\mathrm{d}x @f]
+ * where @f$ w(x) = e^{-x^2} @f$, by the nested rules of orders 1, 3, 9, 19 and 35 presented in: @n
+ * Alan Genz and Bradley D. Keister. 1996. @n
+ * Fully symmetric interpolatory rules for multiple integrals over infinite regions with Gaussian weight. @n
+ * Journal of Computational and Applied Mathematics 71(2), 299-309. @n
+ * The number of nodes is rounded down to the closest order available.
+ *
+ * @brief Class derived from @ref QuadratureRule providing the nested Genz-Keister rules for the gaussian weight.
+ *
+ */
+class GenzKeisterRule : public QuadratureRule
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the number of nodes).
+         */
+        GenzKeisterRule() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] nNodes : the maximum number of nodes to be used for the quadrature rule.
+         */
+        GenzKeisterRule(const Index &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~GenzKeisterRule() = default;
+        
+        virtual void apply() override;
+        virtual void apply(const GetPot &) override;
+        
+        virtual Index next_order() const override;
+        
+    private:
+        /**
+         * @brief Round a number of nodes down to the closest order available.
+         * @param[in] nNodes : the number of nodes.
+         * @returns the order.
+         */
+        static Index order(const Index &);
+};
+
+/**
+ * @class TruncatedRule
+ *
+ * The integral of @ref GaussHermiteRule is truncated to @f$ \left[-L, L\right] @f$:
+ * @f[ \int_{-\infty}^{+\infty} e^{-x^2} f(x)~\mathrm{d}x \simeq \int_{-L}^{L} e^{-x^2} f(x)~\mathrm{d}x ~ , @f]
+ * with an error of order @f$ e^{-L^2} @f$, and approximated by a rule with nodes @f$ t_i @f$ and weights @f$ v_i @f$
+ * on @f$ \left[-1, 1\right] @f$ with unit weight, being:
+ * @f[ x_i = L t_i ~ , \qquad w_i = L v_i e^{-x_i^2} ~ . @f]
+ *
+ * @brief Abstract class providing the rules on a bounded interval, applied to the truncated gaussian weight.
+ *
+ */
+class TruncatedRule : public QuadratureRule
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the number of nodes).
+         */
+        TruncatedRule() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] nNodes    : the number of nodes to be used for the quadrature rule;
+         * @param[in] halfWidth : the half-width @f$ L @f$ of the integration interval.
+         */
+        TruncatedRule(const Index &, const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~TruncatedRule() = default;
+        
+        virtual void apply() override;
+        virtual void apply(const GetPot &) override;
+        
+    protected:
+        /**
+         * @brief Compute nodes and weights of the rule on @f$ \left[-1, 1\right] @f$ with unit weight.
+         */
+        virtual void apply_reference() = 0;
+        
+    private:
+        Real halfWidth_;    /**< @brief Half-width of the integration interval. */
+};
+
+/**
+ * @class ClenshawCurtisRule
+ *
+ * The nodes are the extrema @f$ t_i = \cos\left(\frac{i \pi}{n - 1}\right) @f$ of the Chebyshev polynomials,
+ * nested for @f$ n = 1, 3, 5, 9, \dots, 2^k + 1 @f$: the number of nodes is rounded down to the closest of these orders.
+ *
+ * @brief Class derived from @ref TruncatedRule providing the nested Clenshaw-Curtis rules.
+ *
+ */
+class ClenshawCurtisRule : public TruncatedRule
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the number of nodes).
+         */
+        ClenshawCurtisRule() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] nNodes    : the maximum number of nodes to be used for the quadrature rule;
+         * @param[in] halfWidth : the half-width of the integration interval.
+         */
+        ClenshawCurtisRule(const Index &, const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~ClenshawCurtisRule() = default;
+        
+        virtual Index next_order() const override;
+        
+    protected:
+        virtual void apply_reference() override;
+        
+    private:
+        /**
+         * @brief Round a number of nodes down to the closest nested order.
+         * @param[in] nNodes : the number of nodes.
+         * @returns the order.
+         */
+        static Index order(const Index &);
+};
+
+/**
+ * @class Fejer2Rule
+ *
+ * The nodes are the interior extrema @f$ t_i = \cos\left(\frac{i \pi}{n + 1}\right) @f$ of the Chebyshev polynomials,
+ * nested for @f$ n = 1, 3, 7, \dots, 2^k - 1 @f$: the number of nodes is rounded down to the closest of these orders.
+ *
+ * @brief Class derived from @ref TruncatedRule providing the nested Fejer rules of the second kind.
+ *
+ */
+class Fejer2Rule : public TruncatedRule
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the number of nodes).
+         */
+        Fejer2Rule() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] nNodes    : the maximum number of nodes to be used for the quadrature rule;
+         * @param[in] halfWidth : the half-width of the integration interval.
+         */
+        Fejer2Rule(const Index &, const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~Fejer2Rule() = default;
+        
+        virtual Index next_order() const override;
+        
+    protected:
+        virtual void apply_reference() override;
+        
+    private:
+        /**
+         * @brief Round a number of nodes down to the closest nested order.
+         * @param[in] nNodes : the number of nodes.
+         * @returns the order.
+         */
+        static Index order(const Index &);
+};
+
+/**
+ * @class GaussPattersonRule
+ *
+ * Each rule adds optimally placed nodes to the previous one, starting from the 3-points Gauss-Legendre rule, for
+ * @f$ n = 1, 3, 7, \dots, 511 @f$: the number of nodes is rounded down to the closest of these orders.
+ *
+ * @brief Class derived from @ref TruncatedRule providing the nested Gauss-Patterson rules.
+ *
+ */
+class GaussPattersonRule : public TruncatedRule
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the number of nodes).
+         */
+        GaussPattersonRule() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] nNodes    : the maximum number of nodes to be used for the quadrature rule;
+         * @param[in] halfWidth : the half-width of the integration interval.
+         */
+        GaussPattersonRule(const Index &, const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~GaussPattersonRule() = default;
+        
+        virtual Index next_order() const override;
+        
+    protected:
+        virtual void apply_reference() override;
+        
+    private:
+        /**
+         * @brief Round a number of nodes down to the closest nested order.
+         * @param[in] nNodes : the number of nodes.
+         * @returns the order.
+         */
+        static Index order(const Index &);
+};
+
+/**
+ * @class GaussLegendreRule
+ *
+ * @brief Class derived from @ref TruncatedRule providing the Gauss-Legendre rule.
+ *
+ */
+class GaussLegendreRule : public TruncatedRule
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the number of nodes).
+         */
+        GaussLegendreRule() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] nNodes    : the number of nodes to be used for the quadrature rule;
+         * @param[in] halfWidth : the half-width of the integration interval.
+         */
+        GaussLegendreRule(const Index &, const Real &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~GaussLegendreRule() = default;
+        
+    protected:
+        virtual void apply_reference() override;
 };
 
 // Implementations.
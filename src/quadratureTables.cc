@@ -0,0 +1,649 @@
+/* C++11 */
+
+/**
+ * @file   quadratureTables.cc
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ * @brief Embedded nodes and weights of the Gauss-Hermite and Gauss-Laguerre rules of common orders.
+ *
+ */
+
+#include "quadratureRule.h"
+
+// Computed by GaussHermiteRule::apply_iterative_algorithm() and GaussLaguerreRule::apply_iterative_algorithm()
+// (GaussLaguerreRule::apply_using_eigendecomposition() for 201 nodes, where the iterative algorithm does not converge),
+// printed with 17 significant digits so that they are read back exactly.
+namespace
+{
+    const Real hermiteNodes21[21] =
+    {
+        -5.5503518732646775, -4.7739923434112166, -4.1219955474918368,
+        -3.5319728771376773, -2.9799912077045994, -2.4535521245128371,
+        -1.9449629491862543, -1.4489342506507319, -0.96149963441836916,
+        -0.47945070707910775, 0, 0.47945070707910775,
+        0.96149963441836928, 1.4489342506507326, 1.9449629491862541,
+        2.4535521245128376, 2.979991207704598, 3.5319728771376773,
+        4.1219955474918377, 4.7739923434112184, 5.5503518732646793
+    };
+    
+    const Real hermiteWeights21[21] =
+    {
+        3.7203650701360303e-14, 8.8186112420498143e-11, 2.5712301800593597e-08,
+        2.1718848980566699e-06, 7.4783988673100737e-05, 0.0012549820417264135,
+        0.011414065837434368, 0.0601796466589124, 0.19212032406699769,
+        0.38166907361350189, 0.47902370312017639, 0.38166907361350216,
+        0.19212032406699786, 0.060179646658912324, 0.01141406583743439,
+        0.0012549820417264116, 7.478398867310071e-05, 2.1718848980566864e-06,
+        2.5712301800593187e-08, 8.8186112420497432e-11, 3.720365070136036e-14
+    };
+    
+    const Real hermiteNodes41[41] =
+    {
+        -8.2130008955982774, -7.5289454645396221, -6.9603584006367427,
+        -6.4509845971747604, -5.9793650041651345, -5.5344413406134452,
+        -5.1095696265331316, -4.7003568963041173, -4.3036987671546472,
+        -3.9172898548377835, -3.5393499373637121, -3.1684594539419857,
+        -2.8034549614843169, -2.4433595531234107, -2.087334681918724,
+        -1.7346456088220297, -1.3846357891600329, -1.0367072529242065,
+        -0.69030505233020822, -0.34490446301543271, 0,
+        0.34490446301543215, 0.69030505233020767, 1.0367072529242061,
+        1.3846357891600329, 1.7346456088220275, 2.0873346819187248,
+        2.4433595531234102, 2.8034549614843187, 3.1684594539419861,
+        3.5393499373637112, 3.9172898548377821, 4.3036987671546481,
+        4.7003568963041165, 5.1095696265331316, 5.5344413406134425,
+        5.9793650041651381, 6.4509845971747577, 6.9603584006367383,
+        7.5289454645396159, 8.2130008955982738
+    };
+    
+    const Real hermiteWeights41[41] =
+    {
+        4.0019596646666513e-30, 1.4726537286520322e-25, 4.8687379360130391e-22,
+        4.1234085375313478e-19, 1.3569875295860884e-16, 2.1629872471750269e-14,
+        1.9103833646808909e-12, 1.0226798927782075e-10, 3.535681648380775e-09,
+        8.2726584187497555e-08, 1.3573781404870903e-06, 1.6055965736677169e-05,
+        0.00013993025659674217, 0.00091423425632871215, 0.0045403929873032286,
+        0.017330881362116839, 0.051289872397094767, 0.11848439124684432,
+        0.21473086449008433, 0.30636781693785059, 0.34482208361639005,
+        0.30636781693785242, 0.21473086449008438, 0.11848439124684386,
+        0.05128987239709458, 0.017330881362116839, 0.0045403929873032217,
+        0.00091423425632871649, 0.00013993025659674127, 1.6055965736677268e-05,
+        1.3573781404870671e-06, 8.2726584187498866e-08, 3.5356816483806571e-09,
+        1.0226798927782102e-10, 1.9103833646808965e-12, 2.1629872471750212e-14,
+        1.3569875295860643e-16, 4.1234085375314633e-19, 4.8687379360130655e-22,
+        1.4726537286521337e-25, 4.0019596646666121e-30
+    };
+    
+    const Real hermiteNodes101[101] =
+    {
+        -13.478146515232785, -12.896479974039583, -12.416513788721428,
+        -11.989406490998295, -11.596509802200332, -11.228218466075544,
+        -10.878773272902116, -10.544381021362536, -10.222377409009624,
+        -9.9108010025237689, -9.6081549747716082, -9.3132641171485862,
+        -9.0251841867359968, -8.743141845935412, -8.4664934056489916,
+        -8.1946956148339645, -7.9272844408189806, -7.6638593097942556,
+        -7.4040711750779726, -7.1476133293942006, -6.8942142232839023,
+        -6.6436317759717145, -6.3956488139470409, -6.1500693736430243,
+        -5.9067156746204965, -5.6654256190158092, -5.4260507083580025,
+        -5.1884542945483902, -4.9525101007153678, -4.718100961764323,
+        -4.4851177450803679, -4.2534584199474192, -4.0230272504840547,
+        -3.7937340917372735, -3.5654937723650533, -3.33822555032696,
+        -3.1118526303762439, -2.8863017340447317, -2.6615027143383947,
+        -2.4373882085955412, -2.2138933239623539, -1.9909553507579976,
+        -1.7685134996706846, -1.5465086592745159, -1.3248831708071223,
+        -1.1035806175170302, -0.88254562619156551, -0.66172367872096161,
+        -0.44106093175132632, -0.2205040426343027, 0,
+        0.22050404263430215, 0.44106093175132621, 0.6617236787209605,
+        0.88254562619156685, 1.1035806175170308, 1.3248831708071211,
+        1.5465086592745165, 1.7685134996706851, 1.9909553507580018,
+        2.2138933239623531, 2.4373882085955363, 2.6615027143383929,
+        2.8863017340447348, 3.1118526303762466, 3.338225550326956,
+        3.5654937723650519, 3.7937340917372713, 4.0230272504840556,
+        4.2534584199474237, 4.485117745080367, 4.7181009617643248,
+        4.9525101007153607, 5.1884542945483885, 5.4260507083579999,
+        5.6654256190158065, 5.9067156746204912, 6.1500693736430216,
+        6.3956488139470409, 6.6436317759717136, 6.8942142232838997,
+        7.1476133293942068, 7.4040711750779824, 7.6638593097942573,
+        7.9272844408189815, 8.1946956148339609, 8.4664934056489827,
+        8.743141845935412, 9.0251841867359932, 9.3132641171485879,
+        9.6081549747716117, 9.9108010025237672, 10.222377409009644,
+        10.544381021362536, 10.87877327290213, 11.228218466075546,
+        11.596509802200339, 11.989406490998292, 12.41651378872143,
+        12.896479974039577, 13.478146515232785
+    };
+    
+    const Real hermiteWeights101[101] =
+    {
+        8.5904310231110442e-80, 3.0371816846680722e-73, 4.9809124279561263e-68,
+        1.52242947748721e-63, 1.4982961830543443e-59, 6.3278572616262709e-56,
+        1.3661743924144158e-52, 1.6945475116307864e-49, 1.3119398711363678e-46,
+        6.7430272036887769e-44, 2.4125325785225185e-41, 6.2381218594752294e-39,
+        1.2015973481339838e-36, 1.7677477939830939e-34, 2.0280915379277281e-32,
+        1.8467949790115907e-30, 1.355080893345969e-28, 8.1168066229505418e-27,
+        4.0142573977670642e-25, 1.6555633107938983e-23, 5.7440707561475055e-22,
+        1.6897039658923309e-20, 4.2436086794047554e-19, 9.1557867438887533e-18,
+        1.7065546359369429e-16, 2.7618433228959992e-15, 3.8986379094131416e-14,
+        4.82011569430384e-13, 5.2391878407491933e-12, 5.0236198872008756e-11,
+        4.2625383198445706e-10, 3.2096074629922827e-09, 2.1502703382505953e-08,
+        1.2847504869574988e-07, 6.860664083329768e-07, 3.2808733242413684e-06,
+        1.4075589850899725e-05, 5.4263099453547413e-05, 0.00018825409449540768,
+        0.00058852552673757316, 0.0016599244925103317, 0.0042284362004214445,
+        0.0097376438372709841, 0.020289684052787822, 0.038279047715437692,
+        0.065430893699439399, 0.10138360090162959, 0.14246231456883643,
+        0.18160258790818007, 0.21005593297000172, 0.22049524037272136,
+        0.21005593297000111, 0.18160258790818073, 0.14246231456883618,
+        0.1013836009016303, 0.065430893699438913, 0.038279047715437442,
+        0.020289684052787828, 0.0097376438372710605, 0.0042284362004214298,
+        0.0016599244925102983, 0.00058852552673756709, 0.00018825409449540936,
+        5.4263099453547948e-05, 1.4075589850899542e-05, 3.2808733242413451e-06,
+        6.8606640833298855e-07, 1.2847504869574847e-07, 2.1502703382505453e-08,
+        3.2096074629923489e-09, 4.262538319844431e-10, 5.0236198872008407e-11,
+        5.2391878407493678e-12, 4.8201156943037562e-13, 3.8986379094132912e-14,
+        2.7618433228959953e-15, 1.7065546359370582e-16, 9.155786743888781e-18,
+        4.2436086794049557e-19, 1.6897039658923968e-20, 5.7440707561482409e-22,
+        1.6555633107936906e-23, 4.0142573977669108e-25, 8.1168066229506852e-27,
+        1.3550808933459793e-28, 1.8467949790117656e-30, 2.0280915379280313e-32,
+        1.7677477939830565e-34, 1.2015973481338136e-36, 6.2381218594749253e-39,
+        2.4125325785222871e-41, 6.7430272036881197e-44, 1.3119398711361873e-46,
+        1.6945475116308658e-49, 1.3661743924143511e-52, 6.327857261625551e-56,
+        1.4982961830542222e-59, 1.5224294774873851e-63, 4.9809124279555119e-68,
+        3.037181684669109e-73, 8.5904310231106352e-80
+    };
+    
+    const Real hermiteNodes201[201] =
+    {
+        -19.389700399580889, -18.873792307415776, -18.449365785861605,
+        -18.072687219535478, -17.727041738177377, -17.403813326535563,
+        -17.09783297672454, -16.80569491852345, -16.525006517841497,
+        -16.254006346331543, -15.991350486412063, -15.735984233849507,
+        -15.487060726590332, -15.24388701424407, -15.005886999700337,
+        -14.772575193446759, -14.54353764272193, -14.31841776495685,
+        -14.096905620463145, -13.878729651465072, -13.663650224917546,
+        -13.451454517758943, -13.241952416943384, -13.034973197393715,
+        -12.830362803901396, -12.627981607333407, -12.427702537264961,
+        -12.229409516242065, -12.032996137889, -11.838364543760028,
+        -11.64542446340479, -11.454092389412825, -11.264290864817289,
+        -11.075947864600122, -10.888996256458576, -10.703373328690054,
+        -10.519020375198629, -10.335882329345463, -10.153907439751041,
+        -9.9730469822814278, -9.7932550033673333, -9.6144880905584991,
+        -9.4367051668350008, -9.2598673057127581, -9.0839375646076519,
+        -8.9088808342820442, -8.7346637024971709, -8.5612543302496906,
+        -8.388622339184808, -8.2167387089611488, -8.0455756834986545,
+        -7.8751066851732912, -7.7053062361371749, -7.5361498860410716,
+        -7.3676141455213919, -7.1996764248871887, -7.0323149775068128,
+        -6.865508847449731, -6.6992378209872134, -6.5334823815987928,
+        -6.368223668168012, -6.203443436084437, -6.0391240209973249,
+        -5.8752483049923327, -5.7117996849848893, -5.5487620431439337,
+        -5.3861197191777492, -5.2238574843292094, -5.0619605169418396,
+        -4.9004143794708712, -4.7392049968245651, -4.5783186359312289,
+        -4.4177418864364153, -4.2574616424426956, -4.0974650852120877,
+        -3.9377396667574311, -3.7782730942550149, -3.6190533152162492,
+        -3.4600685033608229, -3.3013070451381612, -3.1427575268480568,
+        -2.9844087223147988, -2.8262495810723625, -2.6682692170211881,
+        -2.5104568975196901, -2.3528020328760473, -2.1952941662079919,
+        -2.037922963640185, -1.8806782048107522, -1.7235497736598804,
+        -1.5665276494750051, -1.4096018981683398, -1.2527626637636353,
+        -1.0960001600701108, -0.9393046625223993, -0.78266650016614603,
+        -0.62607604776958259, -0.46952371804202964, -0.31299995394072982,
+        -0.15649522104787691, 0, 0.15649522104787886,
+        0.31299995394073082, 0.46952371804202914, 0.62607604776958203,
+        0.78266650016614547, 0.9393046625223993, 1.0960001600701095,
+        1.2527626637636351, 1.4096018981683411, 1.5665276494750044,
+        1.723549773659877, 1.8806782048107522, 2.0379229636401845,
+        2.1952941662079879, 2.3528020328760491, 2.5104568975196888,
+        2.6682692170211877, 2.8262495810723651, 2.984408722314797,
+        3.1427575268480532, 3.3013070451381568, 3.4600685033608229,
+        3.6190533152162492, 3.7782730942550122, 3.9377396667574369,
+        4.0974650852120913, 4.2574616424426868, 4.4177418864364189,
+        4.5783186359312316, 4.7392049968245589, 4.9004143794708783,
+        5.0619605169418422, 5.2238574843292147, 5.3861197191777501,
+        5.5487620431439266, 5.7117996849848947, 5.8752483049923354,
+        6.0391240209973294, 6.2034434360844388, 6.3682236681680209,
+        6.5334823815987919, 6.6992378209872143, 6.8655088474497186,
+        7.0323149775068208, 7.1996764248871932, 7.3676141455213973,
+        7.5361498860410645, 7.7053062361371669, 7.8751066851732991,
+        8.0455756834986634, 8.2167387089611328, 8.3886223391848098,
+        8.5612543302497031, 8.7346637024971763, 8.90888083428203,
+        9.0839375646076554, 9.2598673057127439, 9.4367051668350008,
+        9.6144880905584973, 9.7932550033673316, 9.9730469822814172,
+        10.153907439751039, 10.335882329345452, 10.519020375198627,
+        10.703373328690049, 10.888996256458567, 11.07594786460011,
+        11.264290864817291, 11.454092389412823, 11.645424463404783,
+        11.838364543760028, 12.032996137889, 12.229409516242065,
+        12.427702537264967, 12.627981607333421, 12.830362803901382,
+        13.034973197393727, 13.241952416943391, 13.451454517758938,
+        13.663650224917561, 13.878729651465077, 14.096905620463126,
+        14.318417764956846, 14.543537642721926, 14.772575193446762,
+        15.005886999700344, 15.243887014244075, 15.487060726590341,
+        15.735984233849505, 15.991350486412033, 16.254006346331526,
+        16.525006517841508, 16.80569491852345, 17.09783297672454,
+        17.403813326535584, 17.727041738177409, 18.072687219535489,
+        18.449365785861595, 18.873792307415808, 19.389700399580864
+    };
+    
+    const Real hermiteWeights201[201] =
+    {
+        3.1562517583894259e-164, 9.0526238091503987e-156, 5.937864194931428e-149,
+        5.0735059552068412e-143, 1.1136527448966465e-137, 8.9575351731420744e-133,
+        3.2750227475503839e-128, 6.2819007379605987e-124, 6.9973586595855019e-120,
+        4.8805627713846743e-116, 2.2586151270218151e-112, 7.2595704276303107e-109,
+        1.6815784569484758e-105, 2.8937388591396679e-102, 3.7946083254973437e-99,
+        3.8741774557862936e-96, 3.136867402307368e-93, 2.0466160491825886e-90,
+        1.0910333528599074e-87, 4.810724616291161e-85, 1.7735961903152799e-82,
+        5.5202499960124242e-80, 1.463100647454067e-77, 3.3279663991193922e-75,
+        6.5422636431935467e-73, 1.1186553239691208e-70, 1.6734528425763197e-68,
+        2.2018825019746187e-66, 2.5607238592326459e-64, 2.6440833153716292e-62,
+        2.4340913458303777e-60, 2.0054834750523316e-58, 1.4841307950773957e-56,
+        9.8977782152848138e-55, 5.9670392331422625e-53, 3.2612915434553572e-51,
+        1.6203268360099391e-49, 7.3366283150907656e-48, 3.0346048519413359e-46,
+        1.1491803817955681e-44, 3.9926958727707862e-43, 1.2752494017965923e-41,
+        3.7513292093569451e-40, 1.0181263532846374e-38, 2.55369024993034e-37,
+        5.9288387876457597e-36, 1.2760119323095491e-34, 2.549404052357623e-33,
+        4.7348391290847973e-32, 8.1848140340890701e-31, 1.3184884690185964e-29,
+        1.9815674946494981e-28, 2.7815267338689984e-27, 3.6505090675374865e-26,
+        4.483858714734853e-25, 5.1593009993587671e-24, 5.5662568491026313e-23,
+        5.6356480447889673e-22, 5.3590811701246408e-21, 4.7900929988064069e-20,
+        4.0274529625868022e-19, 3.1875790975697327e-18, 2.3764705036632568e-17,
+        1.6700461495679789e-16, 1.1069294798213578e-15, 6.9241349043181266e-15,
+        4.0898949160252582e-14, 2.2824203882098039e-13, 1.2040404203722577e-12,
+        6.0070774138403214e-12, 2.8357440707651636e-11, 1.2672079162423699e-10,
+        5.3628049672922848e-10, 2.1501899112992582e-09, 8.1709248152444672e-09,
+        2.9439866509197299e-08, 1.006058807191444e-07, 3.2619610450864725e-07,
+        1.0037822809124081e-06, 2.9324853170331705e-06, 8.135624351158094e-06,
+        2.1439809993580935e-05, 5.3682850741114259e-05, 0.00012774322140543106,
+        0.00028895119870850556, 0.00062142101335954756, 0.0012708857822152869,
+        0.0024720920285823929, 0.0045743857110592534, 0.0080533709785226785,
+        0.013491507441538722, 0.021509810400463514, 0.032640439369183954,
+        0.047147997687033295, 0.064833207722168718, 0.084877502519352194,
+        0.10579790032413799, 0.12556661418771642, 0.14190643558186727,
+        0.15271218047550708, 0.15649363599087493, 0.15271218047550941,
+        0.14190643558186736, 0.12556661418771595, 0.10579790032413727,
+        0.084877502519353137, 0.064833207722168634, 0.047147997687033177,
+        0.032640439369183989, 0.021509810400463642, 0.013491507441538332,
+        0.0080533709785230306, 0.0045743857110591216, 0.0024720920285824293,
+        0.0012708857822153279, 0.00062142101335954788, 0.00028895119870850925,
+        0.00012774322140542949, 5.3682850741113812e-05, 2.143980999358058e-05,
+        8.1356243511583871e-06, 2.9324853170330896e-06, 1.0037822809124168e-06,
+        3.2619610450865705e-07, 1.0060588071914739e-07, 2.9439866509195829e-08,
+        8.1709248152448957e-09, 2.150189911299247e-09, 5.3628049672920883e-10,
+        1.2672079162423353e-10, 2.8357440707652486e-11, 6.0070774138401364e-12,
+        1.2040404203722563e-12, 2.2824203882097382e-13, 4.0898949160252916e-14,
+        6.9241349043181637e-15, 1.1069294798212513e-15, 1.6700461495681419e-16,
+        2.3764705036632149e-17, 3.1875790975693175e-18, 4.027452962586923e-19,
+        4.7900929988062431e-20, 5.3590811701245572e-21, 5.6356480447898841e-22,
+        5.5662568491022705e-23, 5.1593009993588369e-24, 4.4838587147341248e-25,
+        3.6505090675382166e-26, 2.7815267338692122e-27, 1.9815674946492223e-28,
+        1.318488469018356e-29, 8.1848140340896482e-31, 4.7348391290845838e-32,
+        2.5494040523576063e-33, 1.2760119323095756e-34, 5.9288387876453808e-36,
+        2.5536902499305213e-37, 1.0181263532846312e-38, 3.7513292093571392e-40,
+        1.2752494017966239e-41, 3.9926958727704445e-43, 1.1491803817958215e-44,
+        3.0346048519411633e-46, 7.3366283150917306e-48, 1.6203268360099614e-49,
+        3.2612915434553649e-51, 5.9670392331421958e-53, 9.8977782152852383e-55,
+        1.4841307950772291e-56, 2.0054834750523532e-58, 2.4340913458304515e-60,
+        2.6440833153713356e-62, 2.5607238592322148e-64, 2.201882501974872e-66,
+        1.6734528425761255e-68, 1.1186553239691245e-70, 6.5422636431945432e-73,
+        3.3279663991188345e-75, 1.4631006474538817e-77, 5.5202499960128362e-80,
+        1.7735961903144504e-82, 4.8107246162905849e-85, 1.0910333528602491e-87,
+        2.0466160491826732e-90, 3.1368674023074944e-93, 3.8741774557849721e-96,
+        3.7946083254968353e-99, 2.8937388591389058e-102, 1.6815784569487496e-105,
+        7.2595704276296584e-109, 2.258615127022707e-112, 4.880562771383896e-116,
+        6.9973586595842513e-120, 6.281900737959382e-124, 3.2750227475495013e-128,
+        8.9575351731385191e-133, 1.1136527448961209e-137, 5.0735059552092329e-143,
+        5.9378641949338158e-149, 9.0526238091485294e-156, 3.156251758390578e-164
+    };
+    
+    const Real laguerreNodes21[21] =
+    {
+        0.067257817923161378, 0.35477289532351153, 0.87366016677864267,
+        1.6268699419292101, 2.6186264105455437, 3.8546521381097594,
+        5.3423692806224334, 7.0911688132196744, 9.1127788542697044,
+        11.421771762378382, 14.036270697873757, 16.978952692783839,
+        20.278509414993742, 23.971845587151478, 28.107528600944306,
+        32.75149741056083, 37.997187819260951, 43.985245757142216,
+        50.947351189939923, 59.325994120229993, 70.25568862801893
+    };
+    
+    const Real laguerreWeights21[21] =
+    {
+        0.16142010018162639, 0.28249356458300406, 0.26525457551389942,
+        0.17131939639002966, 0.081126625892353629, 0.028816301767769451,
+        0.0077342394261187535, 0.0015674813904211881, 0.00023842265876341376,
+        2.6930073439686174e-05, 2.224790793645048e-06, 1.3173344974323318e-07,
+        5.4439522906464397e-09, 1.5163662051980595e-10, 2.7178831180589081e-12,
+        2.9425193540719282e-14, 1.759074035797724e-16, 5.0738022271720226e-19,
+        5.6597208703242246e-22, 1.6062609247993011e-25, 4.0441339271159632e-30
+    };
+    
+    const Real laguerreNodes41[41] =
+    {
+        0.034840064125237998, 0.18362508701664013, 0.45152505890551453,
+        0.83898561090793589, 1.3465759433078663, 1.9750399593501595,
+        2.7253067120730909, 3.5984989447979374, 4.5959428494954162,
+        5.71917969983466, 6.9699797131065839, 8.3503584847075949,
+        9.8625963957096552, 11.509261481920799, 13.293236368102452,
+        15.21775001864135, 17.286415245392345, 19.503273158378228,
+        21.872846064998996, 24.400200745895848, 27.091024600043561,
+        29.951717915215347, 32.98950656703532, 36.212580906969976,
+        39.630268660325761, 43.253252621717827, 47.093848290141175,
+        51.166363119549537, 55.487569107236475, 60.077336323317191,
+        64.9595008936776, 70.163084782414742, 75.724062085620901,
+        81.688010100019284, 88.114266280378672, 95.082812148282216,
+        102.70650166143909, 111.15492195872507, 120.70758256104158,
+        131.89975436227675, 146.11059744790361
+    };
+    
+    const Real laguerreWeights41[41] =
+    {
+        0.086355457019627477, 0.17333264559281003, 0.20856810393811082,
+        0.19335043020738654, 0.14772439433378401, 0.095629739495860094,
+        0.053176120273960195, 0.025588234242358756, 0.010698917660935947,
+        0.0038952384980019041, 0.001235886732107797, 0.00034168442854353381,
+        8.2245180205395253e-05, 1.7211063999583748e-05, 3.1250322471539833e-06,
+        4.9109498448310277e-07, 6.6593957582695719e-08, 7.7647953893568222e-09,
+        7.7531616961496683e-10, 6.598561320002692e-11, 4.7612627552256095e-12,
+        2.8950494277634991e-13, 1.4731326575631546e-14, 6.2236729505434028e-16,
+        2.1634252311100971e-17, 6.1236667938487799e-19, 1.3945573811139256e-20,
+        2.5196591386393852e-22, 3.5530244291389247e-24, 3.834892567643317e-26,
+        3.0950289934154588e-28, 1.8154561559621186e-30, 7.47169937643697e-33,
+        2.0634897669131546e-35, 3.6087617454481966e-38, 3.6966891223871497e-41,
+        1.9874119878765355e-44, 4.757520318034168e-48, 3.872486201447042e-52,
+        6.4213171358479657e-57, 5.9121518360542813e-63
+    };
+    
+    const Real laguerreNodes101[101] =
+    {
+        0.014244409377540639, 0.075056691965545527, 0.18447795106816869,
+        0.34255871725655901, 0.54933990398372434, 0.80487191409564218,
+        1.1092164972355991, 1.4624471654800322, 1.8646493799966239,
+        2.3159206949694222, 2.8163709003532937, 3.3661221754565331,
+        3.9653092576879017, 4.6140796284734327, 5.3125937175691815,
+        6.0610251267349771, 6.8595608736681344, 7.7084016571113381,
+        8.6077621441033827, 9.557871280417011, 10.55897262531826,
+        11.611324711883491, 12.715201434222148, 13.870892463076316,
+        15.078703691402199, 16.338957711684735, 17.651994326896453,
+        19.018171097186109, 20.437863924573751, 21.911467678138287,
+        23.439396862413737, 25.022086331963425, 26.659992055380123,
+        28.353591932267971, 30.103386667102352, 31.909900704240567,
+        33.773683228774338, 35.695309238379792, 37.675380691837702,
+        39.714527740473706, 41.813410049412575, 43.972718216262251,
+        46.193175295652239, 48.475538438960029, 50.820600659582936,
+        53.229192735267397, 55.702185260313364, 58.240490861950732,
+        60.845066596864413, 63.516916545756828, 66.257094626017931,
+        69.066707645067737, 71.946918619797586, 74.898950390825632,
+        77.924089564074649, 81.023690816564965, 84.19918160840102,
+        87.452067348845233, 90.783937071277194, 94.196469679920767,
+        97.691440840722606, 101.27073059997174, 104.93633182751864,
+        108.69035959722702, 112.53506163612464, 116.47282999630519,
+        120.50621413084507, 124.63793558794765, 128.8709045776296,
+        133.2082387143401, 137.65328429931384, 142.20964058127598,
+        146.88118752738407, 151.67211775336852, 156.58697340988198,
+        161.6306890107665, 166.8086414314896, 172.12670862057814,
+        177.5913389788694, 183.20963390664247, 188.98944674850139,
+        194.93950235479466, 201.06954283638876, 207.39050698197534,
+        213.91475348661493, 220.65634200197329, 227.63139169437423,
+        234.85854552251934, 242.35958157134533, 250.16023355018908,
+        258.29131649269374, 266.79031117005877, 275.70366230096295,
+        285.09023435771849, 295.02674112288986, 305.61675608014457,
+        317.00675446778928, 329.41749157875961, 343.21413345969347,
+        359.09910198261309, 378.89229997476201
+    };
+    
+    const Real laguerreWeights101[101] =
+    {
+        0.036039151841951569, 0.078950513232168479, 0.11121387525366551,
+        0.12951181136410342, 0.13344843554187213, 0.12516802779249248,
+        0.10843547028757117, 0.087501525495788393, 0.066120410908759419,
+        0.04695379267362166, 0.031411638207939532, 0.019831733223485862,
+        0.011831505209298866, 0.0066763952891404294, 0.0035659397916611322,
+        0.0018036953843392873, 0.00086432126392953701, 0.00039248834921644642,
+        0.00016892546338338524, 6.891674357229727e-05, 2.6652168761708047e-05,
+        9.7703851880655491e-06, 3.3949585820643402e-06, 1.1180332721867891e-06,
+        3.4890678356027121e-07, 1.0316207285217252e-07, 2.8893075240290717e-08,
+        7.6634442955828736e-09, 1.9243815831807699e-09, 4.5736522330624701e-10,
+        1.0284787852319441e-10, 2.1874147866299235e-11, 4.3984722901823121e-12,
+        8.358469072521435e-13, 1.5004202099232888e-13, 2.5430517928753624e-14,
+        4.0675790782005774e-15, 6.1365590108289446e-16, 8.7272710428299213e-17,
+        1.1693370586727538e-17, 1.4751555406435236e-18, 1.7510054978152816e-19,
+        1.9542880302583241e-20, 2.0493927142028559e-21, 2.0177403169322053e-22,
+        1.8636300964311934e-23, 1.6133981849985403e-24, 1.3080523222438854e-25,
+        9.9221306042295443e-27, 7.0348492589061376e-28, 4.6572169622205599e-29,
+        2.8757325286216131e-30, 1.6543398249929097e-31, 8.8559032050925084e-33,
+        4.4057792120766145e-34, 2.0342975363223582e-35, 8.7055565404969859e-37,
+        3.4476524549322317e-38, 1.2615762744172692e-39, 4.2583942086829336e-41,
+        1.3236031728790021e-42, 3.7813021128033028e-44, 9.9092277418700104e-46,
+        2.3770780712492829e-47, 5.2081715663287267e-49, 1.0397668169304857e-50,
+        1.8866794214575903e-52, 3.1031310820772411e-54, 4.6130581805681639e-56,
+        6.1790546347117077e-58, 7.4329004741657239e-60, 8.0010620863815903e-62,
+        7.6774838375246106e-64, 6.5398286542732991e-66, 4.9230444094625654e-68,
+        3.2590866473140708e-70, 1.8872842917382597e-72, 9.5044493432981735e-75,
+        4.1360755222207212e-77, 1.5444176952542599e-79, 4.9099346452562482e-82,
+        1.3175489433807546e-84, 2.9556063184110566e-87, 5.4828993219432956e-90,
+        8.3089040899026858e-93, 1.0143868139621494e-95, 9.8189214424658267e-99,
+        7.3980512058436399e-102, 4.2463456705594601e-105, 1.8101604007629862e-108,
+        5.5591726732189237e-112, 1.185321998342218e-115, 1.6761550874871934e-119,
+        1.4834471457491775e-123, 7.6198578209442726e-128, 2.0519793247761372e-132,
+        2.5096585036654418e-137, 1.1234977318632506e-142, 1.2901159347851589e-148,
+        1.925242028024313e-155, 6.5408598407927698e-164
+    };
+    
+    const Real laguerreNodes201[201] =
+    {
+        0.0071751826169017636, 0.037806088718215884, 0.09291539417975786,
+        0.17251868826926683, 0.27662231012791144, 0.40523294956720074,
+        0.55835855163970527, 0.73600848744122416, 0.93819360193063261,
+        1.1649262324243768, 1.4162202185189834, 1.6920909092714858,
+        1.9925551695786932, 2.3176313864902225, 2.6673394757654898,
+        3.0417008888167563, 3.4407386201108419, 3.8644772150685971,
+        4.3129427784880567, 4.7861629835074897, 5.2841670811215522,
+        5.8069859102629939, 6.354651908459485, 6.9271991230763543,
+        7.5246632231558159, 8.1470815118630568, 8.7944929395502207,
+        9.4669381174501712, 10.164459332011623, 10.887100559888459,
+        11.634907483596365, 12.407927507850822, 13.20620977660084,
+        14.029805190773416, 14.878766426745367, 15.753147955558564,
+        16.653006062896242, 17.578398869839194, 18.529386354420193,
+        19.506030373997575, 20.508394688468307, 21.536544984343006,
+        22.590548899705539, 23.67047605008117, 24.776398055238847,
+        25.908388566953132, 27.066523297753967, 28.250880050691958,
+        29.461538750150307, 30.698581473733555, 31.962092485266403,
+        33.252158268937137, 34.568867564620277, 35.912311404416918,
+        37.282583150451053, 38.67977853396286, 40.103995695742128,
+        41.555335227945157, 43.033900217343252, 44.539796290050553,
+        46.073131657782632, 47.634017165699071, 49.222566341886626,
+        50.838895448540036, 52.483123534903271, 54.155372492034388,
+        55.855767109461709, 57.584435133801243, 59.341507329409545,
+        61.127117541149346, 62.941402759349117, 64.784503187040642,
+        66.656562309565899, 68.557726966645106, 70.488147427004833,
+        72.447977465670263, 74.437374444028464, 76.456499392779193,
+        78.505517097890348, 80.584596189686295, 82.693909235200792,
+        84.833632833934331, 87.003947717163115, 89.205038850953969,
+        91.437095543049068, 93.700311553792076, 95.994885211276383,
+        98.32101953090951, 100.67892233959117, 103.06880640472259,
+        105.49088956827048, 107.94539488612338, 110.43255077299274,
+        112.95259115312734, 115.50575561711746, 118.09228958509509,
+        120.71244447663926, 123.36647788772801, 126.05465377508828,
+        128.77724264832526, 131.53452177022828, 134.32677536568423,
+        137.15429483964644, 140.01737900464406, 142.91633431834518,
+        145.85147513171799, 148.82312394837302, 151.83161169570852,
+        154.87727800852002, 157.96047152578271, 161.08155020136141,
+        164.24088162945944, 167.43884338566781, 170.67582338454474,
+        173.95222025471611, 177.2684437325656, 180.62491507565122,
+        184.02206749708566, 187.46034662219245, 190.94021096886368,
+        194.46213245315036, 198.02659692173151, 201.63410471304627,
+        205.28517124900847, 208.98032765938422, 212.72012144107777,
+        216.50511715476745, 220.33589716152457, 224.21306240229077,
+        228.13723322331899, 232.10905025097492, 236.12917531958456,
+        240.19829245635012, 244.31710892773179, 248.48635635208862,
+        252.70679188384045, 256.9791994749018, 261.30439121971136,
+        265.68320879079914, 270.11652497252703, 274.60524530143363,
+        279.15030982247441, 283.75269497142529, 288.41341559485392,
+        293.13352712025056, 297.91412789037776, 302.75636167742744,
+        307.66142039442212, 312.63054702330493, 317.66503878151781,
+        322.76625055151135, 327.93559860068109, 333.1745646227065,
+        338.48470013528384, 343.86763127389338, 349.32506402655588,
+        354.85878996079617, 360.47069250122399, 366.16275382460037,
+        371.93706244914904, 377.79582160649602, 383.74135849833351,
+        389.77613455616523, 395.90275684181336, 402.12399074944227,
+        408.44277419756202, 414.86223353283486, 421.38570140796469,
+        428.01673694514739, 434.75914855685875, 441.6170198699636,
+        448.59473929108083, 455.69703386584865, 462.92900822872048,
+        470.29618962215403, 477.80458019636978, 485.46071809959432,
+        493.27174925639764, 501.24551223961691, 509.39063931391217,
+        517.71667762957998, 526.2342357661496, 534.95516250274648,
+        543.89276703074779, 553.06209313733495, 562.48026466569036,
+        572.1669265824064, 582.14481654056794, 592.44051808887559,
+        603.08547242844497, 614.11736770610219, 625.58209616821114,
+        637.5365956433036, 650.05312633932203, 663.22599696609484,
+        677.18273837973857, 692.10401880390759, 708.26264310514398,
+        726.11082431004354, 746.52048567939551, 771.7569596545228
+    };
+    
+    const Real laguerreWeights201[201] =
+    {
+        0.018282240161326149, 0.04127480630962431, 0.061378770969123274,
+        0.077297728185162354, 0.088237449082309155, 0.093932924942689983,
+        0.094625225873528701, 0.090973771738246403, 0.08392421681895694,
+        0.074558408525766534, 0.06395216592673586, 0.053060921755623866,
+        0.042644720722729561, 0.033235025662316155, 0.025138247703943691,
+        0.018466106289639243, 0.013181157203016434, 0.009146660608543411,
+        0.0061725009642219376, 0.0040521069004100024, 0.0025883996266423031,
+        0.0016091780056544161, 0.00097381381748908675, 0.00057373480630776503,
+        0.00032912716249710428, 0.00018385625575410017, 0.00010002129057631588,
+        5.2995180453704473e-05, 2.734858484370789e-05, 1.3746984440995366e-05,
+        6.7308372759839743e-06, 3.2101896619283615e-06, 1.4914182298075595e-06,
+        6.7496185172368726e-07, 2.9755747261288214e-07, 1.2778279541196437e-07,
+        5.345388263139739e-08, 2.1781337159237611e-08, 8.6452798592292707e-09,
+        3.342347015246127e-09, 1.2586028906633273e-09, 4.61610287496217e-10,
+        1.6489020943385814e-10, 5.7362523649690386e-11, 1.9433692303841407e-11,
+        6.4114195436083252e-12, 2.0596880016573312e-12, 6.442762370973244e-13,
+        1.962184399483e-13, 5.8180401974308266e-14, 1.6793977409140402e-14,
+        4.7188886104007073e-15, 1.2906342815213485e-15, 3.4356634499829216e-16,
+        8.9007637117961329e-17, 2.2439703843579862e-17, 5.5048156481908463e-18,
+        1.3139097440967031e-18, 3.0510219804915836e-19, 6.8919291966118599e-20,
+        1.514290594626956e-20, 3.2359851772677432e-21, 6.7249224895048039e-22,
+        1.3589538839786014e-22, 2.6699963778890618e-23, 5.0998287516968093e-24,
+        9.4686601427519236e-25, 1.7086657161977231e-25, 2.9964532818831007e-26,
+        5.1060430738745034e-27, 8.4533966013366399e-28, 1.3595324283319961e-28,
+        2.1237318216679655e-29, 3.2218122278692925e-30, 4.7460063595839642e-31,
+        6.7876498467769555e-32, 9.4233954554206859e-33, 1.2697682228287078e-33,
+        1.6603552510487257e-34, 2.1065213000331568e-35, 2.5926621440229777e-36,
+        3.0950408944269624e-37, 3.5830309210598618e-38, 4.021794101954924e-39,
+        4.3761651083909149e-40, 4.6151906964440578e-41, 4.7165360002160721e-42,
+        4.6699001759086026e-43, 4.4787233774037594e-44, 4.1597971795865217e-45,
+        3.7408318057245163e-46, 3.2564682970810677e-47, 2.7435340322551834e-48,
+        2.2364460663546509e-49, 1.763552340028131e-50, 1.3449149861124625e-51,
+        9.9167632589762957e-53, 7.0681061666182218e-54, 4.8683386141762935e-55,
+        3.2395658248070023e-56, 2.0821016534478081e-57, 1.2921230358428239e-58,
+        7.7404681103255597e-60, 4.4746942329144454e-61, 2.4955157580087086e-62,
+        1.3422168142408745e-63, 6.9600359156717858e-65, 3.4784367209506788e-66,
+        1.674920270058187e-67, 7.7676784907941127e-69, 3.4683349513077296e-70,
+        1.4904758247497783e-71, 6.1622603130302498e-73, 2.4501853570786525e-74,
+        9.3654700095387052e-76, 3.4399732962282783e-77, 1.2136502191039892e-78,
+        4.1110987431118978e-80, 1.3364592531634616e-81, 4.1676278423166262e-83,
+        1.2461022261986821e-84, 3.5705904833351591e-86, 9.8001304923293098e-88,
+        2.575172900813259e-89, 6.474915652068748e-91, 1.5569633803712497e-92,
+        3.5784522177980419e-94, 7.8565677025051699e-96, 1.6467646003500636e-97,
+        3.2932373614106144e-99, 6.2795774801771298e-101, 1.1409524366735011e-102,
+        1.9739612566411782e-104, 3.2496594793934817e-106, 5.0868492799873157e-108,
+        7.5656152864161595e-110, 1.0682797414801862e-111, 1.4309349634227351e-113,
+        1.8167073397129597e-115, 2.1842521248754244e-117, 2.4847440636634722e-119,
+        2.6718686552258441e-121, 2.7131937358735557e-123, 2.5992009586025379e-125,
+        2.3465823931280423e-127, 1.9943144633679734e-129, 1.5937444778356929e-131,
+        1.1961771331483762e-133, 8.421442624976515e-136, 5.5543173223935789e-138,
+        3.427221309246675e-140, 1.9756427698271615e-142, 1.062401708374616e-144,
+        5.3212328012126532e-147, 2.478424876991302e-149, 1.0716219487258063e-151,
+        4.2937340951756082e-154, 1.5912634134446616e-156, 5.4438408323694363e-159,
+        1.7156245820489448e-161, 4.9698141667005409e-164, 1.3202406440679474e-166,
+        3.2084639043831047e-169, 7.1145183190083999e-172, 1.4354991918258883e-174,
+        2.6278456858830706e-177, 4.3509615373599695e-180, 6.4941019111139836e-183,
+        8.7069027836678574e-186, 1.0446570699431529e-188, 1.1170825089182065e-191,
+        1.0599923872190082e-194, 8.883512805421166e-198, 6.5422465234208051e-201,
+        4.2105882050325021e-204, 2.354187966741064e-207, 1.1360562328466872e-210,
+        4.6982358350272294e-214, 1.6522040723582573e-217, 4.8984902160136386e-221,
+        1.2128647387357114e-224, 2.4816416900661001e-228, 4.1469968817898146e-232,
+        5.5854656306109323e-236, 5.9735609543074439e-240, 4.9874495553824088e-244,
+        3.1881210599016064e-248, 1.5255050872990676e-252, 5.3220095832214075e-257,
+        1.3121917151292516e-261, 2.2028083861081995e-266, 2.4060086658078778e-271,
+        1.6162692048071686e-276, 6.2176869717288029e-282, 1.2480380045851183e-287,
+        1.1527272001767863e-293, 4.1012836925651959e-300, 4.3000490809054082e-307,
+        8.5332911851412494e-315, 1.4821969375237396e-323, 0
+    };
+}
+
+bool GaussHermiteRule::lookup(const Index & nNodes, VectorXr & nodes, VectorXr & weights)
+{
+    const Real * x = nullptr;
+    const Real * w = nullptr;
+    
+    switch ( nNodes )
+    {
+        case 21:
+            x = hermiteNodes21;
+            w = hermiteWeights21;
+            break;
+            
+        case 41:
+            x = hermiteNodes41;
+            w = hermiteWeights41;
+            break;
+            
+        case 101:
+            x = hermiteNodes101;
+            w = hermiteWeights101;
+            break;
+            
+        case 201:
+            x = hermiteNodes201;
+            w = hermiteWeights201;
+            break;
+            
+        default:
+            return false;
+    }
+    
+    nodes   = Eigen::Map<const VectorXr>(x, nNodes);
+    weights = Eigen::Map<const VectorXr>(w, nNodes);
+    
+    return true;
+}
+
+bool GaussLaguerreRule::lookup(const Index & nNodes, VectorXr & nodes, VectorXr & weights)
+{
+    const Real * x = nullptr;
+    const Real * w = nullptr;
+    
+    switch ( nNodes )
+    {
+        case 21:
+            x = laguerreNodes21;
+            w = laguerreWeights21;
+            break;
+            
+        case 41:
+            x = laguerreNodes41;
+            w = laguerreWeights41;
+            break;
+            
+        case 101:
+            x = laguerreNodes101;
+            w = laguerreWeights101;
+            break;
+            
+        case 201:
+            x = laguerreNodes201;
+            w = laguerreWeights201;
+            break;
+            
+        default:
+            return false;
+    }
+    
+    nodes   = Eigen::Map<const VectorXr>(x, nNodes);
+    weights = Eigen::Map<const VectorXr>(w, nNodes);
+    
+    return true;
+}
@@ -0,0 +1,412 @@
+/* C++11 */
+
+/**
+ * @file   reducedOrder.cc
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ */
+
+#include "reducedOrder.h"
+
+#include <limits>
+
+namespace
+{
+    // Jacobian of the condensed system, as assembled by NonLinearPoisson1D.
+    SparseXr jacobian(const CondensedSystem & system, const VectorXr & dcharge)
+    {
+        SparseXr Jac = system.Stiff;
+        
+        for ( Index i = 0; i < Jac.rows(); ++i )
+        {
+            if ( system.Mass.coeff(i, i) != 0.0 )
+            {
+                Jac.coeffRef(i, i) -= system.Mass.coeff(i, i) * dcharge(i);
+            }
+        }
+        
+        return Jac;
+    }
+    
+    // Solve a tridiagonal system on the rows from first to last by the Thomas algorithm, as DriftDiffusion1D.
+    void solve(const VectorXr & lower, VectorXr & diag, const VectorXr & upper, VectorXr & rhs,
+               const Index & first, const Index & last)
+    {
+        // Forward elimination.
+        for ( Index i = first + 1; i <= last; ++i )
+        {
+            const Real w = lower(i) / diag(i - 1);
+            
+            diag(i) -= w * upper(i - 1);
+            rhs (i) -= w * rhs(i - 1);
+        }
+        
+        // Back substitution.
+        rhs(last) /= diag(last);
+        
+        for ( Index i = last - 1; i >= first; --i )
+        {
+            rhs(i) = ( rhs(i) - upper(i) * rhs(i + 1) ) / diag(i);
+        }
+    }
+}
+
+ReducedPoissonBasis::ReducedPoissonBasis(const ParamList & params, const std::shared_ptr<const PdeSolver1D> & solver,
+                                         const MatrixXr & Phi, const VectorXr & PhiBcorr, const Charge & charge_fun,
+                                         const Real & tolerance, const Index & maxModesNo)
+    : params_(params), solver_(solver)
+{
+    assert( solver_ != nullptr );
+    assert( Phi.cols() > 0 && Phi.cols() == PhiBcorr.size() );
+    assert( tolerance > 0.0 && maxModesNo > 0 );
+    
+    condensed_ = Bim1DCache::condensed(*solver_);
+    
+    const SparseXr & Stiff = condensed_->Stiff;
+    const SparseXr & Mass  = condensed_->Mass ;
+    
+    interfaceNo_ = condensed_->interfaceNo;
+    tail_        = condensed_->tail;
+    
+    nNodes_ = Phi.rows();
+    
+    const Index n  = Stiff.rows();    // Condensed nodes.
+    const Index nI = n - 2;           // Interior condensed nodes.
+    
+    assert( nNodes_ == solver_->Stiff().rows() && nI > 0 );
+    
+    // Snapshots of the potential and of its derivative with respect to the gate voltage,
+    // of the charge and of its derivative, on the interior condensed nodes.
+    MatrixXr states ( nI, 2 * Phi.cols() );
+    MatrixXr charges( nI, 2 * Phi.cols() );
+    
+    SparseLU<SparseXr> systemSolver;
+    
+    for ( Index j = 0; j < Phi.cols(); ++j )
+    {
+        VectorXr phi( n );
+        phi.head(interfaceNo_ + 1) = Phi.col(j).head(interfaceNo_ + 1);
+        phi(n - 1)                 = Phi(nNodes_ - 1, j);
+        
+        VectorXr charge  = charge_fun. charge(phi.array() + constants::V_TH * PhiBcorr(j));
+        VectorXr dcharge = charge_fun.dcharge(phi.array() + PhiBcorr(j));
+        
+        // Derivative of the potential, as in the capacitance computed by NonLinearPoisson1D.
+        SparseXr Jac = jacobian(*condensed_, dcharge);
+        
+        systemSolver.compute( (SparseXr) Jac.block(1, 1, nI, nI) );
+        
+        states.col(2 * j)     = phi.segment(1, nI);
+        states.col(2 * j + 1) = systemSolver.solve( (VectorXr) (- Jac.block(1, n - 1, nI, 1)) );
+        
+        charges.col(2 * j)     = charge .segment(1, nI);
+        charges.col(2 * j + 1) = dcharge.segment(1, nI);
+    }
+    
+    U_ = pod(states, tolerance, maxModesNo);
+    
+    MatrixXr W = pod(charges, tolerance, maxModesNo);
+    
+    // DEIM: greedy selection of the interpolation nodes.
+    const Index nPoints = W.cols();
+    
+    VectorX<Index> points( nPoints );
+    
+    W.col(0).cwiseAbs().maxCoeff( &points(0) );
+    
+    for ( Index l = 1; l < nPoints; ++l )
+    {
+        MatrixXr PW( l, l );
+        VectorXr Pw( l );
+        
+        for ( Index i = 0; i < l; ++i )
+        {
+            PW.row(i) = W.row( points(i) ).head(l);
+            Pw(i)     = W( points(i), l );
+        }
+        
+        VectorXr r = W.col(l) - W.leftCols(l) * PW.partialPivLu().solve(Pw);
+        
+        r.cwiseAbs().maxCoeff( &points(l) );
+    }
+    
+    // Projected operators.
+    MatrixXr PW( nPoints, nPoints );
+    Up_.resize( nPoints, U_.cols() );
+    
+    for ( Index i = 0; i < nPoints; ++i )
+    {
+        PW .row(i) = W .row( points(i) );
+        Up_.row(i) = U_.row( points(i) );
+    }
+    
+    VectorXr massI( nI );
+    
+    for ( Index i = 0; i < nI; ++i )
+    {
+        massI(i) = Mass.coeff(i + 1, i + 1);
+    }
+    
+    MatrixXr UtMW = U_.transpose() * massI.asDiagonal() * W;
+    
+    G_ = PW.transpose().partialPivLu().solve( UtMW.transpose() ).transpose();
+    
+    SparseXr StiffI = Stiff.block(1, 1, nI, nI);
+    
+    K_ = U_.transpose() * (StiffI * U_);
+    
+    B_.resize( U_.cols(), 2 );
+    B_.col(0) = U_.transpose() * (VectorXr) Stiff.block(1, 0,     nI, 1);
+    B_.col(1) = U_.transpose() * (VectorXr) Stiff.block(1, n - 1, nI, 1);
+    
+    first_ = (RowVectorXr) Stiff.block(0,     1, 1, nI) * U_;
+    last_  = (RowVectorXr) Stiff.block(n - 1, 1, 1, nI) * U_;
+    
+    Sbb_ << Stiff.coeff(0,     0), Stiff.coeff(0,     n - 1),
+            Stiff.coeff(n - 1, 0), Stiff.coeff(n - 1, n - 1);
+            
+    Mbb_ << Mass.coeff(0, 0), Mass.coeff(n - 1, n - 1);
+    
+    // Diagonals of the condensed system, for the full-order residual.
+    lower_ = VectorXr::Zero( n );
+    diag_  = VectorXr::Zero( n );
+    upper_ = VectorXr::Zero( n );
+    mass_  = VectorXr::Zero( n );
+    
+    for ( Index j = 0; j < Stiff.outerSize(); ++j )
+    {
+        for ( SparseXr::InnerIterator it(Stiff, j); it; ++it )
+        {
+            if ( it.row() == it.col() )
+            {
+                diag_(it.row()) = it.value();
+            }
+            else if ( it.row() == it.col() + 1 )
+            {
+                lower_(it.row()) = it.value();
+            }
+            else if ( it.col() == it.row() + 1 )
+            {
+                upper_(it.row()) = it.value();
+            }
+            else if ( it.value() != 0.0 )
+            {
+                throw std::runtime_error("ERROR: the reduced-order solver requires a tridiagonal stiffness matrix.");
+            }
+        }
+    }
+    
+    for ( Index i = 0; i < n; ++i )
+    {
+        mass_(i) = Mass.coeff(i, i);
+    }
+    
+    // Interpolation nodes in the condensed numbering.
+    points_ = points.array() + 1;
+}
+
+Real ReducedPoissonBasis::distance(const ParamList & params) const
+{
+    const std::vector<Gaussian> gaussians = params .gaussians();
+    const std::vector<Gaussian> snapshots = params_.gaussians();
+    
+    if ( params.T() != params_.T() || gaussians.size() != snapshots.size() ||
+         params.N0_exp() != params_.N0_exp() || params.lambda_exp() != params_.lambda_exp() )
+    {
+        return std::numeric_limits<Real>::infinity();
+    }
+    
+    const Real kT = constants::K_B * params_.T();
+    
+    Real distance = 0.0;
+    
+    for ( std::size_t k = 0; k < gaussians.size(); ++k )
+    {
+        distance = std::max( distance, std::abs(gaussians[k].sigma - snapshots[k].sigma) / kT );
+        distance = std::max( distance, std::abs(gaussians[k].shift - snapshots[k].shift) * constants::Q / kT );
+        distance = std::max( distance, std::abs( std::log(gaussians[k].N0 / snapshots[k].N0) ) );
+    }
+    
+    return distance;
+}
+
+MatrixXr ReducedPoissonBasis::pod(MatrixXr & snapshots, const Real & tolerance, const Index & maxModesNo)
+{
+    for ( Index j = 0; j < snapshots.cols(); ++j )
+    {
+        const Real norm = snapshots.col(j).norm();
+        
+        if ( norm > 0.0 )
+        {
+            snapshots.col(j) /= norm;
+        }
+    }
+    
+    JacobiSVD<MatrixXr> svd(snapshots, ComputeThinU);
+    
+    const VectorXr & sigma = svd.singularValues();
+    
+    if ( sigma.size() == 0 || sigma(0) == 0.0 )
+    {
+        throw std::runtime_error("ERROR: the snapshots of the reduced-order model are all null.");
+    }
+    
+    Index modesNo = 1;
+    
+    while ( modesNo < std::min(maxModesNo, (Index) sigma.size()) && sigma(modesNo) > tolerance * sigma(0) )
+    {
+        ++modesNo;
+    }
+    
+    return svd.matrixU().leftCols(modesNo);
+}
+
+ReducedPoisson1D::ReducedPoisson1D(const ParamList & params, const ReducedPoissonBasis & basis,
+                                   const Index & maxIterationsNo, const Real & tolerance)
+    : params_(params), basis_(basis), maxIterationsNo_(maxIterationsNo), tolerance_(tolerance),
+      PhiBcorr_(0.0), qTot_(0.0), cTot_(0.0), residual_(0.0)
+{
+    assert( maxIterationsNo_ > 0   );
+    assert( tolerance_       > 0.0 );
+}
+
+void ReducedPoisson1D::apply(const VectorXr & init_guess, const Charge & charge_fun, const bool & checkResidual)
+{
+    assert( init_guess.size() == basis_.nNodes_ );
+    
+    const MatrixXr & U = basis_.U_;
+    
+    const Index nPoints = basis_.points_.size();
+    
+    // Dirichlet conditions and projection of the initial guess (the basis is orthonormal).
+    const Matrix<Real, 2, 1> phiB( init_guess(0), init_guess(init_guess.size() - 1) );
+    
+    VectorXr a = U.transpose() * init_guess.segment(1, U.rows());
+    
+    norm_     = VectorXr::Zero( maxIterationsNo_ );
+    PhiBcorr_ = 0.0;
+    qTot_     = 0.0;
+    
+    // Potential at the interpolation nodes, followed by the boundary ones.
+    VectorXr phi( nPoints + 2 );
+    phi.tail(2) = phiB;
+    
+    VectorXr aOld    = a;
+    VectorXr psi     = VectorXr::Zero( phi.size() );    // Shifted potential the charge is evaluated at.
+    VectorXr charge  = VectorXr::Zero( phi.size() );
+    VectorXr dcharge = VectorXr::Zero( phi.size() );
+    
+    // Newton loop.
+    {
+        Index k = 0;
+        
+        for ( ; k < maxIterationsNo_; ++k )
+        {
+            aOld = a;
+            
+            phi.head(nPoints) = basis_.Up_ * aOld;
+            
+            psi = phi.array() + constants::V_TH * PhiBcorr_;
+            
+            charge_fun.evaluate(psi, charge, dcharge);
+            
+            // Outward electric field.
+            const Real res0 = basis_.Sbb_.row(0).dot(phiB) + basis_.first_.dot(aOld)
+                              - basis_.Mbb_(0) * charge(nPoints);
+                              
+            Real E = -res0 / params_.eps_semic();
+            
+            const Real coeff = params_.PhiBcoeff();
+            const Real f = coeff * coeff * E;
+            
+            if (f > 0)
+            {
+                PhiBcorr_ = std::sqrt(f);
+            }
+            else
+            {
+                PhiBcorr_ = f / 4;
+            }
+            
+            VectorXr res = basis_.K_ * aOld + basis_.B_ * phiB - basis_.G_ * charge.head(nPoints);
+            
+            MatrixXr Jac = basis_.K_ - basis_.G_ * (dcharge.head(nPoints).asDiagonal() * basis_.Up_);
+            
+            VectorXr da = - Jac.partialPivLu().solve(res);
+            
+            // Newton step.
+            a += da;
+            
+            norm_(k) = (U * da).cwiseAbs().maxCoeff();
+            
+            if ( norm_(k) < tolerance_ )
+            {
+                break;
+            }
+        }
+        
+        if ( k < maxIterationsNo_ )
+        {
+            norm_.conservativeResize(k + 1);
+        }
+    }
+    
+    qTot_ = basis_.Sbb_.row(1).dot(phiB) + basis_.last_.dot(aOld) - basis_.Mbb_(1) * charge(nPoints + 1);
+    
+    // Compute total capacitance.
+    phi.head(nPoints) = basis_.Up_ * a;
+    
+    dcharge = charge_fun.dcharge(phi.array() + PhiBcorr_);
+    
+    MatrixXr Jac = basis_.K_ - basis_.G_ * (dcharge.head(nPoints).asDiagonal() * basis_.Up_);
+    
+    VectorXr b = - Jac.partialPivLu().solve( basis_.B_.col(1) );
+    
+    cTot_ = basis_.last_.dot(b) + basis_.Sbb_(1, 1) - basis_.Mbb_(1) * dcharge(nPoints + 1);
+    
+    // Reconstruct the potential, also in the charge-free region.
+    const Index m = basis_.interfaceNo_;
+    
+    phi_ = VectorXr::Zero( basis_.nNodes_ );
+    
+    phi_(0) = phiB(0);
+    phi_.segment(1, U.rows()) = U * a;
+    phi_(phi_.size() - 1) = phiB(1);
+    
+    if ( basis_.tail_.rows() > 0 )
+    {
+        phi_.segment(m + 1, basis_.tail_.rows()) = - basis_.tail_ * Matrix<Real, 2, 1>(phi_(m), phiB(1));
+    }
+    
+    residual_ = 0.0;
+    
+    if ( !checkResidual )
+    {
+        return;
+    }
+    
+    // Full-order residual at the reconstructed potential, measured by the Newton step it leads to.
+    const CondensedSystem & system = *basis_.condensed_;
+    
+    const Index n = system.Stiff.rows();
+    
+    VectorXr phiFull( n );
+    phiFull.head(m + 1) = phi_.head(m + 1);
+    phiFull(n - 1)      = phiB(1);
+    
+    charge_fun.evaluate(phiFull.array() + constants::V_TH * PhiBcorr_, charge, dcharge);
+    
+    VectorXr res = system.Stiff * phiFull - system.Mass * charge;
+    
+    VectorXr jacDiag = basis_.diag_ - basis_.mass_.cwiseProduct(dcharge);
+    
+    solve(basis_.lower_, jacDiag, basis_.upper_, res, 1, n - 2);
+    
+    residual_ = res.segment(1, n - 2).cwiseAbs().maxCoeff();
+}
@@ -0,0 +1,258 @@
+/* C++11 */
+
+/**
+ * @file   reducedOrder.h
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ * @brief Reduced-order model of the non-linear Poisson equation (POD-Galerkin with DEIM).
+ *
+ */
+
+#ifndef REDUCEDORDER_H
+#define REDUCEDORDER_H
+
+#include "charge.h"
+#include "paramList.h"
+#include "solvers.h"
+#include "typedefs.h"
+
+#include <memory>    // std::shared_ptr
+
+/**
+ * @class ReducedPoissonBasis
+ *
+ * The basis is built from snapshots of solutions computed by @ref NonLinearPoisson1D, on the
+ * nodes kept by its static condensation. Its potential at the interior nodes is approximated as
+ * @f$ \varphi_I \approx U a @f$, the columns of @f$ U @f$ being the leading left singular vectors
+ * (Proper Orthogonal Decomposition) of the snapshots of the potential and of its derivative
+ * with respect to the gate voltage, each normalized.
+ *
+ * The charge is approximated by the Discrete Empirical Interpolation Method (DEIM):
+ * @f$ \rho \approx W \left(P^T W\right)^{-1} P^T \rho @f$, being @f$ W @f$ the POD basis of the snapshots of
+ * the charge and of its derivative and @f$ P @f$ the interpolation nodes chosen by the greedy algorithm,
+ * so that the charge is evaluated only at those nodes (and at the boundary ones).
+ *
+ * The Galerkin projection of the system matrices is precomputed, so that the cost of a Newton iteration
+ * does not depend on the number of nodes of the mesh. The basis is not bound to a @ref Charge: it can be
+ * used by nearby parameter sets sharing the mesh and the device geometry, their distance from the parameters
+ * of the snapshots being measured by @ref distance.
+ *
+ * @brief Class providing the reduced basis and the projected operators of the non-linear Poisson equation.
+ *
+ */
+class ReducedPoissonBasis
+{
+    public:
+        friend class ReducedPoisson1D;
+        
+        /**
+         * @brief Default constructor (deleted since it is required to specify the snapshots).
+         */
+        ReducedPoissonBasis() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] params     : the parameter list the snapshots have been computed with;
+         * @param[in] solver     : the solver the snapshots have been computed with;
+         * @param[in] Phi        : the snapshots of the potential, one column per solution;
+         * @param[in] PhiBcorr   : the barrier corrections of the snapshots;
+         * @param[in] charge_fun : an object of class @ref Charge specifying how to compute total electric charge;
+         * @param[in] tolerance  : singular values lower than @a tolerance times the largest one are discarded;
+         * @param[in] maxModesNo : maximum number of modes of the potential and of interpolation nodes of the charge.
+         */
+        ReducedPoissonBasis(const ParamList &, const std::shared_ptr<const PdeSolver1D> &, const MatrixXr &,
+                            const VectorXr &, const Charge &, const Real &, const Index &);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~ReducedPoissonBasis() = default;
+        
+        /**
+         * The distance is the largest difference between the gaussians, in terms of @f$ \frac{\sigma}{k_B T} @f$,
+         * of @f$ \frac{q \, \mathrm{shift}}{k_B T} @f$ and of @f$ \log N_0 @f$; it is infinite if the temperature,
+         * the number of gaussians or the exponential DOS differ.
+         *
+         * @brief Compute the distance of a parameter list from the one of the snapshots.
+         * @param[in] params : the parameter list.
+         * @returns the distance.
+         */
+        Real distance(const ParamList &) const;
+        
+        /**
+         * @name Getter methods
+         * @{
+         */
+        inline const std::shared_ptr<const PdeSolver1D> & solver() const;
+        inline Index modesNo () const;
+        inline Index pointsNo() const;
+        
+        /**
+         * @}
+         */
+        
+    private:
+        /**
+         * @brief Compute the POD basis of a set of snapshots.
+         * @param[in] snapshots  : the snapshots, one per column (normalized in place);
+         * @param[in] tolerance  : singular values lower than @a tolerance times the largest one are discarded;
+         * @param[in] maxModesNo : maximum number of modes.
+         * @returns the orthonormal basis, one mode per column.
+         */
+        static MatrixXr pod(MatrixXr &, const Real &, const Index &);
+        
+        ParamList params_;    /**< @brief The parameter list of the snapshots. */
+        
+        std::shared_ptr<const PdeSolver1D>     solver_   ;    /**< @brief The solver the basis has been built on. */
+        std::shared_ptr<const CondensedSystem> condensed_;    /**< @brief Its condensed system, for the full-order residual. */
+        
+        Index    nNodes_     ;    /**< @brief Number of nodes of the mesh. */
+        Index    interfaceNo_;    /**< @brief Index of the last node carrying charge. */
+        MatrixXr tail_       ;    /**< @brief Map from the potential at the interface and at the last node to the eliminated nodes. */
+        
+        VectorXr lower_;    /**< @brief Sub-diagonal of the condensed stiffness matrix (@a lower_(i) in row @a i). */
+        VectorXr diag_ ;    /**< @brief Main diagonal of the condensed stiffness matrix. */
+        VectorXr upper_;    /**< @brief Super-diagonal of the condensed stiffness matrix (@a upper_(i) in row @a i). */
+        VectorXr mass_ ;    /**< @brief Diagonal of the condensed mass matrix. */
+        
+        MatrixXr       U_     ;    /**< @brief POD basis of the potential at the interior condensed nodes. */
+        VectorX<Index> points_;    /**< @brief DEIM interpolation nodes (condensed numbering). */
+        
+        MatrixXr K_ ;    /**< @brief Projected stiffness matrix @f$ U^T S_{II} U @f$. */
+        MatrixXr B_ ;    /**< @brief Projected coupling with the boundary nodes @f$ U^T S_{Ib} @f$. */
+        MatrixXr G_ ;    /**< @brief Projected DEIM operator @f$ U^T M_{II} W \left(P^T W\right)^{-1} @f$. */
+        MatrixXr Up_;    /**< @brief Rows of @f$ U @f$ at the interpolation nodes. */
+        
+        RowVectorXr first_;    /**< @brief First row of the condensed stiffness matrix times @f$ U @f$. */
+        RowVectorXr last_ ;    /**< @brief Last row of the condensed stiffness matrix times @f$ U @f$. */
+        
+        Matrix<Real, 2, 2> Sbb_;    /**< @brief Condensed stiffness matrix between the boundary nodes. */
+        Matrix<Real, 2, 1> Mbb_;    /**< @brief Condensed mass matrix at the boundary nodes. */
+};
+
+/**
+ * The Newton method of @ref NonLinearPoisson1D is applied to the Galerkin projection of the equation onto a
+ * @ref ReducedPoissonBasis, with the same barrier correction, total charge and capacitance. The potential on
+ * the whole mesh is reconstructed from the reduced coordinates.
+ *
+ * Since the reduced equation may converge to a solution far from the full-order one (e.g. for parameters
+ * far from the snapshots), the full-order residual @f$ S \varphi - M q(\varphi) @f$ is evaluated at the
+ * reconstructed potential and measured by the Newton step of @ref NonLinearPoisson1D it would lead to,
+ * so that it can be compared with the tolerance of the latter. The Jacobian being tridiagonal, this step
+ * is computed by the Thomas algorithm.
+ *
+ * @brief Provide a reduced-order solver for the non-linear Poisson equation.
+ *
+ */
+class ReducedPoisson1D
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the basis to be used).
+         */
+        ReducedPoisson1D() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] params          : a parameter list;
+         * @param[in] basis           : the reduced basis to be used;
+         * @param[in] maxIterationsNo : maximum number of iterations desired;
+         * @param[in] tolerance       : tolerance desired.
+         */
+        ReducedPoisson1D(const ParamList &, const ReducedPoissonBasis &, const Index & = 100, const Real & = 1.0e-6);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~ReducedPoisson1D() = default;
+        
+        /**
+         * @brief Apply a Newton method to the reduced equation.
+         * @param[in] init_guess    : initial guess for the Newton algorithm (its end-points set the Dirichlet conditions);
+         * @param[in] charge_fun    : an object of class @ref Charge specifying how to compute total electric charge;
+         * @param[in] checkResidual : whether to evaluate the full-order residual at the solution (otherwise it is set to zero).
+         */
+        void apply(const VectorXr &, const Charge &, const bool & = true);
+        
+        /**
+         * @name Getter methods
+         * @{
+         */
+        inline const Real     & PhiBcorr() const;
+        inline const VectorXr & phi()      const;
+        inline const VectorXr & norm()     const;
+        inline const Real     & qTot()     const;
+        inline const Real     & cTot()     const;
+        inline const Real     & residual() const;
+        
+        /**
+         * @}
+         */
+        
+    private:
+        const ParamList           & params_;    /**< @brief The parameter list. */
+        const ReducedPoissonBasis & basis_ ;    /**< @brief The reduced basis. */
+        
+        const Index & maxIterationsNo_;    /**< @brief Maximum number of iterations. */
+        const Real  & tolerance_      ;    /**< @brief Tolerance. */
+        
+        Real PhiBcorr_;    /**< @brief Barrier correction. */
+        
+        VectorXr phi_ ;    /**< @brief The electric potential. */
+        VectorXr norm_;    /**< @brief Vector holding @f$ L^\infty @f$-norm errors for each iteration. */
+        
+        Real qTot_;    /**< @brief Total charge. */
+        Real cTot_;    /**< @brief Total capacitance. */
+        
+        Real residual_;    /**< @brief @f$ L^\infty @f$-norm of the full-order Newton step at the reconstructed potential. */
+};
+
+// Implementations.
+inline const std::shared_ptr<const PdeSolver1D> & ReducedPoissonBasis::solver() const
+{
+    return solver_;
+}
+
+inline Index ReducedPoissonBasis::modesNo() const
+{
+    return U_.cols();
+}
+
+inline Index ReducedPoissonBasis::pointsNo() const
+{
+    return points_.size();
+}
+
+inline const Real & ReducedPoisson1D::PhiBcorr() const
+{
+    return PhiBcorr_;
+}
+
+inline const VectorXr & ReducedPoisson1D::phi() const
+{
+    return phi_;
+}
+
+inline const VectorXr & ReducedPoisson1D::norm() const
+{
+    return norm_;
+}
+
+inline const Real & ReducedPoisson1D::qTot() const
+{
+    return qTot_;
+}
+
+inline const Real & ReducedPoisson1D::cTot() const
+{
+    return cTot_;
+}
+
+inline const Real & ReducedPoisson1D::residual() const
+{
+    return residual_;
+}
+
+#endif /* REDUCEDORDER_H */
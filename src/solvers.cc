@@ -14,101 +14,55 @@
 
 #include "solvers.h"
 
+#include <vector>
+
 PdeSolver1D::PdeSolver1D(VectorXr & mesh)
     : mesh_(mesh), nNodes_(mesh_.size()) {}
-
+    
 Bim1D::Bim1D(VectorXr & mesh)
     : PdeSolver1D(mesh) {}
-
+    
 VectorXr Bim1D::log_mean(const VectorXr & x1, const VectorXr & x2)
 {
     assert( x1.size() == x2.size() );
     assert( x1.minCoeff() >= 0.0 );
     assert( x2.minCoeff() >= 0.0 );
     
-    VectorXr log_mean = VectorXr::Zero( x1.size() );
+    // With u = (x2 - x1) / (x2 + x1): M_log = (x1 + x2) / 2 * u / atanh(u).
+    const Real lim = 0.1;
     
-    for ( Index i = 0; i < log_mean.size(); ++i )
-    {
-        if ( x1(i) == 0.0 || x2(i) == 0.0 )
-        {
-            log_mean(i) = 0.0;
-        }
-        else if ( x1(i) == x2(i) )
-        {
-            log_mean(i) = x1(i);
-        }
-        else if ( std::abs( x2(i) - x1(i) ) < 100 * std::numeric_limits<Real>::epsilon() )    // Small values.
-        {
-            log_mean(i) = 0.5 * ( x1(i) + x2(i) );
-        }
-        else
-        {
-            log_mean(i) = ( x2(i) - x1(i) ) / std::log( x2(i) / x1(i) );
-        }
-    }
+    ArrayXr u  = (x2 - x1).array() / (x2 + x1).array();
+    ArrayXr u2 = u.square();
     
-    return log_mean;
+    // Small values: atanh(u) / u = sum_k u^(2k) / (2k + 1), truncated after u^14
+    // (relative error below 1.0e-17 for |u| < lim).
+    ArrayXr series = 1.0 + u2 * (1.0 / 3 + u2 * (1.0 / 5 + u2 * (1.0 / 7 + u2 * (1.0 / 9 + u2 * (1.0 / 11 + u2 * (1.0 / 13 + u2 * (1.0 / 15)))))));
+    
+    ArrayXr logRatio = (x2.array() / x1.array()).log();
+    
+    ArrayXr log_mean = (u.abs() < lim).select( 0.5 * (x1 + x2).array() / series, (x2 - x1).array() / logRatio );
+    
+    return (x1.array().min(x2.array()) == 0.0).select( 0.0, log_mean );
 }
 
 std::pair<VectorXr, VectorXr> Bim1D::bernoulli(const VectorXr & x)
 {
-    VectorXr bp = VectorXr::Zero( x.size() );
-    VectorXr bn = VectorXr::Zero( x.size() );
+    const Real lim = 0.1;
     
-    Real lim = 1.0e-2;
+    // Small values: B(x) = 1 - x / 2 + sum_k B_2k x^(2k) / (2k)!, truncated after x^8
+    // (relative error below 3.0e-18 for |x| < lim).
+    // Other values: no asymptotics needed, exp(x) overflowing to infinity or underflowing to zero
+    // gives the right limits B(x) = 0 and B(-x) = x for x -> +inf and vice versa.
+    ArrayXr ex = x.array().exp();
+    ArrayXr x2 = x.array().square();
+    ArrayXr series = 1.0 + x2 * (1.0 / 12 + x2 * (- 1.0 / 720 + x2 * (1.0 / 30240 + x2 * (- 1.0 / 1209600))));
     
-    VectorXr ax = x.cwiseAbs();
+    std::pair<VectorXr, VectorXr> bp_bn;
     
-    for ( Index i = 0; i < x.size(); ++i )
-    {
-        if ( x(i) == 0.0 )
-        {
-            bp(i) = 1.0;
-            bn(i) = 1.0;
-        }
-        else if ( ax(i) > 80.0 )    // Asymptotics.
-        {
-            if ( x(i) > 0.0 )
-            {
-                bp(i) = 0.0 ;
-                bn(i) = x(i);
-            }
-            else
-            {
-                bp(i) = -x(i);
-                bn(i) = 0.0  ;
-            }
-        }
-        else if ( ax(i) <= 80.0 && ax(i) > lim )    // Intermediate values.
-        {
-            bp(i) = x(i) / ( std::exp(x(i)) - 1.0 );
-            bn(i) = x(i) + bp(i);
-        }
-        else    //  if ( ax(i) <= lim ). Small values: Taylor expansion.
-        {
-            Real  j = 1.0;
-            Real fp = 1.0;
-            Real fn = 1.0;
-            Real df = 1.0;
-            
-            int sign = 1;
-            
-            while ( std::abs(df) > 1.0e-16 )
-            {
-                j += 1.0;
-                sign = -sign;
-                df *= x(i) / j;
-                fp += df;
-                fn += sign * df;
-            }
-            
-            bp(i) = 1.0 / fp;
-            bn(i) = 1.0 / fn;
-        }
-    }
+    bp_bn.first  = (x.array().abs() < lim).select( series - 0.5 * x.array(), x.array() / (ex - 1.0) );
+    bp_bn.second = (x.array().abs() < lim).select( series + 0.5 * x.array(), x.array() / (1.0 - ex.inverse()) );
     
-    return std::make_pair(bp, bn);
+    return bp_bn;
 }
 
 void Bim1D::assembleAdvDiff(const VectorXr & alpha, const VectorXr & gamma, const VectorXr & eta, const VectorXr & beta)
@@ -153,17 +107,18 @@ void Bim1D::assembleAdvDiff(const VectorXr & alpha, const VectorXr & gamma, cons
     // Assembly
     AdvDiff_.resize( nNodes_, nNodes_ );
     
+    // Flux on element k: c_k * ( B(v_k) * u_(k+1) - B(-v_k) * u_k ).
     for ( Index i = 0; i < AdvDiff_.rows() - 1; ++i )
     {
-        AdvDiff_.insert(i + 1,  i  ) = - c_k(i) * bp(i);    // Sub-diagonal.
-        AdvDiff_.insert(  i , i + 1) = - c_k(i) * bn(i);    // Super-diagonal.
+        AdvDiff_.insert(i + 1,  i  ) = - c_k(i) * bn(i);    // Sub-diagonal.
+        AdvDiff_.insert(  i , i + 1) = - c_k(i) * bp(i);    // Super-diagonal.
     }
     
     AdvDiff_.insert(0, 0) = c_k(0) * bn(0);
     
     for ( Index i = 1; i < AdvDiff_.rows() - 1; ++i )
     {
-        AdvDiff_.insert(i, i) = c_k(i) * bn(i) + c_k(i - 1) * bn(i - 1);    // Main diagonal.
+        AdvDiff_.insert(i, i) = c_k(i) * bn(i) + c_k(i - 1) * bp(i - 1);    // Main diagonal.
     }
     
     AdvDiff_.insert(AdvDiff_.rows() - 1, AdvDiff_.cols() - 1) = c_k(c_k.size() - 1) * bp(bp.size() - 1);
@@ -202,22 +157,260 @@ void Bim1D::assembleMass(const VectorXr & delta, const VectorXr & zeta)
     return;
 }
 
+std::list<Bim1DCache::Entry> Bim1DCache::entries_;
+
+std::shared_ptr<const Bim1D> Bim1DCache::get(const VectorXr & mesh, const VectorXr & eps, const VectorXr & mask)
+{
+    assert( eps .size() == mesh.size() - 1 );
+    assert( mask.size() == mesh.size() - 1 );
+    
+    std::shared_ptr<const Bim1D> solver;
+    
+    #pragma omp critical (Bim1DCache)
+    {
+        for ( auto it = entries_.begin(); it != entries_.end(); ++it )
+        {
+            if ( it->mesh.size() == mesh.size() && it->mesh == mesh && it->eps == eps && it->mask == mask )
+            {
+                // Move to the front, as the most recently used.
+                entries_.splice(entries_.begin(), entries_, it);
+                
+                solver = entries_.front().solver;
+                break;
+            }
+        }
+        
+        if ( solver == nullptr )
+        {
+            VectorXr temp = mesh;
+            
+            Bim1D * bimSolver = new Bim1D(temp);
+            
+            bimSolver->assembleStiff(eps , VectorXr::Ones( mesh.size() ));
+            bimSolver->assembleMass (mask, VectorXr::Ones( mesh.size() ));
+            
+            solver.reset(bimSolver);
+            
+            entries_.push_front( Entry{mesh, eps, mask, solver, nullptr} );
+            
+            // Solvers still in use are freed by their last owner.
+            if ( entries_.size() > maxEntriesNo )
+            {
+                entries_.pop_back();
+            }
+        }
+    }
+    
+    return solver;
+}
+
+std::shared_ptr<const Bim1D> Bim1DCache::get(const VectorXr & mesh, const ParamList & params)
+{
+    VectorXr xm = 0.5 * (mesh.segment(1, mesh.size() - 1) + mesh.segment(0, mesh.size() - 1));
+    
+    VectorXr eps  = params.eps_semic() * VectorXr::Ones( xm.size() );
+    VectorXr mask = VectorXr::Zero( xm.size() );
+    
+    for ( Index i = 0; i < xm.size(); ++i )
+    {
+        if ( xm(i) > 0.0 )
+        {
+            eps(i) = params.eps_ins();
+        }
+        else if ( xm(i) < 0.0 )
+        {
+            mask(i) = 1.0;
+        }
+    }
+    
+    return get(mesh, eps, mask);
+}
+
+std::shared_ptr<const CondensedSystem> Bim1DCache::condensed(const PdeSolver1D & solver)
+{
+    std::shared_ptr<const CondensedSystem> system;
+    bool cached = false;
+    
+    #pragma omp critical (Bim1DCache)
+    {
+        for ( const Entry & entry : entries_ )
+        {
+            if ( entry.solver.get() == &solver )
+            {
+                system = entry.condensed;
+                cached = true;
+                break;
+            }
+        }
+    }
+    
+    if ( system != nullptr )
+    {
+        return system;
+    }
+    
+    // Condense outside the critical section, not to hold up other threads.
+    CondensedSystem * temp = new CondensedSystem;
+    
+    NonLinearPoisson1D::condense(solver, temp->Stiff, temp->Mass, temp->interfaceNo, temp->tail);
+    
+    system.reset(temp);
+    
+    if ( cached )
+    {
+        #pragma omp critical (Bim1DCache)
+        {
+            for ( Entry & entry : entries_ )
+            {
+                if ( entry.solver.get() == &solver )
+                {
+                    // Another thread may have got there first.
+                    if ( entry.condensed == nullptr )
+                    {
+                        entry.condensed = system;
+                    }
+                    else
+                    {
+                        system = entry.condensed;
+                    }
+                    
+                    break;
+                }
+            }
+        }
+    }
+    
+    return system;
+}
+
+void Bim1DCache::clear()
+{
+    #pragma omp critical (Bim1DCache)
+    entries_.clear();
+    
+    return;
+}
+
 NonLinearPoisson1D::NonLinearPoisson1D(const ParamList & params, const PdeSolver1D & solver, const Index & maxIterationsNo, const Real & tolerance)
-    : params_(params), solver_(solver), maxIterationsNo_(maxIterationsNo), tolerance_(tolerance), PhiBcorr_(0.0), qTot_(0.0), cTot_(0.0)/*, cTot_n_(0.0) */
+    : params_(params), solver_(solver), maxIterationsNo_(maxIterationsNo), tolerance_(tolerance),
+      condensed_(Bim1DCache::condensed(solver)), Stiff_(condensed_->Stiff), Mass_(condensed_->Mass),
+      interfaceNo_(condensed_->interfaceNo), tail_(condensed_->tail), PhiBcorr_(0.0), qTot_(0.0), cTot_(0.0)/*, cTot_n_(0.0) */
 {
     assert( maxIterationsNo_ > 0   );
     assert( tolerance_       > 0.0 );
 }
 
+void NonLinearPoisson1D::condense(const PdeSolver1D & solver, SparseXr & Stiff_c, SparseXr & Mass_c,
+                                  Index & interfaceNo, MatrixXr & tail)
+{
+    const SparseXr & Stiff = solver.Stiff_;
+    const SparseXr & Mass  = solver.Mass_;
+    
+    assert( Stiff.rows() == solver.mesh_.size() );
+    assert( Mass .rows() == solver.mesh_.size() );
+    
+    const Index N = Stiff.rows() - 1;    // Last node.
+    
+    // Last node carrying charge: the nodes between it and the last one are charge-free.
+    interfaceNo = N;
+    
+    while ( interfaceNo > 0 && Mass.coeff(interfaceNo, interfaceNo) == 0.0 )
+    {
+        --interfaceNo;
+    }
+    
+    const Index m  = interfaceNo;
+    const Index nE = N - 1 - m;    // Number of nodes to eliminate.
+    
+    if ( nE <= 0 )
+    {
+        interfaceNo = N;
+        
+        Stiff_c = Stiff;
+        Mass_c  = Mass;
+        tail.resize(0, 2);
+        
+        return;
+    }
+    
+    // Schur complement: the nodes (m, N) are coupled through A_EE^{-1}.
+    SparseXr A_EE = Stiff.block(m + 1, m + 1, nE, nE);
+    
+    MatrixXr A_EK = MatrixXr::Zero( nE, 2 );
+    MatrixXr A_KE = MatrixXr::Zero( 2, nE );
+    
+    for ( Index i = 0; i < nE; ++i )
+    {
+        A_EK(i, 0) = Stiff.coeff(m + 1 + i, m);
+        A_EK(i, 1) = Stiff.coeff(m + 1 + i, N);
+        
+        A_KE(0, i) = Stiff.coeff(m, m + 1 + i);
+        A_KE(1, i) = Stiff.coeff(N, m + 1 + i);
+    }
+    
+    SparseLU<SparseXr> tailSolver;
+    tailSolver.compute(A_EE);
+    
+    tail = tailSolver.solve(A_EK);    // phi_E = - tail * (phi_m, phi_N).
+    
+    MatrixXr correction = A_KE * tail;
+    
+    // Condensed matrices: nodes 0, ..., m and N (renumbered as m + 1).
+    auto condensed = [m, N] (const Index & i)
+    {
+        return ( i == N ) ? m + 1 : i;
+    };
+    
+    std::vector< Eigen::Triplet<Real> > triplets_S;
+    std::vector< Eigen::Triplet<Real> > triplets_M;
+    
+    for ( Index j = 0; j < Stiff.outerSize(); ++j )
+    {
+        for ( SparseXr::InnerIterator it(Stiff, j); it; ++it )
+        {
+            if ( (it.row() <= m || it.row() == N) && (it.col() <= m || it.col() == N) )
+            {
+                triplets_S.push_back( Eigen::Triplet<Real>(condensed(it.row()), condensed(it.col()), it.value()) );
+            }
+        }
+    }
+    
+    for ( Index j = 0; j < Mass.outerSize(); ++j )
+    {
+        for ( SparseXr::InnerIterator it(Mass, j); it; ++it )
+        {
+            if ( (it.row() <= m || it.row() == N) && (it.col() <= m || it.col() == N) )
+            {
+                triplets_M.push_back( Eigen::Triplet<Real>(condensed(it.row()), condensed(it.col()), it.value()) );
+            }
+        }
+    }
+    
+    for ( Index a = 0; a < 2; ++a )
+    {
+        for ( Index b = 0; b < 2; ++b )
+        {
+            triplets_S.push_back( Eigen::Triplet<Real>(m + a, m + b, - correction(a, b)) );
+        }
+    }
+    
+    Stiff_c.resize(m + 2, m + 2);
+    Stiff_c.setFromTriplets(triplets_S.begin(), triplets_S.end());
+    
+    Mass_c.resize(m + 2, m + 2);
+    Mass_c.setFromTriplets(triplets_M.begin(), triplets_M.end());
+    
+    return;
+}
+
 void NonLinearPoisson1D::apply(const VectorXr & init_guess, const Charge & charge_fun)
 {
-    assert( init_guess    .size() == solver_.mesh_.size() );
-    assert( solver_.Stiff_.rows() == solver_.mesh_.size() );
-    assert( solver_.Stiff_.cols() == solver_.mesh_.size() );
-    assert( solver_.Mass_ .rows() == solver_.mesh_.size() );
-    assert( solver_.Mass_ .cols() == solver_.mesh_.size() );
+    assert( init_guess.size() == solver_.mesh_.size() );
     
-    phi_      = init_guess;
+    // Newton iterates only on the nodes kept by the condensation.
+    phi_.resize( Stiff_.rows() );
+    phi_.head(interfaceNo_ + 1)   = init_guess.head(interfaceNo_ + 1);
+    phi_(phi_.size() - 1)         = init_guess(init_guess.size() - 1);
     norm_     = VectorXr::Zero( maxIterationsNo_ );
     
     PhiBcorr_ = 0.0;
@@ -225,10 +418,11 @@ void NonLinearPoisson1D::apply(const VectorXr & init_guess, const Charge & charg
     
     VectorXr phiOld = phi_;
     
-    VectorXr  charge = VectorXr::Zero( solver_.mesh_.size() );
-    VectorXr dcharge = VectorXr::Zero( solver_.mesh_.size() );
+    VectorXr     psi = VectorXr::Zero( phi_.size() );    // Shifted potential the charge is evaluated at.
+    VectorXr  charge = VectorXr::Zero( phi_.size() );
+    VectorXr dcharge = VectorXr::Zero( phi_.size() );
     
-    SparseXr Jac(solver_.Stiff_.rows(), solver_.Stiff_.rows());
+    SparseXr Jac(Stiff_.rows(), Stiff_.rows());
     
     SparseLU<SparseXr> systemSolver;    // Initialize system solver.
     
@@ -240,11 +434,12 @@ void NonLinearPoisson1D::apply(const VectorXr & init_guess, const Charge & charg
         {
             phiOld = phi_;
             
-            charge  = charge_fun. charge(phiOld.array() + constants::V_TH * PhiBcorr_);
-            dcharge = charge_fun.dcharge(phiOld.array() + constants::V_TH * PhiBcorr_);
+            psi = phiOld.array() + constants::V_TH * PhiBcorr_;
+            
+            charge_fun.evaluate(psi, charge, dcharge);
             
             // System assembly.
-            VectorXr res = (solver_.Stiff_ * phiOld - solver_.Mass_ * charge);
+            VectorXr res = (Stiff_ * phiOld - Mass_ * charge);
             
 			// Outward electric field.
             Real E = -res(0) / params_.eps_semic();
@@ -298,13 +493,13 @@ void NonLinearPoisson1D::apply(const VectorXr & init_guess, const Charge & charg
     
     for ( Index i = 0; i < phiOld.size(); ++i )
     {
-        if ( solver_.Stiff_.coeff(solver_.Stiff_.rows() - 1, i) != 0.0 )
+        if ( Stiff_.coeff(Stiff_.rows() - 1, i) != 0.0 )
         {
-            qTot_ += solver_.Stiff_.coeff(solver_.Stiff_.rows() - 1, i) * phiOld(i);
+            qTot_ += Stiff_.coeff(Stiff_.rows() - 1, i) * phiOld(i);
         }
     }
     
-    qTot_ -= solver_.Mass_.coeff(solver_.Mass_.rows() - 1, solver_.Mass_.cols() - 1) * charge(charge.size() - 1);
+    qTot_ -= Mass_.coeff(Mass_.rows() - 1, Mass_.cols() - 1) * charge(charge.size() - 1);
     
     dcharge = charge_fun.dcharge(phi_.array() + PhiBcorr_);
     
@@ -324,23 +519,719 @@ void NonLinearPoisson1D::apply(const VectorXr & init_guess, const Charge & charg
     
     cTot_ = ((VectorXr) Jac.row(Jac.rows() - 1)).dot(u);
     /* cTot_n_ = ((VectorXr) Jac.row(0)).dot(u) + cTot_; */
+    
+    // Reconstruct the potential in the charge-free region.
+    if ( tail_.rows() > 0 )
+    {
+        VectorXr phi = VectorXr::Zero( solver_.mesh_.size() );
+        
+        phi.head(interfaceNo_ + 1) = phi_.head(interfaceNo_ + 1);
+        phi.segment(interfaceNo_ + 1, tail_.rows()) = - tail_ * Matrix<Real, 2, 1>(phi_(interfaceNo_), phi_(phi_.size() - 1));
+        phi(phi.size() - 1) = phi_(phi_.size() - 1);
+        
+        phi_ = phi;
+    }
 }
 
 SparseXr NonLinearPoisson1D::computeJac(const VectorXr & x) const
 {
-    assert( x.size() == solver_.Stiff_.rows() );
+    assert( x.size() == Stiff_.rows() );
     
     SparseXr Jac( x.size(), x.size() );
     
-    Jac = solver_.Stiff_;
+    Jac = Stiff_;
     
     for ( Index i = 0; i < Jac.rows(); ++i )
     {
-        if ( solver_.Mass_.coeff(i, i) != 0.0 )
+        if ( Mass_.coeff(i, i) != 0.0 )
         {
-            Jac.coeffRef(i, i) -= solver_.Mass_.coeff(i, i) * x(i);
+            Jac.coeffRef(i, i) -= Mass_.coeff(i, i) * x(i);
         }
     }
     
     return Jac;
 }
+
+BatchedNonLinearPoisson1D::BatchedNonLinearPoisson1D(const ParamList & params, const PdeSolver1D & solver, const Index & maxIterationsNo, const Real & tolerance)
+    : params_(params), maxIterationsNo_(maxIterationsNo), tolerance_(tolerance), nNodes_(solver.Stiff().rows())
+{
+    assert( maxIterationsNo_ > 0   );
+    assert( tolerance_       > 0.0 );
+    
+    std::shared_ptr<const CondensedSystem> condensed = Bim1DCache::condensed(solver);
+    
+    const SparseXr & Stiff = condensed->Stiff;
+    const SparseXr & Mass  = condensed->Mass ;
+    
+    interfaceNo_ = condensed->interfaceNo;
+    tail_        = condensed->tail;
+    
+    assert( Stiff.rows() >= 3 );
+    
+    lower_ = VectorXr::Zero( Stiff.rows() );
+    diag_  = VectorXr::Zero( Stiff.rows() );
+    upper_ = VectorXr::Zero( Stiff.rows() );
+    mass_  = VectorXr::Zero( Stiff.rows() );
+    
+    for ( Index j = 0; j < Stiff.outerSize(); ++j )
+    {
+        for ( SparseXr::InnerIterator it(Stiff, j); it; ++it )
+        {
+            if ( it.row() == it.col() )
+            {
+                diag_(it.row()) = it.value();
+            }
+            else if ( it.row() == it.col() + 1 )
+            {
+                lower_(it.row()) = it.value();
+            }
+            else if ( it.col() == it.row() + 1 )
+            {
+                upper_(it.row()) = it.value();
+            }
+            else if ( it.value() != 0.0 )
+            {
+                throw std::runtime_error("ERROR: the batched non-linear Poisson solver requires a tridiagonal stiffness matrix.");
+            }
+        }
+    }
+    
+    for ( Index j = 0; j < Mass.outerSize(); ++j )
+    {
+        for ( SparseXr::InnerIterator it(Mass, j); it; ++it )
+        {
+            if ( it.row() == it.col() )
+            {
+                mass_(it.row()) = it.value();
+            }
+            else if ( it.value() != 0.0 )
+            {
+                throw std::runtime_error("ERROR: the batched non-linear Poisson solver requires a lumped mass matrix.");
+            }
+        }
+    }
+}
+
+void BatchedNonLinearPoisson1D::apply(const MatrixXr & init_guess, const std::vector<const Charge *> & charge_fun)
+{
+    assert( init_guess.rows() == nNodes_ );
+    assert( init_guess.cols() == (Index) charge_fun.size() );
+    
+    const Index nBatch = init_guess.cols();
+    const Index n      = diag_.size();
+    const Index m      = interfaceNo_;
+    
+    // Structure of arrays: one row per instance, one column per node of the condensed system.
+    MatrixXr phi = MatrixXr::Zero( nBatch, n );
+    
+    phi.leftCols(m + 1) = init_guess.topRows(m + 1).transpose();
+    phi.col(n - 1)      = init_guess.row(nNodes_ - 1).transpose();
+    
+    MatrixXr phiOld = phi;
+    MatrixXr psi    = phi;    // Shifted potentials the charges are evaluated at.
+    
+    MatrixXr  charge = MatrixXr::Zero( nBatch, n );
+    MatrixXr dcharge = MatrixXr::Zero( nBatch, n );
+    
+    MatrixXr res = MatrixXr::Zero( nBatch, n );
+    MatrixXr jac = MatrixXr::Zero( nBatch, n );
+    
+    // Charges of the active instances (nullptr for the converged ones).
+    std::vector<const Charge *> activeCharges(charge_fun);
+    
+    PhiBcorr_     = VectorXr::Zero( nBatch );
+    norm_         = VectorXr::Zero( nBatch );
+    iterationsNo_ = VectorX<Index>::Zero( nBatch );
+    qTot_         = VectorXr::Zero( nBatch );
+    cTot_         = VectorXr::Zero( nBatch );
+    
+    std::vector<bool> active(nBatch, true);
+    Index activeNo = nBatch;
+    
+    const Real coeff = params_.PhiBcoeff();
+    
+    // Newton loop.
+    for ( Index k = 0; k < maxIterationsNo_ && activeNo > 0; ++k )
+    {
+        for ( Index b = 0; b < nBatch; ++b )
+        {
+            if ( active[b] )
+            {
+                phiOld.row(b) = phi.row(b);
+                
+                psi.row(b) = phiOld.row(b).array() + constants::V_TH * PhiBcorr_(b);
+            }
+        }
+        
+        // The block of all the instances is evaluated at once.
+        Charge::evaluate_batch(activeCharges, psi, charge, dcharge);
+        
+        // Residuals and Jacobians of all the instances.
+        res.col(0) = diag_(0) * phiOld.col(0) + upper_(0) * phiOld.col(1) - mass_(0) * charge.col(0);
+        
+        for ( Index i = 1; i < n - 1; ++i )
+        {
+            res.col(i) = lower_(i) * phiOld.col(i - 1) + diag_(i) * phiOld.col(i) + upper_(i) * phiOld.col(i + 1)
+                         - mass_(i) * charge.col(i);
+                         
+            jac.col(i) = diag_(i) * VectorXr::Ones( nBatch ) - mass_(i) * dcharge.col(i);
+        }
+        
+        for ( Index b = 0; b < nBatch; ++b )
+        {
+            if ( active[b] )
+            {
+                // Outward electric field.
+                Real E = -res(b, 0) / params_.eps_semic();
+                
+                const Real f = coeff * coeff * E;
+                
+                PhiBcorr_(b) = ( f > 0 ) ? std::sqrt(f) : f / 4;
+            }
+        }
+        
+        MatrixXr dphi = -res;
+        
+        solve(jac, dphi);
+        
+        // Newton step, Dirichlet conditions on boundary.
+        for ( Index b = 0; b < nBatch; ++b )
+        {
+            if ( active[b] )
+            {
+                phi.row(b).segment(1, n - 2) += dphi.row(b).segment(1, n - 2);
+                
+                norm_(b) = dphi.row(b).segment(1, n - 2).cwiseAbs().maxCoeff();
+                iterationsNo_(b) = k + 1;
+                
+                if ( norm_(b) < tolerance_ )
+                {
+                    active[b] = false;
+                    activeCharges[b] = nullptr;
+                    --activeNo;
+                }
+            }
+        }
+    }
+    
+    // Total charge.
+    qTot_ = lower_(n - 1) * phiOld.col(n - 2) + diag_(n - 1) * phiOld.col(n - 1) - mass_(n - 1) * charge.col(n - 1);
+    
+    // Compute total capacitance.
+    for ( Index b = 0; b < nBatch; ++b )
+    {
+        dcharge.row(b) = charge_fun[b]->dcharge(phi.row(b).transpose().array() + PhiBcorr_(b)).transpose();
+    }
+    
+    for ( Index i = 1; i < n; ++i )
+    {
+        jac.col(i) = diag_(i) * VectorXr::Ones( nBatch ) - mass_(i) * dcharge.col(i);
+    }
+    
+    // u = 0 on the first node and u = 1 on the last one.
+    MatrixXr u = MatrixXr::Zero( nBatch, n );
+    u.col(n - 2).fill( -upper_(n - 2) );
+    
+    cTot_ = jac.col(n - 1);
+    
+    solve(jac, u);
+    
+    cTot_ += lower_(n - 1) * u.col(n - 2);
+    
+    // Reconstruct the potential in the charge-free region.
+    phi_ = MatrixXr::Zero( nNodes_, nBatch );
+    
+    phi_.topRows(m + 1)      = phi.leftCols(m + 1).transpose();
+    phi_.row(nNodes_ - 1)    = phi.col(n - 1).transpose();
+    
+    if ( tail_.rows() > 0 )
+    {
+        MatrixXr boundary = MatrixXr::Zero( 2, nBatch );
+        boundary.row(0) = phi.col(m).transpose();
+        boundary.row(1) = phi.col(n - 1).transpose();
+        
+        phi_.middleRows(m + 1, tail_.rows()) = - tail_ * boundary;
+    }
+    
+    return;
+}
+
+void BatchedNonLinearPoisson1D::solve(MatrixXr & diag, MatrixXr & rhs) const
+{
+    const Index n = diag_.size();
+    
+    // Forward elimination: the inner loops run over the instances.
+    for ( Index i = 2; i < n - 1; ++i )
+    {
+        rhs .col(i).array() -= lower_(i) * rhs.col(i - 1).array() / diag.col(i - 1).array();
+        diag.col(i).array() -= (lower_(i) * upper_(i - 1)) * diag.col(i - 1).array().inverse();
+    }
+    
+    // Back substitution.
+    rhs.col(n - 2).array() /= diag.col(n - 2).array();
+    
+    for ( Index i = n - 3; i >= 1; --i )
+    {
+        rhs.col(i) = (rhs.col(i).array() - upper_(i) * rhs.col(i + 1).array()) / diag.col(i).array();
+    }
+    
+    return;
+}
+
+DriftDiffusion1D::DriftDiffusion1D(const ParamList & params, const PdeSolver1D & solver, const Real & mobility, const bool & coupled,
+                                   const Index & maxIterationsNo, const Real & tolerance)
+    : params_(params), solver_(solver), mobility_(mobility), minDens_(1.0), coupled_(coupled), maxIterationsNo_(maxIterationsNo),
+      tolerance_(tolerance), PhiBcorr_(0.0), qTot_(0.0), cTot_(0.0)
+{
+    assert( maxIterationsNo_ > 0   );
+    assert( tolerance_       > 0.0 );
+    
+    if ( mobility_ <= 0.0 )
+    {
+        throw std::runtime_error("ERROR: the electron mobility must be positive.");
+    }
+    
+    std::shared_ptr<const CondensedSystem> condensed = Bim1DCache::condensed(solver_);
+    
+    const SparseXr & Stiff = condensed->Stiff;
+    const SparseXr & Mass  = condensed->Mass ;
+    
+    interfaceNo_ = condensed->interfaceNo;
+    tail_        = condensed->tail;
+    
+    assert( interfaceNo_ >= 1 && Stiff.rows() == interfaceNo_ + 2 );
+    
+    area_ = solver_.mesh_.segment(1, interfaceNo_) - solver_.mesh_.segment(0, interfaceNo_);
+    
+    lower_ = VectorXr::Zero( Stiff.rows() );
+    diag_  = VectorXr::Zero( Stiff.rows() );
+    upper_ = VectorXr::Zero( Stiff.rows() );
+    mass_  = VectorXr::Zero( Stiff.rows() );
+    
+    for ( Index j = 0; j < Stiff.outerSize(); ++j )
+    {
+        for ( SparseXr::InnerIterator it(Stiff, j); it; ++it )
+        {
+            if ( it.row() == it.col() )
+            {
+                diag_(it.row()) = it.value();
+            }
+            else if ( it.row() == it.col() + 1 )
+            {
+                lower_(it.row()) = it.value();
+            }
+            else if ( it.col() == it.row() + 1 )
+            {
+                upper_(it.row()) = it.value();
+            }
+            else if ( it.value() != 0.0 )
+            {
+                throw std::runtime_error("ERROR: the drift-diffusion solver requires a tridiagonal stiffness matrix.");
+            }
+        }
+    }
+    
+    for ( Index j = 0; j < Mass.outerSize(); ++j )
+    {
+        for ( SparseXr::InnerIterator it(Mass, j); it; ++it )
+        {
+            if ( it.row() == it.col() )
+            {
+                mass_(it.row()) = it.value();
+            }
+            else if ( it.value() != 0.0 )
+            {
+                throw std::runtime_error("ERROR: the drift-diffusion solver requires a lumped mass matrix.");
+            }
+        }
+    }
+}
+
+void DriftDiffusion1D::apply(const VectorXr & init_guess, const Charge & charge_fun)
+{
+    assert( init_guess.size() == solver_.mesh_.size() );
+    
+    const Index n = diag_.size();
+    const Index m = interfaceNo_;
+    
+    // Iterations run only on the nodes kept by the condensation.
+    VectorXr phi = VectorXr::Zero( n );
+    phi.head(m + 1) = init_guess.head(m + 1);
+    phi(n - 1)      = init_guess(init_guess.size() - 1);
+    
+    phin_ = VectorXr::Zero( m + 1 );    // Ohmic back contact.
+    
+    PhiBcorr_ = 0.0;
+    
+    std::vector<Real> norm;
+    
+    VectorXr  charge;
+    VectorXr dcharge;
+    VectorXr res    ;
+    
+    // Barrier correction from the outward electric field.
+    auto barrier = [this] (const Real & res0)
+    {
+        const Real coeff = params_.PhiBcoeff();
+        const Real f = coeff * coeff * ( -res0 / params_.eps_semic() );
+        
+        PhiBcorr_ = ( f > 0 ) ? std::sqrt(f) : f / 4;
+    };
+    
+    BlockList lower(m + 1);
+    BlockList diag (m + 1);
+    BlockList upper(m + 1);
+    
+    VectorXr resn;
+    
+    if ( coupled_ )
+    {
+        MatrixXr delta = MatrixXr::Zero( 2, m + 1 );
+        
+        for ( Index k = 0; k < maxIterationsNo_; ++k )
+        {
+            evaluate(charge_fun, phi, phin_, constants::V_TH * PhiBcorr_, charge, dcharge, res);
+            barrier( res(0) );
+            
+            jacobian(phin_, charge, dcharge, lower, diag, upper, resn);
+            
+            delta.row(0) = - res.head(m + 1).transpose();
+            delta.row(1) = - resn.transpose();
+            
+            solve(lower, diag, upper, delta);
+            
+            // Newton step, Dirichlet conditions on the back contact and on the gate.
+            phi  .segment(1, m) += delta.row(0).tail(m).transpose();
+            phin_.segment(1, m) += delta.row(1).tail(m).transpose();
+            
+            norm.push_back( delta.rightCols(m).cwiseAbs().maxCoeff() );
+            
+            if ( norm.back() < tolerance_ )
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        VectorXr jac ;
+        VectorXr dphi;
+        
+        for ( Index g = 0; g < maxIterationsNo_; ++g )
+        {
+            // Poisson equation, with the quasi-Fermi potential frozen.
+            for ( Index k = 0; k < maxIterationsNo_; ++k )
+            {
+                evaluate(charge_fun, phi, phin_, constants::V_TH * PhiBcorr_, charge, dcharge, res);
+                barrier( res(0) );
+                
+                jac  = diag_ - mass_.cwiseProduct(dcharge);
+                dphi = - res;
+                
+                solve(lower_, jac, upper_, dphi, 1, n - 2);
+                
+                phi.segment(1, n - 2) += dphi.segment(1, n - 2);
+                
+                norm.push_back( dphi.segment(1, n - 2).cwiseAbs().maxCoeff() );
+                
+                if ( norm.back() < tolerance_ )
+                {
+                    break;
+                }
+            }
+            
+            // Continuity equation, with the density frozen: no current flows through the blocking interface,
+            // hence the flux vanishes on each element.
+            VectorXr phin = phin_;
+            
+            for ( Index i = 1; i <= m; ++i )
+            {
+                phin(i) = phin(i - 1);
+            }
+            
+            const Real change = ( phin - phin_ ).cwiseAbs().maxCoeff();
+            
+            phin_ = phin;
+            
+            if ( change < tolerance_ )
+            {
+                break;
+            }
+        }
+    }
+    
+    norm_ = Eigen::Map<VectorXr>(norm.data(), norm.size());
+    
+    // Total charge, from the last residual.
+    qTot_ = res(n - 1);
+    
+    // Compute total capacitance: the coupled system is linearized with respect to the gate potential.
+    evaluate(charge_fun, phi, phin_, PhiBcorr_, charge, dcharge, res);
+    
+    jacobian(phin_, charge, dcharge, lower, diag, upper, resn);
+    
+    MatrixXr u = MatrixXr::Zero( 2, m + 1 );
+    u(0, m) = - upper_(m);
+    
+    solve(lower, diag, upper, u);
+    
+    cTot_ = lower_(n - 1) * u(0, m) + diag_(n - 1) - mass_(n - 1) * dcharge(n - 1);
+    
+    // Linearization kept for the small-signal analysis.
+    dcharge_ = dcharge;
+    
+    continuity(( - charge.head(m + 1) / constants::Q ).cwiseMax( minDens_ ), cond_);
+    
+    // Reconstruct the potential in the charge-free region.
+    phi_ = VectorXr::Zero( solver_.mesh_.size() );
+    
+    phi_.head(m + 1)      = phi.head(m + 1);
+    phi_(phi_.size() - 1) = phi(n - 1);
+    
+    if ( tail_.rows() > 0 )
+    {
+        phi_.segment(m + 1, tail_.rows()) = - tail_ * Matrix<Real, 2, 1>(phi(m), phi(n - 1));
+    }
+    
+    return;
+}
+
+void DriftDiffusion1D::admittance(const VectorXr & frequencies, VectorXr & C, VectorXr & G) const
+{
+    assert( dcharge_.size() == diag_.size() );
+    
+    typedef Matrix<Real   , 3, 3> RealBlock   ;
+    typedef Matrix<Complex, 3, 3> ComplexBlock;
+    
+    const Index n     = diag_.size();
+    const Index m     = interfaceNo_;
+    const Index nFreq = frequencies.size();
+    
+    const Complex I(0.0, 1.0);
+    
+    // Blocks of node i, the unknowns being ordered as (phi, phin, flux on the element i - 1).
+    auto lower = [&] (const Index & i)
+    {
+        RealBlock L = RealBlock::Zero();
+        
+        L(0, 0) = lower_(i);
+        L(1, 1) = - 1.0;
+        
+        return L;
+    };
+    
+    auto upper = [&] (const Index & i)
+    {
+        RealBlock U = RealBlock::Zero();
+        
+        U(0, 0) = upper_(i);
+        
+        if ( i < m )
+        {
+            U(2, 2) = - 1.0;
+        }
+        
+        return U;
+    };
+    
+    auto diag = [&] (const Index & i, const Real & frequency)
+    {
+        // Rate of change of the density in the box of node i.
+        const Complex w = I * ( 2.0 * constants::PI * frequency ) * mass_(i) * ( - dcharge_(i) / constants::Q );
+        
+        ComplexBlock D = ComplexBlock::Zero();
+        
+        D(0, 0) = diag_(i) - mass_(i) * dcharge_(i);
+        D(0, 1) = mass_(i) * dcharge_(i);
+        D(1, 1) = 1.0;
+        D(1, 2) = - 1.0 / cond_(i - 1);
+        D(2, 0) = - w;
+        D(2, 1) = w;
+        D(2, 2) = 1.0;
+        
+        return D;
+    };
+    
+    // Forward elimination, the frequencies being the inner loop. The right-hand side vanishes but on the
+    // last node, hence only the main diagonal is eliminated.
+    std::vector<ComplexBlock, aligned_allocator<ComplexBlock> > D(nFreq);
+    
+    for ( Index k = 0; k < nFreq; ++k )
+    {
+        D[k] = diag(1, frequencies(k));
+    }
+    
+    for ( Index i = 2; i <= m; ++i )
+    {
+        const RealBlock L = lower(i    );
+        const RealBlock U = upper(i - 1);
+        
+        for ( Index k = 0; k < nFreq; ++k )
+        {
+            D[k] = diag(i, frequencies(k)) - L * D[k].partialPivLu().solve(U.cast<Complex>());
+        }
+    }
+    
+    // Unit signal on the gate, and charge response at the gate.
+    C = VectorXr::Zero( nFreq );
+    G = VectorXr::Zero( nFreq );
+    
+    for ( Index k = 0; k < nFreq; ++k )
+    {
+        const Complex dphi = D[k].partialPivLu().solve(Matrix<Complex, 3, 1>(- upper_(m), 0.0, 0.0))(0);
+        
+        const Complex dQ = lower_(n - 1) * dphi + diag_(n - 1) - mass_(n - 1) * dcharge_(n - 1);
+        
+        C(k) = dQ.real();
+        G(k) = - 2.0 * constants::PI * frequencies(k) * dQ.imag();
+    }
+    
+    return;
+}
+
+void DriftDiffusion1D::evaluate(const Charge & charge_fun, const VectorXr & phi, const VectorXr & phin, const Real & shift,
+                                VectorXr & charge, VectorXr & dcharge, VectorXr & res) const
+{
+    const Index n = phi.size();
+    
+    VectorXr psi = phi.array() + shift;
+    psi.head(phin.size()) -= phin;
+    
+    charge  = charge_fun. charge(psi);
+    dcharge = charge_fun.dcharge(psi);
+    
+    res = VectorXr::Zero( n );
+    
+    res(0) = diag_(0) * phi(0) + upper_(0) * phi(1) - mass_(0) * charge(0);
+    
+    for ( Index i = 1; i < n - 1; ++i )
+    {
+        res(i) = lower_(i) * phi(i - 1) + diag_(i) * phi(i) + upper_(i) * phi(i + 1) - mass_(i) * charge(i);
+    }
+    
+    res(n - 1) = lower_(n - 1) * phi(n - 2) + diag_(n - 1) * phi(n - 1) - mass_(n - 1) * charge(n - 1);
+    
+    return;
+}
+
+void DriftDiffusion1D::continuity(const VectorXr & dens, VectorXr & cond) const
+{
+    const Index m = interfaceNo_;
+    
+    assert( dens.size() == m + 1 );
+    
+    // Off-diagonal coefficients of Bim1D::assembleAdvDiff with no drift, the Bernoulli function being 1.
+    cond = ( mobility_ * Bim1D::log_mean(dens.head(m), dens.tail(m)) ).cwiseQuotient(area_);
+    
+    return;
+}
+
+void DriftDiffusion1D::jacobian(const VectorXr & phin, const VectorXr & charge, const VectorXr & dcharge,
+                                BlockList & lower, BlockList & diag, BlockList & upper, VectorXr & res) const
+{
+    const Index m = interfaceNo_;
+    const VectorXr & x = solver_.mesh_;
+    
+    VectorXr  dens = ( - charge.head(m + 1) / constants::Q ).cwiseMax( minDens_ );
+    VectorXr ddens = - dcharge.head(m + 1) / constants::Q;
+    
+    VectorXr cond;
+    
+    continuity(dens, cond);
+    
+    res = VectorXr::Zero( m + 1 );
+    
+    lower.resize(m + 1);
+    diag .resize(m + 1);
+    upper.resize(m + 1);
+    
+    for ( Index i = 1; i <= m; ++i )
+    {
+        // Flux on the element i - 1, scaled by its conductance c, and its relative derivatives
+        // with respect to the density at the end-points.
+        const Real du = phin(i) - phin(i - 1);
+        
+        Real g_l = 0.0;
+        Real g_d = 0.0;
+        
+        if ( du != 0.0 )
+        {
+            const Real scale = du * mobility_ / ( (x(i) - x(i - 1)) * cond(i - 1) );
+            
+            g_l = scale * dlog_mean(dens(i - 1), dens(i)) * ddens(i - 1);
+            g_d = scale * dlog_mean(dens(i), dens(i - 1)) * ddens(i);
+        }
+        
+        res(i) = du;
+        
+        // Unknowns ordered as (phi, phin), n depending on phi - phin.
+        diag [i] << diag_(i) - mass_(i) * dcharge(i), mass_(i) * dcharge(i),
+                 g_d, 1.0 - g_d;
+        lower[i] << lower_(i), 0.0,
+                 g_l, - 1.0 - g_l;
+        upper[i] << upper_(i), 0.0,
+                 0.0, 0.0;
+    }
+    
+    return;
+}
+
+Real DriftDiffusion1D::dlog_mean(const Real & x1, const Real & x2)
+{
+    const Real d = std::log(x2 / x1);
+    
+    if ( std::abs(d) < 1.0e-3 )
+    {
+        return 0.5 + d / 6.0 + d * d / 24.0;
+    }
+    
+    return ( (x2 - x1) / (x1 * d) - 1.0 ) / d;
+}
+
+void DriftDiffusion1D::solve(const VectorXr & lower, VectorXr & diag, const VectorXr & upper, VectorXr & rhs,
+                             const Index & first, const Index & last)
+{
+    // Forward elimination.
+    for ( Index i = first + 1; i <= last; ++i )
+    {
+        const Real w = lower(i) / diag(i - 1);
+        
+        diag(i) -= w * upper(i - 1);
+        rhs (i) -= w * rhs(i - 1);
+    }
+    
+    // Back substitution.
+    rhs(last) /= diag(last);
+    
+    for ( Index i = last - 1; i >= first; --i )
+    {
+        rhs(i) = ( rhs(i) - upper(i) * rhs(i + 1) ) / diag(i);
+    }
+    
+    return;
+}
+
+void DriftDiffusion1D::solve(const BlockList & lower, BlockList & diag, const BlockList & upper, MatrixXr & rhs)
+{
+    const Index last = diag.size() - 1;
+    
+    // Forward elimination.
+    for ( Index i = 2; i <= last; ++i )
+    {
+        const Block w = lower[i] * diag[i - 1].inverse();
+        
+        diag[i]    -= w * upper[i - 1];
+        rhs.col(i) -= w * rhs.col(i - 1);
+    }
+    
+    // Back substitution.
+    rhs.col(last) = diag[last].inverse() * rhs.col(last);
+    
+    for ( Index i = last - 1; i >= 1; --i )
+    {
+        rhs.col(i) = diag[i].inverse() * ( rhs.col(i) - upper[i] * rhs.col(i + 1) );
+    }
+    
+    return;
+}
+
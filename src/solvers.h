@@ -22,8 +22,12 @@
 
 #include <utility>    // std::make_pair
 #include <limits>    // std::numeric_limits<>::epsilon
+#include <list>
+#include <memory>    // std::shared_ptr
+#include <vector>
 
 class NonLinearPoisson1D;    // Forward declaration.
+class DriftDiffusion1D;      // Forward declaration.
 
 /**
  * @class PdeSolver1D
@@ -37,6 +41,7 @@ class PdeSolver1D
 {
     public:
         friend class NonLinearPoisson1D;
+        friend class DriftDiffusion1D;
         // Now NonLinearPoisson1D can access system matrices with no need to
         // copy them through getter methods that slow down the program execution.
         
@@ -134,6 +139,8 @@ class Bim1D : public PdeSolver1D
         /**
          * @f[ M_{log}(x_1, x_2) = \frac{x_2 - x_1}{\log{x_2} - \log{x_1}} =
          * \frac{x_2 - x_1}{\log\left(\frac{x_2}{x_1}\right)} ~ .@f]
+         * Evaluated branch-free by array expressions: where @f$ u = \frac{x_2 - x_1}{x_2 + x_1} @f$ is small,
+         * @f$ M_{log} = \frac{x_1 + x_2}{2} \frac{u}{\operatorname{atanh}(u)} @f$ by a truncated series.
          * @brief Compute the element-wise logarithmic mean of two vectors.
          *
          * @param[in] x1 : the first vector;
@@ -143,6 +150,8 @@ class Bim1D : public PdeSolver1D
         static VectorXr log_mean(const VectorXr &, const VectorXr &);
         /**
          * @f[ \mathfrak{B}(x) = \frac{x}{e^x - 1} ~ .@f]
+         * Evaluated branch-free by array expressions, with a single exponential for both values:
+         * @f$ \mathfrak{B}(-x) = \frac{x}{1 - e^{-x}} @f$, and a truncated Taylor expansion for small arguments.
          * @brief Compute the values of the Bernoulli function.
          * @param[in] x : the vector of the values to compute the Bernoulli function at.
          * @returns the pair @f$ \left(\mathfrak{B}(x), \mathfrak{B}(-x)\right) @f$.
@@ -180,6 +189,93 @@ class Bim1D : public PdeSolver1D
         virtual void assembleMass   (const VectorXr &, const VectorXr &) override;
 };
 
+/**
+ * @brief Struct holding the system matrices of the Poisson equation once the charge-free nodes have been
+ * eliminated by static condensation (see @ref NonLinearPoisson1D): nodes @f$ 0, \ldots, m @f$ are kept,
+ * the last node is renumbered as @f$ m + 1 @f$.
+ */
+struct CondensedSystem
+{
+    SparseXr Stiff;    /**< @brief Condensed stiffness matrix. */
+    SparseXr Mass ;    /**< @brief Condensed mass matrix. */
+    
+    Index    interfaceNo;    /**< @brief Index @f$ m @f$ of the last node carrying charge. */
+    MatrixXr tail       ;    /**< @brief Map from the potential at the interface and at the last node to the eliminated nodes. */
+};
+
+/**
+ * @class Bim1DCache
+ *
+ * The matrices assembled by @ref Bim1D for the Poisson equation depend only on the mesh,
+ * on the permittivity and on the mask of the region carrying charge: simulations sharing them
+ * (e.g. the candidates of a fitting iteration) share a single immutable solver, assembled once,
+ * together with its condensed system, computed at the first request.
+ * The most recently used solvers are kept, up to @ref maxEntriesNo. Access is thread-safe.
+ *
+ * @brief Class providing a cache of assembled @ref Bim1D solvers.
+ *
+ */
+class Bim1DCache
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since the class only provides static methods).
+         */
+        Bim1DCache() = delete;
+        
+        /**
+         * @brief Get a solver with assembled stiffness and mass matrices.
+         * @param[in] mesh : the mesh coordinates;
+         * @param[in] eps  : the permittivity, an element-wise constant function;
+         * @param[in] mask : the mask of the region carrying charge, an element-wise constant function.
+         * @returns a shared pointer to the solver.
+         */
+        static std::shared_ptr<const Bim1D> get(const VectorXr &, const VectorXr &, const VectorXr &);
+        /**
+         * The semiconductor occupies the negative abscissae and carries charge, the insulator the positive ones.
+         *
+         * @brief Get a solver with assembled stiffness and mass matrices for a MIS capacitor.
+         * @param[in] mesh   : the mesh coordinates;
+         * @param[in] params : a parameter list, providing the permittivities.
+         * @returns a shared pointer to the solver.
+         */
+        static std::shared_ptr<const Bim1D> get(const VectorXr &, const ParamList &);
+        
+        /**
+         * The condensed system of a solver held by the cache is computed once and kept with it;
+         * for any other solver it is computed on the fly.
+         *
+         * @brief Get the system matrices of a solver, condensed as in @ref NonLinearPoisson1D.
+         * @param[in] solver : the solver holding the system matrices.
+         * @returns a shared pointer to the condensed system.
+         */
+        static std::shared_ptr<const CondensedSystem> condensed(const PdeSolver1D &);
+        
+        /**
+         * @brief Remove all the solvers from the cache.
+         */
+        static void clear();
+        
+        static const std::size_t maxEntriesNo = 16;    /**< @brief Maximum number of solvers kept. */
+        
+    private:
+        /**
+         * @brief Struct holding a cached solver and its key.
+         */
+        struct Entry
+        {
+            VectorXr mesh;    /**< @brief The mesh coordinates. */
+            VectorXr eps ;    /**< @brief The permittivity. */
+            VectorXr mask;    /**< @brief The mask of the region carrying charge. */
+            
+            std::shared_ptr<const Bim1D> solver;    /**< @brief The assembled solver. */
+            
+            std::shared_ptr<const CondensedSystem> condensed;    /**< @brief Its condensed system (nullptr until requested). */
+        };
+        
+        static std::list<Entry> entries_;    /**< @brief The cached solvers, the most recently used first. */
+};
+
 /**
  * @class NonLinearPoisson1D
  *
@@ -188,12 +284,20 @@ class Bim1D : public PdeSolver1D
  * - q \cdot \frac{N_0}{\sqrt{\pi}} \int_{-\infty}^{+\infty} \exp\left(-\alpha^2\right) \left( 1 +
  * \exp\left( \frac{\sqrt{2}\sigma\alpha - q\varphi(z)}{K_B \cdot T} \right) \right)^{-1} \mathrm{d}\alpha ~ . @f]
  *
+ * The equation is linear in the charge-free region (the insulator), i.e. where the mass matrix vanishes:
+ * the nodes lying strictly between the last charged node and the last one are eliminated by static
+ * condensation (Schur complement), which is equivalent to a Robin condition at the interface. The Newton method
+ * iterates only on the remaining nodes, and the potential in the charge-free region is reconstructed afterwards.
+ *
  * @brief Provide a solver for the non-linear Poisson equation.
  *
  */
 class NonLinearPoisson1D
 {
     public:
+        friend class Bim1DCache;
+        // Now Bim1DCache can share the condensation of the system matrices.
+        
         /**
          * @brief Default constructor (deleted since it is required to specify the solver to be used).
          */
@@ -240,6 +344,15 @@ class NonLinearPoisson1D
          * @returns the Jacobi matrix in a sparse format.
          */
         SparseXr computeJac(const VectorXr &) const;
+        /**
+         * @brief Eliminate the charge-free nodes from the system matrices of a solver.
+         * @param[in]  solver      : the solver holding the system matrices;
+         * @param[out] Stiff       : the condensed stiffness matrix;
+         * @param[out] Mass        : the condensed mass matrix;
+         * @param[out] interfaceNo : the index of the last node carrying charge;
+         * @param[out] tail        : the map from the potential at the interface and at the last node to the eliminated nodes.
+         */
+        static void condense(const PdeSolver1D &, SparseXr &, SparseXr &, Index &, MatrixXr &);
         
         const ParamList   & params_;    /**< @brief The arameter list. */
         const PdeSolver1D & solver_;    /**< @brief Solver handler. */
@@ -247,6 +360,14 @@ class NonLinearPoisson1D
         const Index & maxIterationsNo_;    /**< @brief Maximum number of iterations. */
         const Real  & tolerance_      ;    /**< @brief Tolerance. */
         
+        std::shared_ptr<const CondensedSystem> condensed_;    /**< @brief The condensed system, shared through @ref Bim1DCache. */
+        
+        const SparseXr & Stiff_;    /**< @brief Condensed stiffness matrix. */
+        const SparseXr & Mass_ ;    /**< @brief Condensed mass matrix. */
+        
+        const Index    & interfaceNo_;    /**< @brief Index of the last node carrying charge. */
+        const MatrixXr & tail_       ;    /**< @brief Map from the potential at the interface and at the last node to the eliminated nodes. */
+        
         Real PhiBcorr_;    /**< @brief Barrier correction. */
         
         VectorXr phi_ ;    /**< @brief The electric potential. */
@@ -257,6 +378,276 @@ class NonLinearPoisson1D
         /* Real cTot_n_; */
 };
 
+/**
+ * Several instances of the non-linear Poisson equation sharing the system matrices (i.e. the mesh and the
+ * device geometry) and differing only in the charge, e.g. parameter sets with different @f$ \sigma @f$,
+ * are advanced in lockstep by the same Newton method of @ref NonLinearPoisson1D.
+ *
+ * The potentials are stored as a structure of arrays, the values of all the instances at a node being
+ * contiguous: the tridiagonal systems of all the instances are solved by a single Thomas algorithm
+ * interleaved across them, whose inner loops run over the instances and are vectorized, and the charges
+ * of all the instances are evaluated by a single call to @ref Charge::evaluate_batch.
+ * The instances which have converged are frozen, until all of them have converged.
+ *
+ * @brief Provide a solver for a batch of non-linear Poisson equations.
+ *
+ */
+class BatchedNonLinearPoisson1D
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the solver to be used).
+         */
+        BatchedNonLinearPoisson1D() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] params          : a parameter list (only the geometry, shared by all the instances, is used);
+         * @param[in] solver          : the solver to be used, whose matrices must be tridiagonal;
+         * @param[in] maxIterationsNo : maximum number of iterations desired;
+         * @param[in] tolerance       : tolerance desired.
+         */
+        BatchedNonLinearPoisson1D(const ParamList &, const PdeSolver1D &, const Index & = 100, const Real & = 1.0e-6);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~BatchedNonLinearPoisson1D() = default;
+        
+        /**
+         * @brief Apply the Newton method to all the instances.
+         * @param[in] init_guess : initial guesses for the Newton algorithm, one column per instance;
+         * @param[in] charge_fun : objects of class @ref Charge specifying how to compute total electric charge, one per instance.
+         */
+        void apply(const MatrixXr &, const std::vector<const Charge *> &);
+        
+        /**
+         * @name Getter methods
+         * @{
+         */
+        inline const VectorXr      & PhiBcorr()     const;
+        inline const MatrixXr      & phi()          const;
+        inline const VectorXr      & norm()         const;
+        inline const VectorX<Index> & iterationsNo() const;
+        inline const VectorXr      & qTot()         const;
+        inline const VectorXr      & cTot()         const;
+        
+        /**
+         * @}
+         */
+        
+    private:
+        /**
+         * @brief Solve the tridiagonal systems of all the instances on the interior nodes.
+         * @param[in,out] diag : main diagonals, one row per instance (overwritten);
+         * @param[in,out] rhs  : right-hand sides, one row per instance (overwritten by the solutions).
+         */
+        void solve(MatrixXr &, MatrixXr &) const;
+        
+        const ParamList & params_;    /**< @brief The parameter list. */
+        
+        const Index & maxIterationsNo_;    /**< @brief Maximum number of iterations. */
+        const Real  & tolerance_      ;    /**< @brief Tolerance. */
+        
+        Index    nNodes_     ;    /**< @brief Number of nodes of the mesh. */
+        Index    interfaceNo_;    /**< @brief Index of the last node carrying charge. */
+        MatrixXr tail_       ;    /**< @brief Map from the potential at the interface and at the last node to the eliminated nodes. */
+        
+        VectorXr lower_;    /**< @brief Sub-diagonal of the condensed stiffness matrix (@a lower_(i) in row @a i). */
+        VectorXr diag_ ;    /**< @brief Main diagonal of the condensed stiffness matrix. */
+        VectorXr upper_;    /**< @brief Super-diagonal of the condensed stiffness matrix (@a upper_(i) in row @a i). */
+        VectorXr mass_ ;    /**< @brief Diagonal of the condensed mass matrix. */
+        
+        VectorXr       PhiBcorr_    ;    /**< @brief Barrier corrections. */
+        MatrixXr       phi_         ;    /**< @brief The electric potentials, one column per instance. */
+        VectorXr       norm_        ;    /**< @brief @f$ L^\infty @f$-norm errors of the last iteration. */
+        VectorX<Index> iterationsNo_;    /**< @brief Numbers of iterations performed. */
+        VectorXr       qTot_        ;    /**< @brief Total charges. */
+        VectorXr       cTot_        ;    /**< @brief Total capacitances. */
+};
+
+/**
+ * @class DriftDiffusion1D
+ *
+ * The non-linear Poisson equation is coupled with the continuity equation of the electrons in the semiconductor,
+ * written in terms of the electron quasi-Fermi potential @f$ \varphi_n @f$:
+ * @f[ -\frac{\mathrm{d}}{\mathrm{d}z} \left(\epsilon \frac{\mathrm{d}\varphi}{\mathrm{d}z} \right) = \rho(\varphi - \varphi_n) ~ , \qquad
+ * -\frac{\mathrm{d}}{\mathrm{d}z} \left(\mu_n n \frac{\mathrm{d}\varphi_n}{\mathrm{d}z} \right) = 0 ~ , \qquad
+ * n = -\frac{\rho}{q} ~ . @f]
+ * The continuity equation is discretized by @ref Bim1D::assembleAdvDiff, the conductance of each element being given
+ * by the logarithmic mean of the density, so that a flat quasi-Fermi potential (the equilibrium) is preserved exactly.
+ * The back contact is ohmic (@f$ \varphi_n = 0 @f$), the semiconductor/insulator interface is blocking: the box
+ * equations, summed from the interface, give the flux on each element, which is used instead of them since it stays
+ * well conditioned across depleted regions, where the conductance drops by many orders of magnitude.
+ * The charge-free insulator is condensed as in @ref NonLinearPoisson1D.
+ *
+ * Two methods are provided: a Gummel iteration, alternating the Newton method on the Poisson equation with
+ * @f$ \varphi_n @f$ frozen and the solution of the continuity equation with @f$ n @f$ frozen; and a fully coupled
+ * Newton method, whose Jacobian, with the unknowns interleaved by node, is block-tridiagonal with @f$ 2 \times 2 @f$
+ * blocks and is solved by a block Thomas algorithm.
+ *
+ * @brief Provide a quasi-static drift-diffusion solver.
+ *
+ */
+class DriftDiffusion1D
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the solver to be used).
+         */
+        DriftDiffusion1D() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] params          : a parameter list;
+         * @param[in] solver          : the solver to be used, whose matrices must be tridiagonal;
+         * @param[in] mobility        : the electron mobility @f$ \left[ m^2 \cdot V^{-1} \cdot s^{-1} \right] @f$;
+         * @param[in] coupled         : whether to use the fully coupled Newton method instead of the Gummel iteration;
+         * @param[in] maxIterationsNo : maximum number of iterations desired;
+         * @param[in] tolerance       : tolerance desired.
+         */
+        DriftDiffusion1D(const ParamList &, const PdeSolver1D &, const Real &, const bool & = true,
+                         const Index & = 100, const Real & = 1.0e-6);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~DriftDiffusion1D() = default;
+        
+        /**
+         * @brief Solve the coupled equations.
+         * @param[in] init_guess : initial guess for the electric potential;
+         * @param[in] charge_fun : an object of class @ref Charge specifying how to compute total electric charge.
+         */
+        void apply(const VectorXr &, const Charge &);
+        
+        /**
+         * A small harmonic signal is superimposed on the gate bias of the solution computed by @ref apply.
+         * The system is linearized as for the quasi-static capacitance, the electrons being no longer in equilibrium
+         * with the back contact: the time derivative of the density enters the continuity equation. The unknowns are
+         * the potential, the quasi-Fermi potential and the flux on the element below each node, which keeps the
+         * continuity equation well conditioned, and the system is block-tridiagonal with complex @f$ 3 \times 3 @f$
+         * blocks. Only the main diagonal depends on the frequency: the frequencies are the inner loop of a single
+         * block Thomas sweep sharing the off-diagonal blocks.
+         *
+         * @brief Compute the small-signal capacitance and conductance at a list of frequencies.
+         * @param[in]  frequencies : the frequencies @f$ \left[ Hz \right] @f$;
+         * @param[out] C           : the capacitance per unit area at each frequency @f$ \left[ F \cdot m^{-2} \right] @f$;
+         * @param[out] G           : the conductance per unit area at each frequency @f$ \left[ S \cdot m^{-2} \right] @f$.
+         */
+        void admittance(const VectorXr &, VectorXr &, VectorXr &) const;
+        
+        /**
+         * @name Getter methods
+         * @{
+         */
+        inline const Real     & PhiBcorr() const;
+        inline const VectorXr & phi()      const;
+        inline const VectorXr & phin()     const;
+        inline const VectorXr & norm()     const;
+        inline const Real     & qTot()     const;
+        inline const Real     & cTot()     const;
+        
+        /**
+         * @}
+         */
+        
+    private:
+        typedef Matrix<Real, 2, 2> Block;    /**< @brief Typedef for a block of the coupled Jacobian. */
+        typedef std::vector<Block, aligned_allocator<Block> > BlockList;    /**< @brief Typedef for a diagonal of blocks. */
+        
+        /**
+         * @brief Evaluate the charge, its derivative and the residual of the Poisson equation.
+         * @param[in]  charge_fun : an object of class @ref Charge specifying how to compute total electric charge;
+         * @param[in]  phi        : the electric potential on the condensed nodes;
+         * @param[in]  phin       : the quasi-Fermi potential on the semiconductor nodes;
+         * @param[in]  shift      : the shift of the argument of the charge;
+         * @param[out] charge     : the charge;
+         * @param[out] dcharge    : its derivative;
+         * @param[out] res        : the residual of the Poisson equation.
+         */
+        void evaluate(const Charge &, const VectorXr &, const VectorXr &, const Real &,
+                      VectorXr &, VectorXr &, VectorXr &) const;
+        /**
+         * @f$ c_k = \mu_n M_{log}(n_k, n_{k+1}) / h_k @f$, the coefficients of @ref Bim1D::assembleAdvDiff with no drift,
+         * computed with no need to assemble the matrix.
+         *
+         * @brief Compute the conductance of the elements of the semiconductor from the continuity equation.
+         * @param[in]  dens : the electron density on the semiconductor nodes;
+         * @param[out] cond : the conductances @f$ c_k @f$, one per element.
+         */
+        void continuity(const VectorXr &, VectorXr &) const;
+        /**
+         * The continuity rows are written in flux form, @f$ c_k \left(\varphi_{n, k+1} - \varphi_{n, k}\right) = 0 @f$
+         * on each element, and scaled by the conductance.
+         *
+         * @brief Assemble the coupled Jacobian on the interior nodes.
+         * @param[in]  phin    : the quasi-Fermi potential on the semiconductor nodes;
+         * @param[in]  charge  : the charge;
+         * @param[in]  dcharge : its derivative;
+         * @param[out] lower   : sub-diagonal blocks;
+         * @param[out] diag    : main diagonal blocks;
+         * @param[out] upper   : super-diagonal blocks;
+         * @param[out] res     : the scaled residual of the continuity equation.
+         */
+        void jacobian(const VectorXr &, const VectorXr &, const VectorXr &,
+                      BlockList &, BlockList &, BlockList &, VectorXr &) const;
+                      
+        /**
+         * @f[ \frac{\partial M_{log}}{\partial x_1}(x_1, x_2) = \frac{M_{log}(x_1, x_2) / x_1 - 1}{\log\left(\frac{x_2}{x_1}\right)} ~ , @f]
+         * by a truncated series when the logarithm is small.
+         * @brief Compute the derivative of the logarithmic mean with respect to its first argument.
+         * @param[in] x1 : the first argument;
+         * @param[in] x2 : the second argument.
+         * @returns the derivative.
+         */
+        static Real dlog_mean(const Real &, const Real &);
+        /**
+         * @brief Solve a tridiagonal system on the rows from @a first to @a last, by the Thomas algorithm.
+         * @param[in]     lower : sub-diagonal;
+         * @param[in,out] diag  : main diagonal (overwritten);
+         * @param[in]     upper : super-diagonal;
+         * @param[in,out] rhs   : right-hand side (overwritten by the solution);
+         * @param[in]     first : first row;
+         * @param[in]     last  : last row.
+         */
+        static void solve(const VectorXr &, VectorXr &, const VectorXr &, VectorXr &, const Index &, const Index &);
+        /**
+         * @brief Solve a block-tridiagonal system on the rows from 1 to @a diag.size() - 1, by the block Thomas algorithm.
+         * @param[in]     lower : sub-diagonal blocks;
+         * @param[in,out] diag  : main diagonal blocks (overwritten);
+         * @param[in]     upper : super-diagonal blocks;
+         * @param[in,out] rhs   : right-hand side, one column per node (overwritten by the solution).
+         */
+        static void solve(const BlockList &, BlockList &, const BlockList &, MatrixXr &);
+        
+        const ParamList   & params_;    /**< @brief The parameter list. */
+        const PdeSolver1D & solver_;    /**< @brief Solver handler. */
+        
+        Real  mobility_       ;    /**< @brief Electron mobility. */
+        Real  minDens_        ;    /**< @brief Lower bound of the electron density in the continuity equation, keeping it non-degenerate in depleted regions @f$ \left[ m^{-3} \right] @f$. */
+        bool  coupled_        ;    /**< @brief Whether to use the fully coupled Newton method. */
+        Index maxIterationsNo_;    /**< @brief Maximum number of iterations. */
+        Real  tolerance_      ;    /**< @brief Tolerance. */
+        
+        Index    interfaceNo_;    /**< @brief Index of the last node carrying charge. */
+        MatrixXr tail_       ;    /**< @brief Map from the potential at the interface and at the last node to the eliminated nodes. */
+        
+        VectorXr lower_;    /**< @brief Sub-diagonal of the condensed stiffness matrix (@a lower_(i) in row @a i). */
+        VectorXr diag_ ;    /**< @brief Main diagonal of the condensed stiffness matrix. */
+        VectorXr upper_;    /**< @brief Super-diagonal of the condensed stiffness matrix (@a upper_(i) in row @a i). */
+        VectorXr mass_ ;    /**< @brief Diagonal of the condensed mass matrix. */
+        VectorXr area_ ;    /**< @brief Widths of the elements of the semiconductor. */
+        
+        Real PhiBcorr_;    /**< @brief Barrier correction. */
+        
+        VectorXr phi_ ;    /**< @brief The electric potential. */
+        VectorXr phin_;    /**< @brief The electron quasi-Fermi potential on the semiconductor nodes. */
+        VectorXr norm_;    /**< @brief Vector holding @f$ L^\infty @f$-norm errors for each iteration. */
+        
+        Real qTot_;    /**< @brief Total charge. */
+        Real cTot_;    /**< @brief Total capacitance. */
+        
+        VectorXr dcharge_;    /**< @brief Derivative of the charge at the solution, as used for the capacitance. */
+        VectorXr cond_   ;    /**< @brief Conductance of the elements of the semiconductor at the solution. */
+};
+
 // Implementations.
 inline const SparseXr & PdeSolver1D::AdvDiff() const
 {
@@ -298,6 +689,66 @@ inline const Real & NonLinearPoisson1D::cTot() const
     return cTot_;
 }
 
+inline const VectorXr & BatchedNonLinearPoisson1D::PhiBcorr() const
+{
+    return PhiBcorr_;
+}
+
+inline const MatrixXr & BatchedNonLinearPoisson1D::phi() const
+{
+    return phi_;
+}
+
+inline const VectorXr & BatchedNonLinearPoisson1D::norm() const
+{
+    return norm_;
+}
+
+inline const VectorX<Index> & BatchedNonLinearPoisson1D::iterationsNo() const
+{
+    return iterationsNo_;
+}
+
+inline const VectorXr & BatchedNonLinearPoisson1D::qTot() const
+{
+    return qTot_;
+}
+
+inline const VectorXr & BatchedNonLinearPoisson1D::cTot() const
+{
+    return cTot_;
+}
+
+inline const Real & DriftDiffusion1D::PhiBcorr() const
+{
+    return PhiBcorr_;
+}
+
+inline const VectorXr & DriftDiffusion1D::phi() const
+{
+    return phi_;
+}
+
+inline const VectorXr & DriftDiffusion1D::phin() const
+{
+    return phin_;
+}
+
+inline const VectorXr & DriftDiffusion1D::norm() const
+{
+    return norm_;
+}
+
+inline const Real & DriftDiffusion1D::qTot() const
+{
+    return qTot_;
+}
+
+inline const Real & DriftDiffusion1D::cTot() const
+{
+    return cTot_;
+}
+
 /* inline const Real & NonLinearPoisson1D::cTot_n() const
 {
     return cTot_n_;
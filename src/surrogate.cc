@@ -0,0 +1,246 @@
+/* C++11 */
+
+/**
+ * @file   surrogate.cc
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ */
+
+#include "surrogate.h"
+
+using namespace constants;
+
+CvSurrogate::CvSurrogate(const VectorXr & V, const Real & noise)
+    : V_(V), noise_(noise), lengthScale_(1.0), trained_(false)
+{
+    assert( V_.size() > 1   );
+    assert( noise_    > 0.0 );
+}
+
+VectorXr CvSurrogate::features(const ParamList & params)
+{
+    VectorXr features = VectorXr::Zero( 3 );
+    
+    features(0) = params.sigma() / KB_T;
+    features(1) = std::log10( params.N0() );
+    features(2) = ( params.Wf() - params.Ea() ) / Q;
+    
+    return features;
+}
+
+void CvSurrogate::addSample(const ParamList & params, const VectorXr & V, const VectorXr & C)
+{
+    assert( V.size() == C.size() );
+    
+    X_.push_back( features(params) );
+    
+    if ( V.size() == V_.size() && V == V_ )
+    {
+        Y_.push_back( C );
+    }
+    else    // Bring the sample onto the voltage grid of the model.
+    {
+        Y_.push_back( numerics::interp1(V, C, V_) );
+        
+        if ( std::isnan( Y_.back().sum() ) )
+        {
+            throw std::runtime_error("ERROR: the simulated voltage range does not cover the voltage grid of the surrogate model.");
+        }
+    }
+    
+    trained_ = false;
+    
+    return;
+}
+
+void CvSurrogate::train()
+{
+    const Index nSamples = X_.size();
+    
+    if ( nSamples < 2 )
+    {
+        throw std::logic_error("ERROR: at least two samples are required to train the surrogate model.");
+    }
+    
+    // Normalize features and outputs.
+    MatrixXr X = MatrixXr::Zero( nSamples, X_[0].size() );
+    MatrixXr Y = MatrixXr::Zero( nSamples, V_.size()    );
+    
+    for ( Index i = 0; i < nSamples; ++i )
+    {
+        X.row(i) = X_[i].transpose();
+        Y.row(i) = Y_[i].transpose();
+    }
+    
+    X_mean_  = X.colwise().mean().transpose();
+    X_scale_ = ( X.rowwise() - X_mean_.transpose() ).colwise().norm().transpose() / std::sqrt(nSamples);
+    
+    Y_mean_  = Y.colwise().mean();
+    Y_scale_ = ( Y.rowwise() - Y_mean_ ).colwise().norm() / std::sqrt(nSamples);
+    
+    for ( Index j = 0; j < X_scale_.size(); ++j )
+    {
+        if ( X_scale_(j) == 0.0 )    // Feature not varying across the samples.
+        {
+            X_scale_(j) = 1.0;
+        }
+    }
+    
+    for ( Index j = 0; j < Y_scale_.size(); ++j )
+    {
+        // Output (almost) not varying across the samples: keep its scale relative to its mean.
+        Y_scale_(j) = std::max( Y_scale_(j), std::numeric_limits<Real>::epsilon() * std::abs( Y_mean_(j) ) );
+        
+        if ( Y_scale_(j) == 0.0 )
+        {
+            Y_scale_(j) = 1.0;
+        }
+    }
+    
+    Xn_ = ( X.rowwise() - X_mean_.transpose() ).array().rowwise() / X_scale_.transpose().array();
+    
+    MatrixXr Yn = ( Y.rowwise() - Y_mean_ ).array().rowwise() / Y_scale_.array();
+    
+    // Squared distances between samples.
+    MatrixXr D2 = MatrixXr::Zero( nSamples, nSamples );
+    
+    for ( Index i = 0; i < nSamples; ++i )
+    {
+        for ( Index j = 0; j < nSamples; ++j )
+        {
+            D2(i, j) = ( Xn_.row(i) - Xn_.row(j) ).squaredNorm();
+        }
+    }
+    
+    // Choose the length scale maximizing the log-marginal likelihood, summed over the outputs.
+    const Real lengthScales[] = { 0.1, 0.2, 0.5, 1.0, 2.0, 5.0, 10.0 };
+    
+    Real bestLikelihood = - std::numeric_limits<Real>::infinity();
+    
+    for ( const Real & l : lengthScales )
+    {
+        MatrixXr K = ( - 0.5 / (l * l) * D2 ).array().exp();
+        K.diagonal().array() += noise_;
+        
+        LLT<MatrixXr> llt(K);
+        
+        if ( llt.info() != Success )
+        {
+            continue;
+        }
+        
+        MatrixXr alpha = llt.solve(Yn);
+        
+        Real logDet = 2.0 * llt.matrixL().toDenseMatrix().diagonal().array().log().sum();
+        
+        Real likelihood = - 0.5 * Yn.cwiseProduct(alpha).sum() - 0.5 * Yn.cols() * logDet;
+        
+        if ( likelihood > bestLikelihood )
+        {
+            bestLikelihood = likelihood;
+            lengthScale_   = l;
+            llt_           = llt;
+            alpha_         = alpha;
+        }
+    }
+    
+    if ( bestLikelihood == - std::numeric_limits<Real>::infinity() )
+    {
+        throw std::runtime_error("ERROR: the kernel matrix of the surrogate model is not positive definite.");
+    }
+    
+    trained_ = true;
+    
+    return;
+}
+
+VectorXr CvSurrogate::kernel(const ParamList & params) const
+{
+    VectorXr xn = ( features(params) - X_mean_ ).cwiseQuotient(X_scale_);
+    
+    VectorXr k = VectorXr::Zero( Xn_.rows() );
+    
+    for ( Index i = 0; i < k.size(); ++i )
+    {
+        k(i) = std::exp( - 0.5 / (lengthScale_ * lengthScale_) * ( Xn_.row(i).transpose() - xn ).squaredNorm() );
+    }
+    
+    return k;
+}
+
+VectorXr CvSurrogate::predict(const ParamList & params) const
+{
+    if ( !trained_ )
+    {
+        throw std::logic_error("ERROR: the surrogate model has not been trained.");
+    }
+    
+    RowVectorXr Yn = kernel(params).transpose() * alpha_;
+    
+    return ( Yn.cwiseProduct(Y_scale_) + Y_mean_ ).transpose();
+}
+
+VectorXr CvSurrogate::uncertainty(const ParamList & params) const
+{
+    if ( !trained_ )
+    {
+        throw std::logic_error("ERROR: the surrogate model has not been trained.");
+    }
+    
+    VectorXr k = kernel(params);
+    
+    Real variance = std::max(1.0 + noise_ - k.dot( llt_.solve(k) ), 0.0);
+    
+    return std::sqrt(variance) * Y_scale_.transpose();
+}
+
+std::vector<Index> CvSurrogate::screen(const std::vector<ParamList> & candidates,
+                                       const VectorXr & V_experim, const VectorXr & C_experim,
+                                       const Index & errorNorm, const Index & nKeep,
+                                       const Real & kappa) const
+{
+    assert( errorNorm >= 0 && errorNorm <= 2 );
+    assert( kappa >= 0.0 );
+    
+    // Lower confidence bound of the distance of each candidate from the experimental data.
+    VectorXr bound = VectorXr::Zero( candidates.size() );
+    
+    for ( std::size_t i = 0; i < candidates.size(); ++i )
+    {
+        VectorXr C     = predict    (candidates[i]);
+        VectorXr C_std = uncertainty(candidates[i]);
+        
+        Real V_shift = 0.0;
+        
+        Real error = numerics::cv_errors(V_experim, C_experim, V_, C, V_shift)(errorNorm);
+        
+        // Sensitivity of the distance to a one-standard-deviation change of the response.
+        Real spread = 0.0;
+        
+        for ( const Real & sign : { -1.0, 1.0 } )
+        {
+            Real error_std = numerics::cv_errors(V_experim, C_experim, V_, C + sign * kappa * C_std, V_shift)(errorNorm);
+            
+            spread = std::max( spread, std::abs(error_std - error) );
+        }
+        
+        bound(i) = error - spread;
+    }
+    
+    VectorXpair<Real> sort = numerics::sort_pair(bound);
+    
+    std::vector<Index> indexes;
+    
+    for ( Index i = 0; i < std::min(nKeep, sort.size()); ++i )
+    {
+        indexes.push_back( sort(i).second );
+    }
+    
+    return indexes;
+}
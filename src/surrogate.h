@@ -0,0 +1,161 @@
+/* C++11 */
+
+/**
+ * @file   surrogate.h
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ * @brief Surrogate models of the capacitance-voltage response.
+ *
+ */
+
+#ifndef SURROGATE_H
+#define SURROGATE_H
+
+#include "numerics.h"
+#include "paramList.h"
+#include "typedefs.h"
+
+#include <vector>
+
+/**
+ * @class CvSurrogate
+ *
+ * A Gaussian process with a squared exponential kernel is trained over the features
+ * @f$ \left(\sigma / (K_B T_{ref}), \log_{10} N_0, \Phi_B\right) @f$ of completed simulations.
+ * Each simulated capacitance value (one per bias point of a common voltage grid) is an output
+ * of the process: all the outputs share the same kernel, hence a single Cholesky factorization.
+ * The kernel length scale is chosen by maximizing the marginal likelihood.
+ *
+ * @brief Class providing a cheap approximation of the capacitance-voltage response,
+ * used to pre-screen candidate parameter sets before running full simulations.
+ *
+ */
+class CvSurrogate
+{
+    public:
+        /**
+         * @brief Default constructor (deleted since it is required to specify the voltage grid).
+         */
+        CvSurrogate() = delete;
+        /**
+         * @brief Constructor.
+         * @param[in] V     : the voltage grid the capacitance values are predicted at @f$ \left[ V \right] @f$;
+         * @param[in] noise : the regularization added to the diagonal of the (normalized) kernel matrix.
+         */
+        CvSurrogate(const VectorXr &, const Real & = 1.0e-8);
+        /**
+         * @brief Destructor (defaulted).
+         */
+        virtual ~CvSurrogate() = default;
+        
+        /**
+         * @brief Extract the features the surrogate model depends on.
+         * @param[in] params : a list of simulation parameters.
+         * @returns the vector @f$ \left(\sigma / (K_B T_{ref}), \log_{10} N_0, \Phi_B\right) @f$.
+         */
+        static VectorXr features(const ParamList &);
+        
+        /**
+         * @brief Add the result of a completed simulation to the training set.
+         * @param[in] params : the simulation parameters;
+         * @param[in] V      : the simulated voltage values @f$ \left[ V \right] @f$;
+         * @param[in] C      : the simulated capacitance values @f$ \left[ F \right] @f$.
+         */
+        void addSample(const ParamList &, const VectorXr &, const VectorXr &);
+        
+        /**
+         * @brief Train the model on the samples added so far.
+         */
+        void train();
+        
+        /**
+         * @brief Predict the capacitance-voltage response.
+         * @param[in] params : the simulation parameters.
+         * @returns the predicted capacitance values on the voltage grid @f$ \left[ F \right] @f$.
+         */
+        VectorXr predict(const ParamList &) const;
+        /**
+         * @brief Compute the standard deviation of the prediction.
+         * @param[in] params : the simulation parameters.
+         * @returns the standard deviation of the capacitance values on the voltage grid @f$ \left[ F \right] @f$.
+         */
+        VectorXr uncertainty(const ParamList &) const;
+        
+        /**
+         * @brief Rank candidate parameter sets by an optimistic estimate (lower confidence bound)
+         * of their distance from the experimental data, computed on the predicted responses.
+         * @param[in] candidates : the candidate parameter sets;
+         * @param[in] V_experim  : the experimental voltage values (sorted);
+         * @param[in] C_experim  : the experimental capacitance values;
+         * @param[in] errorNorm  : the distance to use (0 = @f$ L^2 @f$, 1 = @f$ H^1 @f$, 2 = peak, see @ref numerics::cv_errors);
+         * @param[in] nKeep      : the number of candidates to keep;
+         * @param[in] kappa      : the number of standard deviations used for the lower confidence bound.
+         * @returns the indexes of the @a nKeep most promising candidates, best first.
+         */
+        std::vector<Index> screen(const std::vector<ParamList> &, const VectorXr &, const VectorXr &,
+                                  const Index &, const Index &, const Real & = 1.0) const;
+                                  
+        /**
+         * @name Getter methods
+         * @{
+         */
+        inline Index nSamples() const;
+        inline const Real & lengthScale() const;
+        inline const bool & trained() const;
+        
+        /**
+         * @}
+         */
+        
+    private:
+        /**
+         * @brief Compute the kernel between the normalized features of a point and each training sample.
+         * @param[in] params : the simulation parameters.
+         * @returns the vector of the kernel values.
+         */
+        VectorXr kernel(const ParamList &) const;
+        
+        VectorXr V_    ;    /**< @brief The voltage grid @f$ \left[ V \right] @f$. */
+        Real     noise_;    /**< @brief Diagonal regularization of the kernel matrix. */
+        
+        std::vector<VectorXr> X_;    /**< @brief Features of the training samples. */
+        std::vector<VectorXr> Y_;    /**< @brief Capacitance values of the training samples @f$ \left[ F \right] @f$. */
+        
+        VectorXr    X_mean_ ;    /**< @brief Mean of the features, used for normalization. */
+        VectorXr    X_scale_;    /**< @brief Standard deviation of the features, used for normalization. */
+        RowVectorXr Y_mean_ ;    /**< @brief Mean of the outputs, used for normalization. */
+        RowVectorXr Y_scale_;    /**< @brief Standard deviation of the outputs, used for normalization. */
+        
+        MatrixXr Xn_;    /**< @brief Normalized features of the training samples (one per row). */
+        
+        Real lengthScale_;    /**< @brief Kernel length scale (in normalized units). */
+        
+        LLT<MatrixXr> llt_  ;    /**< @brief Cholesky factorization of the kernel matrix. */
+        MatrixXr      alpha_;    /**< @brief Weights of the posterior mean (one column per output). */
+        
+        bool trained_;    /**< @brief bool to determine if the model has been trained on the current samples. */
+};
+
+// Implementations.
+inline Index CvSurrogate::nSamples() const
+{
+    return X_.size();
+}
+
+inline const Real & CvSurrogate::lengthScale() const
+{
+    return lengthScale_;
+}
+
+inline const bool & CvSurrogate::trained() const
+{
+    return trained_;
+}
+
+#endif /* SURROGATE_H */
@@ -22,10 +22,12 @@
 
 #include "GetPot.h"
 
+#include <complex>
 #include <iostream>
 #include <fstream>
 
 typedef double Real;    /**< @brief Typedef for real numbers. */
+typedef std::complex<Real> Complex;    /**< @brief Typedef for complex numbers. */
 typedef ptrdiff_t Index;    /**< @brief Typedef for indexing variables. */
 
 #include "physicalConstants.h"
@@ -56,6 +58,7 @@ using VectorXpair = VectorX<std::pair<T, Index> >;
 using MatrixXr    = MatrixX<Real>            ;    /**< @brief Typedef for dense real-valued dynamic-sized matrices. */
 using VectorXr    = VectorX<Real>            ;    /**< @brief Typedef for dense real-valued dynamic-sized column vectors. */
 using RowVectorXr = Matrix<Real, 1, Dynamic> ;    /**< @brief Typedef for dense real-valued dynamic-sized row vectors. */
+using ArrayXr     = Array<Real, Dynamic, 1>  ;    /**< @brief Typedef for dense real-valued dynamic-sized arrays (coefficient-wise operations). */
 
 using SparseXr = SparseMatrix<Real>;    /**< @brief Typedef for sparse real-valued dynamic-sized matrices. */
 
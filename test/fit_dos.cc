@@ -15,9 +15,14 @@
  */
 
 #include "src/dosModel.h"
+#include "src/multilevel.h"
+#include "src/surrogate.h"
 
 #include <omp.h>
 
+#include <algorithm>
+#include <memory>
+
 using namespace constants;
 
 /**
@@ -37,9 +42,16 @@ int main(const int argc, const char * const * argv, const char * const * envp)
         // Input filenames.
         const std::string input_params  = utility::full_path(config("input_params", "input_params.csv" ),
                                           config_directory);
-        const std::string input_experim = utility::full_path(config("input_experim", "input_experim.csv" ),
-                                          config_directory);
                                           
+        // More files containing experimental data (e.g. at different frequencies) are fitted jointly.
+        std::vector<std::string> input_experim;
+        
+        for ( Index k = 0; k < std::max(config.vector_variable_size("input_experim"), 1U); ++k )
+        {
+            input_experim.push_back( utility::full_path(config("input_experim", "input_experim.csv", k),
+                                     config_directory) );
+        }
+        
         CsvParser parser(input_params, config("skipHeaders", true));
         
         // Get number of simulations to be performed.
@@ -80,6 +92,68 @@ int main(const int argc, const char * const * argv, const char * const * envp)
         
         const unsigned & errorNorm = config("FIT/errorNorm", 2);
         
+        const bool earlyTermination = config("FIT/earlyTermination", false);
+        
+        // Continuation across iterations: candidates start from the potential of the previous best one.
+        const bool warmStart = config("FIT/warmStart", false) && !config("Mesh/AMR/enabled", false);
+        
+        // Potential the candidates start from at the finest level, if no previous one is available.
+        MatrixXr PhiFile;
+        
+        {
+            const std::string warmStartFile = config("warmStartFile", "");
+            
+            if ( !warmStartFile.empty() )
+            {
+                utility::read_binary(warmStartFile, PhiFile);
+            }
+        }
+        
+        // Number of candidates simulated in lockstep by each thread.
+        const Index batchSize = config("FIT/batchSize", 1);
+        
+        if ( batchSize < 1 )
+        {
+            throw std::runtime_error("ERROR: wrong variable \"batchSize\" set in the configuration file (only values >= 1 allowed).");
+        }
+        
+        // Surrogate model of the C-V response: at the finest level, candidatesNo values of sigma are proposed
+        // over the current range and only the simulatedNo most promising ones are simulated, besides the previous best.
+        const bool  surrogate    = config("FIT/Surrogate/enabled", false);
+        const Index candidatesNo = config("FIT/Surrogate/candidatesNo", 24);
+        const Index simulatedNo  = config("FIT/Surrogate/simulatedNo", 2);
+        const Index minSamplesNo = config("FIT/Surrogate/minSamplesNo", 6);
+        const Real  kappa        = config("FIT/Surrogate/kappa", 1.0);
+        
+        if ( surrogate && (candidatesNo < 2 || simulatedNo < 1 || minSamplesNo < 2 || kappa < 0.0) )
+        {
+            throw std::runtime_error("ERROR: wrong variables in section \"FIT/Surrogate\" set in the configuration file.");
+        }
+        
+        // Experimental data the candidates are screened against (the reference set).
+        VectorXr V_experim, C_experim;
+        
+        if ( surrogate )
+        {
+            DosModel::import_experim(config, input_experim[0], V_experim, C_experim);
+        }
+        
+        // Get the desired distance of a simulation from the experimental data.
+        auto distance = [errorNorm] (const DosModel & model) -> Real
+        {
+            switch ( errorNorm )
+            {
+                case 0:
+                    return model.error_L2();
+                    
+                case 1:
+                    return model.error_H1();
+                    
+                default:
+                    return model.error_Peak();
+            }
+        };
+        
         // Initialize vectors.
         VectorXr sigma = VectorXr::Zero( 2 * nSplits );
         VectorXr error = VectorXr::Zero( sigma.size() );
@@ -88,6 +162,9 @@ int main(const int argc, const char * const * argv, const char * const * envp)
         VectorXr C_acc_simulated = VectorXr::Zero( sigma.size() );
         VectorXr C_dep_experim   = VectorXr::Zero( sigma.size() );
         
+        // Potentials computed for each candidate (only stored if warm start is enabled).
+        std::vector<MatrixXr> Phi( sigma.size() );
+        
         Real sigmaMin = 0.1 * KB_T;    // Lowest sigma allowed (>=0).
         
         // Create output directories, if they don't exist.
@@ -117,6 +194,8 @@ int main(const int argc, const char * const * argv, const char * const * envp)
             
             // Initial guess for sigma (read from the parameter list).
             {
+                sigma.resize( 2 * nSplits );
+                
                 if ( params.sigma() != sigmaMin )
                 {
                     VectorXr temp1 = VectorXr::LinSpaced(nSplits, std::max(params.sigma() - negative_shift, sigmaMin), params.sigma());
@@ -151,18 +230,45 @@ int main(const int argc, const char * const * argv, const char * const * envp)
             Index minimum = 0;    // The index of the minimum sigma.
             Real sigmaOld = params.sigma();    // Previous minimum value.
             
+            // Fidelity levels: iterations at coarse levels don't count in "iterationsNo".
+            FidelityController fidelity(config);
+            
+            Index iteration = 0;    // Index of the iteration over all the levels.
+            
+            // Surrogate model, trained on the candidates simulated at the finest level (built at the first one).
+            std::unique_ptr<CvSurrogate> cvSurrogate;
+            Index sweepsSaved = 0;
+            
+            // Potential of the best candidate of the previous iteration at the current level (empty at first).
+            MatrixXr PhiBest;
+            Index levelIteration = 0;    // Index of the iteration at the current level.
+            
             // Fitting loop.
             
-            for ( Index j = 0; j < iterationsNo; ++j )
+            for ( Index j = 0; j < iterationsNo; ++iteration, ++levelIteration )
             {
-                output_fit << "Iteration " << (j + 1) << "/" << iterationsNo << "..." << std::endl;
+                output_fit << "Iteration " << (j + 1) << "/" << iterationsNo;
+                
+                if ( !fidelity.finest() )
+                {
+                    output_fit << " (level " << fidelity.level() << ", iteration " << (levelIteration + 1) << ")";
+                }
+                
+                output_fit << "..." << std::endl;
+                
+                if ( PhiBest.size() == 0 && fidelity.finest() )
+                {
+                    PhiBest = PhiFile;
+                }
                 
                 // Update sigma based on the previous step.
                 
-                if ( j >= 1 )
+                if ( iteration >= 1 )
                 {
                     sigmaOld = sigma(minimum);
                     
+                    sigma.resize( 2 * nSplits );
+                    
                     if ( sigmaOld != sigmaMin )
                     {
                         // Sigma can't be < 0. If so, set it equal to sigmaMin.
@@ -177,14 +283,77 @@ int main(const int argc, const char * const * argv, const char * const * envp)
                     }
                 }
                 
+                // Screen the candidates by the surrogate model, once trained on enough samples.
+                Index screened = 0;    // Number of candidates the range would be split into without screening.
+                
+                if ( surrogate && fidelity.finest() && cvSurrogate != nullptr && cvSurrogate->nSamples() >= minSamplesNo )
+                {
+                    cvSurrogate->train();
+                    
+                    const VectorXr proposed = VectorXr::LinSpaced(candidatesNo, sigma(0), sigma(sigma.size() - 1));
+                    
+                    std::vector<ParamList> candidates(candidatesNo, params);
+                    
+                    for ( Index k = 0; k < candidatesNo; ++k )
+                    {
+                        candidates[k].setSigma( proposed(k) );
+                    }
+                    
+                    // The stray capacitance is updated at each iteration: the samples are stored without it.
+                    const VectorXr C_target = C_experim.array() - params.C_sb();
+                    
+                    std::vector<Index> kept = cvSurrogate->screen(candidates, V_experim, C_target, errorNorm, simulatedNo, kappa);
+                    
+                    // The previous best sigma is always simulated, so that the error can't increase.
+                    std::vector<Real> selected(1, sigmaOld);
+                    
+                    for ( const Index & k : kept )
+                    {
+                        selected.push_back( proposed(k) );
+                    }
+                    
+                    std::sort(selected.begin(), selected.end());
+                    selected.erase(std::unique(selected.begin(), selected.end()), selected.end());
+                    
+                    screened = sigma.size();
+                    
+                    sigma.resize( selected.size() );
+                    
+                    for ( Index k = 0; k < sigma.size(); ++k )
+                    {
+                        sigma(k) = selected[k];
+                    }
+                }
+                
+                error          .resize( sigma.size() );
+                C_acc_experim  .resize( sigma.size() );
+                C_acc_simulated.resize( sigma.size() );
+                C_dep_experim  .resize( sigma.size() );
+                Phi            .resize( sigma.size() );
+                
+                // Index of the candidate at the previous best sigma.
+                Index center = 0;
+                (sigma.array() - sigmaOld).abs().minCoeff(&center);
+                
+                // Best error found so far in this iteration, used to abort the simulation of worse candidates.
+                Real errorBest = std::numeric_limits<Real>::infinity();
+                
+                // At a coarse level, the previous best sigma is also simulated at the next finer level,
+                // concurrently with the candidates, to estimate the error of the level.
+                const bool finer = !fidelity.finest();
+                Real errorFiner = std::numeric_limits<Real>::infinity();
+                
                 // Step 1: find the best sigma.
+                const Index batchesNo = (sigma.size() + batchSize - 1) / batchSize;
+                const Index tasksNo   = batchesNo + (finer ? 1 : 0);
+                
                 #pragma omp parallel for shared(ompException, ompThrewException) private(config) schedule(dynamic, 1)
                 
-                for ( Index k = 0; k < sigma.size(); ++k )
+                for ( Index task = 0; task < tasksNo; ++task )
                 {
                     try    // Exception handling inside parallel region.
                     {
-                        if ( omp_get_thread_num() == 0 && j == 0 )
+                        if ( omp_get_thread_num() == 0 && iteration == 0 )
                         {
                             if ( i == 0 )
                             {
@@ -194,8 +363,40 @@ int main(const int argc, const char * const * argv, const char * const * envp)
                             std::cout << "Performing simulation No. " << params.simulationNo() << " (fitting)..." << std::endl;
                         }
                         
-                        // Initialize model.
-                        DosModel model;
+                        // The finer simulation, the longest task, is started first.
+                        if ( finer && task == 0 )
+                        {
+                            DosModel model;
+                            
+                            #pragma omp critical
+                            {
+                                // Re-initialize configuration file for each thread.
+                                config = (GetPot) utility::full_path(commandLine.follow("config.pot", 2, "-f", "--file"),
+                                                                     config_directory).c_str();
+                                                                     
+                                ParamList levelParams = params;
+                                fidelity.coarsen(levelParams, config, fidelity.level() - 1);
+                                
+                                model = (DosModel) levelParams;
+                                model.setSigma( sigma(center) );
+                            }
+                            
+                            model.simulate(config, input_experim, output_directory, output_plot_subdir,
+                                           output_filename + "_" + std::to_string(iteration + 1) + "_finer");
+                                           
+                            errorFiner = distance(model);
+                            
+                            continue;
+                        }
+                        
+                        const Index batch = finer ? task - 1 : task;
+                        
+                        const Index first = batch * batchSize;
+                        const Index last  = std::min( first + batchSize, (Index) sigma.size() );
+                        
+                        // Initialize models.
+                        std::vector<DosModel> models(last - first);
+                        std::vector<std::string> output_filenames;
                         
                         #pragma omp critical
                         {
@@ -203,33 +404,70 @@ int main(const int argc, const char * const * argv, const char * const * envp)
                             config = (GetPot) utility::full_path(commandLine.follow("config.pot", 2, "-f", "--file"),
                                                                  config_directory).c_str();
                                                                  
-                            model = (DosModel) params;
-                            model.setSigma( sigma(k) );
+                            ParamList levelParams = params;
+                            fidelity.coarsen(levelParams, config);
+                            
+                            for ( Index k = first; k < last; ++k )
+                            {
+                                models[k - first] = (DosModel) levelParams;
+                                models[k - first].setSigma( sigma(k) );
+                                
+                                if ( PhiBest.size() > 0 )
+                                {
+                                    models[k - first].setInitialGuess( PhiBest );
+                                }
+                                else if ( earlyTermination )
+                                {
+                                    models[k - first].setErrorThreshold( &errorBest, errorNorm );
+                                }
+                                
+                                output_filenames.push_back( output_filename + "_" + std::to_string(iteration + 1) + "_" + std::to_string(k + 1) );
+                            }
                         }
                         
                         // Simulate and save output files.
-                        model.simulate(config, input_experim, output_directory, output_plot_subdir,
-                                       output_filename + "_" + std::to_string(j + 1) + "_" + std::to_string(k + 1));
-                                       
-                        // Get the desired error.
-                        switch ( errorNorm )
+                        DosModel::simulate(models, config, input_experim, output_directory, output_plot_subdir, output_filenames);
+                        
+                        for ( Index k = first; k < last; ++k )
                         {
-                            case 0:
-                                error(k) = model.error_L2();
-                                break;
-                                
-                            case 1:
-                                error(k) = model.error_H1();
-                                break;
-                                
-                            case 2:
-                                error(k) = model.error_Peak();
-                                break;
+                            const DosModel & model = models[k - first];
+                            
+                            // Get the desired error.
+                            error(k) = distance(model);
+                            
+                            // Same critical section the simulations read the threshold in.
+                            #pragma omp critical (ErrorThreshold)
+                            {
+                                if ( error(k) < errorBest )
+                                {
+                                    errorBest = error(k);
+                                }
+                            }
+                            
+                            C_acc_experim(k)   = model.C_acc_experim();
+                            C_acc_simulated(k) = model.C_acc_simulated();
+                            C_dep_experim(k)   = model.C_dep_experim();
+                            
+                            if ( warmStart )
+                            {
+                                Phi[k] = model.Phi();
+                            }
+                            
+                            // Train the surrogate model on the complete sweeps at the finest level.
+                            if ( surrogate && fidelity.finest() && !model.aborted() )
+                            {
+                                #pragma omp critical (Surrogate)
+                                {
+                                    if ( cvSurrogate == nullptr )
+                                    {
+                                        cvSurrogate.reset( new CvSurrogate( model.V_simulated() ) );
+                                    }
+                                    
+                                    cvSurrogate->addSample( model.params(), model.V_simulated(),
+                                                            model.C_simulated().array() - model.params().C_sb() );
+                                }
+                            }
                         }
-                        
-                        C_acc_experim(k)   = model.C_acc_experim();
-                        C_acc_simulated(k) = model.C_acc_simulated();
-                        C_dep_experim(k)   = model.C_dep_experim();
                     }
                     catch ( const std::exception & genericException )
                     {
@@ -249,6 +487,11 @@ int main(const int argc, const char * const * argv, const char * const * envp)
                 // Find the best fitting, i.e. the one with the minimum error.
                 error.minCoeff(&minimum);
                 
+                if ( warmStart )
+                {
+                    PhiBest = Phi[minimum];
+                }
+                
                 // Step 2: update C_sb.
                 params.setC_sb( params.C_sb() + C_acc_experim(minimum) - C_acc_simulated(minimum) );
                 
@@ -259,7 +502,7 @@ int main(const int argc, const char * const * argv, const char * const * envp)
                 // Print to output.
                 output_fit << "\tBest sigma: " << std::setprecision(4) << sigma(minimum) / KB_T;
                 output_fit << " (from simulation " << params.simulationNo();
-                output_fit << "_" << (j + 1) << "_" << (minimum + 1) << ")" << std::endl;
+                output_fit << "_" << (iteration + 1) << "_" << (minimum + 1) << ")" << std::endl;
                 
                 output_fit.precision(std::numeric_limits<Real>::digits10);
                 
@@ -283,7 +526,49 @@ int main(const int argc, const char * const * argv, const char * const * envp)
                 output_fit << "\tC_sb: " << params.C_sb() << std::endl;
                 output_fit << "\tt_semic: " << params.t_semic() << std::endl;
                 
-                if ( j < iterationsNo - 1 )
+                if ( screened > 0 )
+                {
+                    output_fit << "\tSurrogate: " << sigma.size() << " of " << candidatesNo << " candidates simulated ("
+                               << (screened - sigma.size()) << " sweeps saved)." << std::endl;
+                               
+                    sweepsSaved += screened - sigma.size();
+                }
+                
+                // Step 4: at a coarse level, estimate its error by the simulation of the previous best sigma at the next finer level.
+                if ( finer )
+                {
+                    output_fit << "\tLevel error estimate: " << std::abs(errorFiner - error(center)) << std::endl;
+                    
+                    // Promote if the level can't tell the best candidates apart, if it stagnates
+                    // or if the maximum number of iterations at this level has been reached.
+                    if ( fidelity.promote(error, center, errorFiner, sigma(minimum) == sigmaOld || levelIteration + 1 >= iterationsNo) )
+                    {
+                        output_fit << "\tPromoted to level " << fidelity.level() << "." << std::endl;
+                        
+                        levelIteration = -1;
+                        
+                        // Mesh and bias steps change with the level.
+                        PhiBest.resize(0, 0);
+                    }
+                    
+                    output_fit << std::endl;
+                    
+                    // Update fitting parameters.
+                    if ( sigma(minimum) < sigmaOld )
+                    {
+                        positive_shift = sigmaOld - sigma(minimum);
+                    }
+                    else if ( sigma(minimum) > sigmaOld )
+                    {
+                        negative_shift = sigma(minimum) - sigmaOld;
+                    }
+                    
+                    continue;
+                }
+                
+                ++j;
+                
+                if ( j < iterationsNo )
                 {
                     output_fit << std::endl;
                 }
@@ -305,6 +590,11 @@ int main(const int argc, const char * const * argv, const char * const * envp)
                 }
             }
             
+            if ( surrogate )
+            {
+                output_fit << std::endl << "Surrogate: " << sweepsSaved << " sweeps saved." << std::endl;
+            }
+            
             output_fit.close();
             
             std::cout << "\t\t\t\tSimulation No. " << params.simulationNo() << " complete!" << std::endl;
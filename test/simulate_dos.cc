@@ -35,9 +35,16 @@ int main(const int argc, const char * const * argv, const char * const * envp)
         // Input filenames.
         const std::string input_params  = utility::full_path(config("input_params", "input_params.csv" ),
                                           config_directory);
-        const std::string input_experim = utility::full_path(config("input_experim", "input_experim.csv" ),
-                                          config_directory);
                                           
+        // More files containing experimental data (e.g. at different frequencies) are fitted jointly.
+        std::vector<std::string> input_experim;
+        
+        for ( Index k = 0; k < std::max(config.vector_variable_size("input_experim"), 1U); ++k )
+        {
+            input_experim.push_back( utility::full_path(config("input_experim", "input_experim.csv", k),
+                                     config_directory) );
+        }
+        
         CsvParser parser(input_params, config("skipHeaders", true));
         
         // Get number of simulations to be performed.
@@ -70,6 +77,9 @@ int main(const int argc, const char * const * argv, const char * const * envp)
         const std::string output_directory   = config("output_directory", "./output" ) + "/";
         const std::string output_plot_subdir = (std::string) "gnuplot" + "/";
         
+        // Potential the simulations start from, if any.
+        const std::string warmStartFile = config("warmStartFile", "");
+        
         // Create output directories, if they don't exist.
         if ( system( ("exec mkdir " + output_directory + " " + output_directory
                       + output_plot_subdir + " 2> /dev/null").c_str() ) );
@@ -119,6 +129,11 @@ int main(const int argc, const char * const * argv, const char * const * envp)
                 {
                         model = (DosModel) params;
                         
+                        if ( !warmStartFile.empty() )
+                        {
+                            model.loadInitialGuess(warmStartFile);
+                        }
+                        
                         #pragma omp critical
                         {
                             for ( Index k = 0; k < j; ++k )
@@ -0,0 +1,257 @@
+/* C++11 */
+
+/**
+ * @file   test_bim.cc
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ * @brief Test of Bim1D::log_mean and Bim1D::bernoulli against long double references,
+ * on both sides of the switch between their series and closed-form branches; timing of both.
+ *
+ */
+
+#include "src/solvers.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+using namespace std::chrono;
+
+namespace
+{
+    // Maximum relative error allowed (a few units in the last place).
+    const Real TOLERANCE = 4.0e-15;
+    
+    // Argument at which both functions switch from the series to the closed form.
+    const Real LIM = 0.1;
+    
+    // Number of elements and of repetitions for timing.
+    const Index BENCH_SIZE    = 4096;
+    const Index BENCH_REPEATS = 2000;
+    
+    long double log_mean_reference(const long double & x1, const long double & x2)
+    {
+        if ( x1 == 0.0L || x2 == 0.0L )
+        {
+            return 0.0L;
+        }
+        else if ( x1 == x2 )
+        {
+            return x1;
+        }
+        
+        const long double logRatio = ( std::abs(x2 - x1) < 0.5L * x1 ) ? std::log1p( (x2 - x1) / x1 )
+                                     : std::log(x2) - std::log(x1);
+        
+        return (x2 - x1) / logRatio;
+    }
+    
+    long double bernoulli_reference(const long double & x)
+    {
+        return (x == 0.0L) ? 1.0L : x / std::expm1(x);
+    }
+    
+    // Relative error, results below the smallest normal number being compared in absolute terms.
+    Real relative_error(const Real & value, const long double & reference)
+    {
+        return (Real) ( std::abs(value - reference) /
+                        std::max( std::abs(reference), (long double) std::numeric_limits<Real>::min() ) );
+    }
+    
+    // Arguments clustered around a switch point, a few ulps apart and then logarithmically spaced.
+    void cluster(std::vector<Real> & args, const Real & center)
+    {
+        Real below = center, above = center;
+        
+        for ( Index k = 0; k < 8; ++k )
+        {
+            below = std::nextafter(below, 0.0);
+            above = std::nextafter(above, 2.0 * center);
+            
+            args.push_back(below);
+            args.push_back(above);
+        }
+        
+        for ( Real d = 1.0e-15; d < 0.5; d *= 2.0 )
+        {
+            args.push_back( center * (1.0 - d) );
+            args.push_back( center * (1.0 + d) );
+        }
+        
+        args.push_back(center);
+    }
+}
+
+/**
+ *  @brief The @b main function.
+ */
+int main()
+{
+    bool passed = true;
+    
+    // Bernoulli function: around zero, around the switch and up to where exp(x) stays finite.
+    {
+        std::vector<Real> args = { 0.0 };
+        
+        cluster(args, LIM);
+        
+        for ( Real x = 1.0e-300; x < 700.0; x *= 1.1 )
+        {
+            args.push_back(x);
+        }
+        
+        const Index n = args.size();
+        
+        VectorXr x( 2 * n );
+        
+        for ( Index i = 0; i < n; ++i )
+        {
+            x(i)     =   args[i];
+            x(n + i) = - args[i];
+        }
+        
+        std::pair<VectorXr, VectorXr> bp_bn = Bim1D::bernoulli(x);
+        
+        Real errorP = 0.0, errorN = 0.0;
+        Real worstP = 0.0, worstN = 0.0;
+        
+        for ( Index i = 0; i < x.size(); ++i )
+        {
+            const Real eP = relative_error( bp_bn.first (i), bernoulli_reference(  (long double) x(i) ) );
+            const Real eN = relative_error( bp_bn.second(i), bernoulli_reference(- (long double) x(i) ) );
+            
+            if ( eP > errorP )
+            {
+                errorP = eP;
+                worstP = x(i);
+            }
+            
+            if ( eN > errorN )
+            {
+                errorN = eN;
+                worstN = x(i);
+            }
+        }
+        
+        std::cout << "bernoulli: " << x.size() << " arguments, max relative error "
+                  << errorP << " (B(x), at x = " << worstP << "), "
+                  << errorN << " (B(-x), at x = " << worstN << ")." << std::endl;
+        
+        passed = passed && errorP <= TOLERANCE && errorN <= TOLERANCE;
+    }
+    
+    // Logarithmic mean: nearly equal arguments, around the switch and one argument tending to zero.
+    {
+        std::vector<Real> ratios = { 1.0 };
+        
+        // u = (x2 - x1) / (x2 + x1) = LIM.
+        cluster(ratios, (1.0 + LIM) / (1.0 - LIM));
+        
+        for ( Real d = 1.0e-16; d < 1.0e3; d *= 1.5 )
+        {
+            ratios.push_back(1.0 + d);
+            ratios.push_back(1.0 / (1.0 + d));
+        }
+        
+        for ( Real r = 1.0e-250; r < 1.0; r *= 1.0e10 )
+        {
+            ratios.push_back(r);
+        }
+        
+        const std::vector<Real> scales = { 1.0e-20, 1.0, 1.0e20 };
+        
+        VectorXr x1( ratios.size() * scales.size() + 2 );
+        VectorXr x2( x1.size() );
+        
+        Index i = 0;
+        
+        for ( const Real & s : scales )
+        {
+            for ( const Real & r : ratios )
+            {
+                x1(i) = s;
+                x2(i) = s * r;
+                
+                ++i;
+            }
+        }
+        
+        // Null arguments.
+        x1(i) = 0.0;
+        x2(i) = 1.0;
+        ++i;
+        
+        x1(i) = 1.0;
+        x2(i) = 0.0;
+        
+        VectorXr log_mean = Bim1D::log_mean(x1, x2);
+        
+        Real error = 0.0, worst1 = 0.0, worst2 = 0.0;
+        
+        for ( Index k = 0; k < x1.size(); ++k )
+        {
+            const Real e = relative_error( log_mean(k), log_mean_reference(x1(k), x2(k)) );
+            
+            if ( e > error )
+            {
+                error  = e;
+                worst1 = x1(k);
+                worst2 = x2(k);
+            }
+        }
+        
+        std::cout << "log_mean:  " << x1.size() << " arguments, max relative error "
+                  << error << " (at x1 = " << worst1 << ", x2 = " << worst2 << ")." << std::endl;
+        
+        passed = passed && error <= TOLERANCE;
+    }
+    
+    // Timing, half of the arguments in the series branch.
+    {
+        VectorXr x  = VectorXr::LinSpaced(BENCH_SIZE, -4.0 * LIM, 4.0 * LIM);
+        VectorXr x1 = VectorXr::LinSpaced(BENCH_SIZE, 1.0, 2.0);
+        VectorXr x2 = x1.array() * (1.0 + x.array().abs());
+        
+        Real checksum = 0.0;
+        
+        high_resolution_clock::time_point t0 = high_resolution_clock::now();
+        
+        for ( Index k = 0; k < BENCH_REPEATS; ++k )
+        {
+            checksum += Bim1D::bernoulli(x).first(k % BENCH_SIZE);
+        }
+        
+        high_resolution_clock::time_point t1 = high_resolution_clock::now();
+        
+        for ( Index k = 0; k < BENCH_REPEATS; ++k )
+        {
+            checksum += Bim1D::log_mean(x1, x2)(k % BENCH_SIZE);
+        }
+        
+        high_resolution_clock::time_point t2 = high_resolution_clock::now();
+        
+        const Real scale = 1.0 / (BENCH_SIZE * BENCH_REPEATS);
+        
+        std::cout << "bernoulli: " << duration_cast<duration<Real, std::nano> >(t1 - t0).count() * scale
+                  << " ns per element." << std::endl;
+        std::cout << "log_mean:  " << duration_cast<duration<Real, std::nano> >(t2 - t1).count() * scale
+                  << " ns per element (checksum " << checksum << ")." << std::endl;
+    }
+    
+    if ( !passed )
+    {
+        std::cerr << "ERROR: relative error above " << TOLERANCE << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,160 @@
+/* C++11 */
+
+/**
+ * @file   test_charge.cc
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ * @brief Test of GaussFermiCharge (Chebyshev panels of unit width and degree 14) against the quadrature
+ * of GaussianCharge, on every parameter set of the config_pbs cases; timing of both.
+ *
+ */
+
+#include "src/csvParser.h"
+#include "src/factory.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+
+using namespace std::chrono;
+
+namespace
+{
+    // Maximum relative errors allowed, of the charge and of its derivative.
+    const Real CHARGE_TOLERANCE  = 1.0e-12;
+    const Real DCHARGE_TOLERANCE = 1.0e-7;
+    
+    // Relative magnitude of the derivative below which its errors are compared to DCHARGE_FLOOR times the largest
+    // value: deep in the saturation both quadratures are accurate to about 1.0e-12 of the peak only.
+    const Real DCHARGE_FLOOR = 1.0e-4;
+    
+    // Directory of the configuration files, relative to the build directory the tests are run from.
+    const std::string CONFIG_DIRECTORY = "config/";
+    
+    // The shipped config_pbs cases.
+    const Index CASES[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 101, 102, 103, 1001 };
+    
+    // Potentials the charge is evaluated at [V].
+    const Index PHI_SIZE = 2001;
+    const Real  PHI_MIN  = -3.0;
+    const Real  PHI_MAX  =  3.0;
+    
+    // Maximum relative error of a vector, the entries below floor times the largest one being compared to the latter.
+    Real relative_error(const VectorXr & value, const VectorXr & reference, const Real & floor)
+    {
+        const Real scale = std::max( floor * reference.cwiseAbs().maxCoeff(), std::numeric_limits<Real>::min() );
+        
+        return ( (value - reference).array().abs() / reference.array().abs().max(scale) ).maxCoeff();
+    }
+}
+
+/**
+ *  @brief The @b main function.
+ */
+int main()
+{
+    bool passed = true;
+    
+    const VectorXr phi = VectorXr::LinSpaced(PHI_SIZE, PHI_MIN, PHI_MAX);
+    
+    Real chargeError = 0.0, dchargeError = 0.0;
+    Real gaussianTime = 0.0, gaussFermiTime = 0.0;
+    Index nSets = 0;
+    
+    try
+    {
+        for ( const Index & pbs : CASES )
+        {
+            const std::string filename = "config_pbs" + std::to_string(pbs) + ".pot";
+            
+            GetPot config = utility::full_path(filename, CONFIG_DIRECTORY).c_str();
+            
+            std::unique_ptr<QuadratureRule> rule;
+            
+            {
+                std::string name;
+                
+                std::unique_ptr<QuadratureRuleFactory> ruleFactory
+                ( QuadratureRuleRegistry::build(config("QuadratureRule/rule", 1), config, name) );
+                
+                rule.reset( ruleFactory->BuildRule(config("QuadratureRule/nNodes", 101)) );
+            }
+            
+            rule->apply(config);
+            
+            const Real tolerance = config("QuadratureRule/asymptoticTolerance", 1.0e-10);
+            
+            CsvParser parser(utility::full_path(config("input_params", "input_params.csv"), CONFIG_DIRECTORY),
+                             config("skipHeaders", true));
+            
+            Real caseChargeError = 0.0, caseDchargeError = 0.0;
+            
+            for ( Index i = 1; i <= parser.nRows(); ++i )
+            {
+                const ParamList params( parser.importRow(i) );
+                
+                const GaussianCharge   gaussian  (params, *rule, tolerance);
+                const GaussFermiCharge gaussFermi(params, *rule, tolerance);
+                
+                VectorXr charge, dcharge, chargeFit, dchargeFit;
+                
+                high_resolution_clock::time_point t0 = high_resolution_clock::now();
+                
+                charge  = gaussian.charge (phi);
+                dcharge = gaussian.dcharge(phi);
+                
+                high_resolution_clock::time_point t1 = high_resolution_clock::now();
+                
+                chargeFit  = gaussFermi.charge (phi);
+                dchargeFit = gaussFermi.dcharge(phi);
+                
+                high_resolution_clock::time_point t2 = high_resolution_clock::now();
+                
+                gaussianTime   += duration_cast<duration<Real> >(t1 - t0).count();
+                gaussFermiTime += duration_cast<duration<Real> >(t2 - t1).count();
+                
+                caseChargeError  = std::max( caseChargeError,  relative_error(chargeFit,  charge,  0.0) );
+                caseDchargeError = std::max( caseDchargeError, relative_error(dchargeFit, dcharge, DCHARGE_FLOOR) );
+                
+                ++nSets;
+            }
+            
+            std::cout << filename << ": " << parser.nRows() << " parameter sets, max relative error "
+                      << caseChargeError << " (charge), " << caseDchargeError << " (dcharge)." << std::endl;
+            
+            chargeError  = std::max( chargeError,  caseChargeError  );
+            dchargeError = std::max( dchargeError, caseDchargeError );
+        }
+    }
+    catch ( const std::exception & genericException )
+    {
+        std::cerr << genericException.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    passed = chargeError <= CHARGE_TOLERANCE && dchargeError <= DCHARGE_TOLERANCE;
+    
+    const Real scale = 1.0e6 / (nSets * PHI_SIZE);
+    
+    std::cout << "GaussianCharge:   " << gaussianTime   * scale << " us per potential (charge and dcharge)." << std::endl;
+    std::cout << "GaussFermiCharge: " << gaussFermiTime * scale << " us per potential (charge and dcharge)." << std::endl;
+    
+    if ( !passed )
+    {
+        std::cerr << "ERROR: relative errors above " << CHARGE_TOLERANCE << " (charge) or "
+                  << DCHARGE_TOLERANCE << " (dcharge)." << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,122 @@
+/* C++11 */
+
+/**
+ * @file   test_quadrature.cc
+ * @author Pasquale Claudio Africa <pasquale.africa@gmail.com>
+ * @date   2014
+ *
+ * This file is part of the "DosExtraction" project.
+ *
+ * @copyright Copyright © 2014 Pasquale Claudio Africa. All rights reserved.
+ * @copyright This project is released under the GNU General Public License.
+ *
+ * @brief Test of the Gauss-Hermite and Gauss-Laguerre rules computed by QuadratureRule::march_roots
+ * against the ones computed by the Sandia library; timing of both.
+ *
+ */
+
+#include "src/quadratureRule.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+
+using namespace std::chrono;
+
+namespace
+{
+    // Maximum errors allowed: of the nodes, relative to max(|x_i|, 1), and of the weights, relative to each
+    // weight (the ones below WEIGHT_FLOOR times the largest one, irrelevant to any integrand, being skipped).
+    const Real NODES_TOLERANCE   = 1.0e-12;
+    const Real WEIGHTS_TOLERANCE = 1.0e-10;
+    const Real WEIGHT_FLOOR      = 1.0e-200;
+    
+    // Minimum time spent timing each algorithm [s].
+    const Real BENCH_TIME = 0.05;
+    
+    // Time an algorithm, repeating it for at least BENCH_TIME seconds.
+    Real time_per_call(const std::function<void()> & algorithm)
+    {
+        Index repeats = 0;
+        
+        high_resolution_clock::time_point start = high_resolution_clock::now();
+        Real elapsed = 0.0;
+        
+        do
+        {
+            algorithm();
+            ++repeats;
+            
+            elapsed = duration_cast<duration<Real> >(high_resolution_clock::now() - start).count();
+        }
+        while ( elapsed < BENCH_TIME );
+        
+        return elapsed / repeats;
+    }
+    
+    // Compare a rule against the reference one, printing the errors and the timings.
+    bool compare(const std::string & name, const Index & nNodes, QuadratureRule & rule,
+                 const std::function<void()> & algorithm, const std::function<void(Real *, Real *)> & reference)
+    {
+        VectorXr x( nNodes ), w( nNodes );
+        
+        algorithm();
+        reference(x.data(), w.data());
+        
+        Real nodesError = 0.0, weightsError = 0.0;
+        
+        for ( Index i = 0; i < nNodes; ++i )
+        {
+            nodesError = std::max( nodesError, std::abs(rule.nodes()(i) - x(i)) / std::max(std::abs(x(i)), 1.0) );
+            
+            if ( w(i) >= WEIGHT_FLOOR * w.maxCoeff() )
+            {
+                weightsError = std::max( weightsError, std::abs(rule.weights()(i) - w(i)) / w(i) );
+            }
+        }
+        
+        const Real time          = time_per_call(algorithm);
+        const Real referenceTime = time_per_call( [&] () { reference(x.data(), w.data()); } );
+        
+        std::cout << name << ", " << nNodes << " nodes: max error " << nodesError << " (nodes), "
+                  << weightsError << " (weights); " << 1.0e6 * time << " us (march_roots), "
+                  << 1.0e6 * referenceTime << " us (Sandia)." << std::endl;
+        
+        return nodesError <= NODES_TOLERANCE && weightsError <= WEIGHTS_TOLERANCE;
+    }
+}
+
+/**
+ *  @brief The @b main function.
+ */
+int main()
+{
+    bool passed = true;
+    
+    for ( const Index nNodes : { 21, 101, 201 } )
+    {
+        GaussHermiteRule hermite(nNodes);
+        
+        passed = compare("Gauss-Hermite ", nNodes, hermite,
+                         [&] () { hermite.apply_glaser_liu_rokhlin(); },
+                         [&] (Real * x, Real * w) { webbur::hermite_compute( (int) nNodes, x, w ); } ) && passed;
+        
+        GaussLaguerreRule laguerre(nNodes);
+        
+        passed = compare("Gauss-Laguerre", nNodes, laguerre,
+                         [&] () { laguerre.apply_glaser_liu_rokhlin(); },
+                         [&] (Real * x, Real * w) { webbur::laguerre_compute( (int) nNodes, x, w ); } ) && passed;
+    }
+    
+    if ( !passed )
+    {
+        std::cerr << "ERROR: errors above " << NODES_TOLERANCE << " (nodes) or "
+                  << WEIGHTS_TOLERANCE << " (weights)." << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    return EXIT_SUCCESS;
+}